@@ -0,0 +1,303 @@
+#include "Game/AI/BotDirector.hpp"
+#include "Game/HostSimulation.hpp"
+#include "Game/TheGame.hpp"
+#include "Game/MatchManager.hpp"
+#include "Game/Entities/Link.hpp"
+#include "Engine/Input/InputMap.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <stdlib.h>
+
+const float BotDirector::ATTACK_RANGE = 1.0f;
+
+//-----------------------------------------------------------------------------------
+BotDirector::BotDirector(const NavigationGrid& navigationGrid)
+    : m_navigationGrid(navigationGrid)
+    , m_numFlowFieldBuilds(0)
+{
+    for (unsigned int i = 0; i < MAX_BOTS; ++i)
+    {
+        m_bots[i].m_isActive = false;
+        m_bots[i].m_isWaitingToRespawn = false;
+        m_bots[i].m_isSpawnQueued = false;
+        m_bots[i].m_isAttackQueued = false;
+        m_bots[i].m_respawnTick = 0;
+        m_bots[i].m_nextAttackTick = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Fills empty slots, lowest first, up to the host's player limit. Returns how many bots actually fit.
+unsigned int BotDirector::AddBots(HostSimulation& host, unsigned int numBots)
+{
+    unsigned int numOccupied = GetNumOccupiedSlots(host);
+    unsigned int numFree = host.m_playerLimit > numOccupied ? host.m_playerLimit - numOccupied : 0;
+    numBots = numBots < numFree ? numBots : numFree;
+    unsigned int numAdded = 0;
+    for (unsigned int i = 0; i < MAX_BOTS && numAdded < numBots; ++i)
+    {
+        uint8_t index = (uint8_t)i;
+        if (m_bots[i].m_isActive || host.m_players[index] || IsSlotConnected(host, index))
+        {
+            continue;
+        }
+        Bot& bot = m_bots[i];
+        bot.m_isActive = true;
+        bot.m_isWaitingToRespawn = false;
+        bot.m_isSpawnQueued = false;
+        bot.m_isAttackQueued = false;
+        bot.m_nextAttackTick = host.m_clock.GetCurrentTick();
+        host.m_playerColors[index] = RGBA::GetRandom().ToUnsignedInt();
+        host.BroadcastLinkCreation(index, host.m_playerColors[index]);
+        ++numAdded;
+    }
+    return numAdded;
+}
+
+//-----------------------------------------------------------------------------------
+//The Link is dropped from the slot right away so a player taking the slot over can spawn this tick. Cleanup still
+//despawns it for everyone at the end of the tick.
+void BotDirector::RemoveBot(HostSimulation& host, uint8_t index)
+{
+    if (!m_bots[index].m_isActive)
+    {
+        return;
+    }
+    m_bots[index].m_isActive = false;
+    m_bots[index].m_isSpawnQueued = false;
+    m_bots[index].m_isAttackQueued = false;
+    Steer(host, index, Vector2::ZERO);
+    Link* player = host.m_players[index];
+    if (player)
+    {
+        player->m_isDead = true;
+        host.m_players[index] = nullptr;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void BotDirector::RemoveAllBots(HostSimulation& host)
+{
+    for (unsigned int i = 0; i < MAX_BOTS; ++i)
+    {
+        RemoveBot(host, (uint8_t)i);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Players joining a match that bots had filled take over from the highest numbered bots.
+void BotDirector::RemoveBotsOverLimit(HostSimulation& host)
+{
+    unsigned int numOccupied = GetNumOccupiedSlots(host);
+    for (unsigned int i = MAX_BOTS; i-- > 0 && numOccupied > host.m_playerLimit;)
+    {
+        if (m_bots[i].m_isActive)
+        {
+            RemoveBot(host, (uint8_t)i);
+            --numOccupied;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void BotDirector::Update(HostSimulation& host)
+{
+    for (unsigned int i = 0; i < MAX_BOTS; ++i)
+    {
+        if (m_bots[i].m_isActive)
+        {
+            UpdateBot(host, (uint8_t)i);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Carries out whatever the bots asked for during the last ticks. Spawning and attacking create entities and broadcast,
+//so this has to run on the thread that owns the session, never inside Step().
+void BotDirector::ApplyQueuedActions(HostSimulation& host)
+{
+    for (unsigned int i = 0; i < MAX_BOTS; ++i)
+    {
+        Bot& bot = m_bots[i];
+        uint8_t index = (uint8_t)i;
+        if (bot.m_isSpawnQueued)
+        {
+            bot.m_isSpawnQueued = false;
+            host.BroadcastLinkCreation(index, host.m_playerColors[index]);
+        }
+        if (bot.m_isAttackQueued)
+        {
+            bot.m_isAttackQueued = false;
+            Link* player = host.m_players[index];
+            if (player && !player->IsAttacking())
+            {
+                host.PerformAttack(index);
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void BotDirector::UpdateBot(HostSimulation& host, uint8_t index)
+{
+    Bot& bot = m_bots[index];
+    Link* player = host.m_players[index];
+    if (!player)
+    {
+        Steer(host, index, Vector2::ZERO);
+        if (bot.m_isSpawnQueued)
+        {
+            return;
+        }
+        if (!bot.m_isWaitingToRespawn)
+        {
+            bot.m_isWaitingToRespawn = true;
+            bot.m_respawnTick = host.m_clock.GetDeadline(RESPAWN_DELAY_TICKS);
+        }
+        else if (host.m_clock.HasReached(bot.m_respawnTick))
+        {
+            bot.m_isWaitingToRespawn = false;
+            bot.m_isSpawnQueued = true;
+        }
+        return;
+    }
+
+    Link* target = FindNearestTarget(host, player);
+    if (!target)
+    {
+        Steer(host, index, Vector2::ZERO);
+        return;
+    }
+
+    //Close enough to swing: face them and attack. Otherwise follow the shared field, or head straight for them when
+    //the field has nothing to say (same cell, or walled off).
+    Vector2 toTarget = target->m_position - player->m_position;
+    float distance = toTarget.Normalize();
+    if (distance < ATTACK_RANGE)
+    {
+        Steer(host, index, toTarget);
+        if (!player->IsAttacking() && !bot.m_isAttackQueued && host.m_clock.HasReached(bot.m_nextAttackTick))
+        {
+            bot.m_nextAttackTick = host.m_clock.GetDeadline(ATTACK_COOLDOWN_TICKS);
+            bot.m_isAttackQueued = true;
+        }
+        return;
+    }
+    Vector2 direction;
+    if (!GetFlowFieldTo(target).GetDirection(player->m_position, direction))
+    {
+        direction = toTarget;
+    }
+    Steer(host, index, direction);
+}
+
+//-----------------------------------------------------------------------------------
+Link* BotDirector::FindNearestTarget(HostSimulation& host, const Link* bot) const
+{
+    Link* nearestTarget = nullptr;
+    float nearestDistanceSquared = 0.0f;
+    for (Link* player : host.m_players)
+    {
+        if (!player || player == bot || player->m_isDead)
+        {
+            continue;
+        }
+        Vector2 difference = player->m_position - bot->m_position;
+        float distanceSquared = difference.Dot(difference);
+        if (!nearestTarget || distanceSquared < nearestDistanceSquared)
+        {
+            nearestTarget = player;
+            nearestDistanceSquared = distanceSquared;
+        }
+    }
+    return nearestTarget;
+}
+
+//-----------------------------------------------------------------------------------
+//Fields are keyed by who they lead to, so every bot chasing the same player shares one build.
+const FlowField& BotDirector::GetFlowFieldTo(const Link* target)
+{
+    FlowField& flowField = m_flowFields[target->m_netOwnerIndex];
+    unsigned int targetCell = m_navigationGrid.GetCellIndex(target->m_position);
+    if (!flowField.IsBuiltFor(targetCell))
+    {
+        flowField.Build(m_navigationGrid, targetCell);
+        ++m_numFlowFieldBuilds;
+    }
+    return flowField;
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int BotDirector::GetNumOccupiedSlots(const HostSimulation& host) const
+{
+    unsigned int numOccupied = 0;
+    for (unsigned int i = 0; i < MAX_BOTS; ++i)
+    {
+        if (m_bots[i].m_isActive || IsSlotConnected(host, (uint8_t)i))
+        {
+            ++numOccupied;
+        }
+    }
+    return numOccupied;
+}
+
+//-----------------------------------------------------------------------------------
+//Only this match's own connections count. A slot taken by a connection in another match is free to fill here.
+bool BotDirector::IsSlotConnected(const HostSimulation& host, uint8_t index)
+{
+    return (host.m_connectionMask & (1u << index)) != 0;
+}
+
+//-----------------------------------------------------------------------------------
+//Same axes a client's update message sets, so bots can't do anything a remote player couldn't.
+void BotDirector::Steer(HostSimulation& host, uint8_t index, const Vector2& direction)
+{
+    const MovementAxes& movementAxes = host.m_movementAxes[index];
+    movementAxes.m_right->SetValue(direction.x > 0.0f ? direction.x : 0.0f, direction.x < 0.0f ? -direction.x : 0.0f);
+    movementAxes.m_up->SetValue(direction.y > 0.0f ? direction.y : 0.0f, direction.y < 0.0f ? -direction.y : 0.0f);
+}
+
+//-----------------------------------------------------------------------------------
+//Dedicated servers run several matches, so the bot commands take the match index after their own arguments.
+static HostSimulation* FindHostForCommand(Command& args, int matchArgumentIndex)
+{
+    MatchManager* matches = TheGame::instance->m_matches;
+    if (!matches)
+    {
+        return TheGame::instance->m_host;
+    }
+    int matchIndex = args.HasArgs(matchArgumentIndex + 1) ? atoi(args.GetStringArgument(matchArgumentIndex).c_str()) : 0;
+    return matchIndex >= 0 ? matches->GetMatch((unsigned int)matchIndex) : nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(addbots)
+{
+    HostSimulation* host = FindHostForCommand(args, 1);
+    if (!host)
+    {
+        Console::instance->PrintLine("addbots only works while hosting a match", RGBA::RED);
+        return;
+    }
+    int numBots = args.HasArgs(1) ? atoi(args.GetStringArgument(0).c_str()) : 1;
+    if (numBots <= 0)
+    {
+        Console::instance->PrintLine("addbots <count> [match]", RGBA::RED);
+        return;
+    }
+    unsigned int numAdded = host->m_bots.AddBots(*host, (unsigned int)numBots);
+    Console::instance->PrintLine(Stringf("Added %u of %i bots", numAdded, numBots), RGBA::WHITE);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(removebots)
+{
+    HostSimulation* host = FindHostForCommand(args, 0);
+    if (!host)
+    {
+        Console::instance->PrintLine("removebots only works while hosting a match", RGBA::RED);
+        return;
+    }
+    host->m_bots.RemoveAllBots(*host);
+    Console::instance->PrintLine(Stringf("Removed all bots, %u flowfield builds so far", host->m_bots.GetNumFlowFieldBuilds()), RGBA::WHITE);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <stdint.h>
+#include "Engine/Net/UDPIP/NetSession.hpp"
+#include "Game/AI/FlowField.hpp"
+#include "Game/SimulationClock.hpp"
+
+class HostSimulation;
+class Link;
+
+//-----------------------------------------------------------------------------------
+//Host-side players for slots nobody is connected to. Bots only ever write to their slot's network mapping and ask the
+//host to attack or respawn, so they go through exactly the same Link::Update path as a remote player would. Update()
+//runs inside the tick, which can be on a worker thread, so those requests wait for ApplyQueuedActions().
+class BotDirector
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    BotDirector(const NavigationGrid& navigationGrid);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    unsigned int AddBots(HostSimulation& host, unsigned int numBots);
+    void RemoveBot(HostSimulation& host, uint8_t index);
+    void RemoveAllBots(HostSimulation& host);
+    void RemoveBotsOverLimit(HostSimulation& host);
+    void Update(HostSimulation& host);
+    void ApplyQueuedActions(HostSimulation& host);
+    inline bool IsBot(uint8_t index) const { return m_bots[index].m_isActive; };
+    inline unsigned int GetNumFlowFieldBuilds() const { return m_numFlowFieldBuilds; };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int MAX_BOTS = NetSession::MAX_CONNECTIONS;
+    static const SimulationTick RESPAWN_DELAY_TICKS = SimulationClock::TICKS_PER_SECOND * 2;
+    static const SimulationTick ATTACK_COOLDOWN_TICKS = SimulationClock::TICKS_PER_SECOND / 2;
+    static const float ATTACK_RANGE;
+
+private:
+    struct Bot
+    {
+        bool m_isActive;
+        bool m_isWaitingToRespawn;
+        bool m_isSpawnQueued;
+        bool m_isAttackQueued;
+        SimulationTick m_respawnTick;
+        SimulationTick m_nextAttackTick;
+    };
+
+    void UpdateBot(HostSimulation& host, uint8_t index);
+    Link* FindNearestTarget(HostSimulation& host, const Link* bot) const;
+    const FlowField& GetFlowFieldTo(const Link* target);
+    unsigned int GetNumOccupiedSlots(const HostSimulation& host) const;
+    static bool IsSlotConnected(const HostSimulation& host, uint8_t index);
+    static void Steer(HostSimulation& host, uint8_t index, const Vector2& direction);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    const NavigationGrid& m_navigationGrid;
+    Bot m_bots[MAX_BOTS];
+    FlowField m_flowFields[MAX_BOTS]; //One per target player slot, rebuilt only when that player changes cells.
+    unsigned int m_numFlowFieldBuilds;
+};
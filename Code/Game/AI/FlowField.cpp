@@ -0,0 +1,147 @@
+#include "Game/AI/FlowField.hpp"
+
+//Orthogonal neighbors first, so they win ties against the diagonals.
+static const int NEIGHBOR_OFFSETS[8][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 }, { -1, -1 }, { 1, -1 }, { -1, 1 }, { 1, 1 } };
+static const unsigned int NUM_ORTHOGONAL_NEIGHBORS = 4;
+static const unsigned int NUM_NEIGHBORS = 8;
+static const float INVERSE_SQRT_2 = 0.70710678f;
+
+//-----------------------------------------------------------------------------------
+NavigationGrid::NavigationGrid(const AABB2& worldBounds, float cellSize)
+    : m_worldBounds(worldBounds)
+    , m_cellSize(cellSize)
+{
+    Vector2 dimensions = worldBounds.maxs - worldBounds.mins;
+    m_numColumns = (int)(dimensions.x / cellSize);
+    m_numRows = (int)(dimensions.y / cellSize);
+    m_isBlocked.resize(m_numColumns * m_numRows, 0);
+}
+
+//-----------------------------------------------------------------------------------
+void NavigationGrid::MarkBlockedCells(const std::vector<AABB2>& geometry, float clearanceRadius)
+{
+    for (unsigned int cellIndex = 0; cellIndex < GetNumCells(); ++cellIndex)
+    {
+        Vector2 center = GetCellCenter(cellIndex);
+        m_isBlocked[cellIndex] = 0;
+        for (const AABB2& box : geometry)
+        {
+            if (box.IsIntersecting(center, clearanceRadius))
+            {
+                m_isBlocked[cellIndex] = 1;
+                break;
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Positions outside the grid are clamped onto the edge cells.
+unsigned int NavigationGrid::GetCellIndex(const Vector2& position) const
+{
+    int column = (int)((position.x - m_worldBounds.mins.x) / m_cellSize);
+    int row = (int)((position.y - m_worldBounds.mins.y) / m_cellSize);
+    column = column < 0 ? 0 : (column >= m_numColumns ? m_numColumns - 1 : column);
+    row = row < 0 ? 0 : (row >= m_numRows ? m_numRows - 1 : row);
+    return (unsigned int)((row * m_numColumns) + column);
+}
+
+//-----------------------------------------------------------------------------------
+Vector2 NavigationGrid::GetCellCenter(unsigned int cellIndex) const
+{
+    int column = (int)cellIndex % m_numColumns;
+    int row = (int)cellIndex / m_numColumns;
+    return m_worldBounds.mins + Vector2(((float)column + 0.5f) * m_cellSize, ((float)row + 0.5f) * m_cellSize);
+}
+
+//-----------------------------------------------------------------------------------
+FlowField::FlowField()
+    : m_grid(nullptr)
+    , m_targetCell(0)
+{
+}
+
+//-----------------------------------------------------------------------------------
+void FlowField::Build(const NavigationGrid& grid, unsigned int targetCell)
+{
+    m_grid = &grid;
+    m_targetCell = targetCell;
+    unsigned int numCells = grid.GetNumCells();
+    int numColumns = grid.GetNumColumns();
+    int numRows = grid.GetNumRows();
+    m_distances.assign(numCells, (uint16_t)UNREACHABLE);
+    m_directions.assign(numCells, (uint8_t)NO_DIRECTION);
+    m_frontier.clear();
+    m_frontier.reserve(numCells);
+
+    //Breadth-first over the orthogonal neighbors. The target is seeded even if it's blocked, since whoever we're chasing
+    //can stand closer to a wall than a cell center can.
+    m_distances[targetCell] = 0;
+    m_frontier.push_back(targetCell);
+    for (unsigned int frontierIndex = 0; frontierIndex < m_frontier.size(); ++frontierIndex)
+    {
+        unsigned int cellIndex = m_frontier[frontierIndex];
+        int column = (int)cellIndex % numColumns;
+        int row = (int)cellIndex / numColumns;
+        for (unsigned int neighbor = 0; neighbor < NUM_ORTHOGONAL_NEIGHBORS; ++neighbor)
+        {
+            int neighborColumn = column + NEIGHBOR_OFFSETS[neighbor][0];
+            int neighborRow = row + NEIGHBOR_OFFSETS[neighbor][1];
+            if (neighborColumn < 0 || neighborColumn >= numColumns || neighborRow < 0 || neighborRow >= numRows)
+            {
+                continue;
+            }
+            unsigned int neighborIndex = (unsigned int)((neighborRow * numColumns) + neighborColumn);
+            if (m_distances[neighborIndex] == UNREACHABLE && !grid.IsBlocked(neighborIndex))
+            {
+                m_distances[neighborIndex] = m_distances[cellIndex] + 1;
+                m_frontier.push_back(neighborIndex);
+            }
+        }
+    }
+
+    //Each reached cell points at its closest neighbor, diagonals included as long as they don't clip a blocked corner.
+    for (unsigned int cellIndex : m_frontier)
+    {
+        int column = (int)cellIndex % numColumns;
+        int row = (int)cellIndex / numColumns;
+        uint16_t bestDistance = m_distances[cellIndex];
+        for (unsigned int neighbor = 0; neighbor < NUM_NEIGHBORS; ++neighbor)
+        {
+            int neighborColumn = column + NEIGHBOR_OFFSETS[neighbor][0];
+            int neighborRow = row + NEIGHBOR_OFFSETS[neighbor][1];
+            if (neighborColumn < 0 || neighborColumn >= numColumns || neighborRow < 0 || neighborRow >= numRows)
+            {
+                continue;
+            }
+            if (neighbor >= NUM_ORTHOGONAL_NEIGHBORS)
+            {
+                bool isCornerBlocked = grid.IsBlocked((unsigned int)((row * numColumns) + neighborColumn)) || grid.IsBlocked((unsigned int)((neighborRow * numColumns) + column));
+                if (isCornerBlocked)
+                {
+                    continue;
+                }
+            }
+            uint16_t neighborDistance = m_distances[(neighborRow * numColumns) + neighborColumn];
+            if (neighborDistance < bestDistance)
+            {
+                bestDistance = neighborDistance;
+                m_directions[cellIndex] = (uint8_t)neighbor;
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//False when there's nowhere to go: already in the target cell, or cut off from it.
+bool FlowField::GetDirection(const Vector2& position, Vector2& outDirection) const
+{
+    uint8_t direction = m_directions[m_grid->GetCellIndex(position)];
+    if (direction == NO_DIRECTION)
+    {
+        return false;
+    }
+    float scale = direction >= NUM_ORTHOGONAL_NEIGHBORS ? INVERSE_SQRT_2 : 1.0f;
+    outDirection = Vector2((float)NEIGHBOR_OFFSETS[direction][0] * scale, (float)NEIGHBOR_OFFSETS[direction][1] * scale);
+    return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Renderer/AABB2.hpp"
+
+//-----------------------------------------------------------------------------------
+//Walkability of the level on a uniform grid. A cell is blocked if a disc of the clearance radius at its center would
+//touch any level geometry, so anything steering between open cell centers keeps its collision disc out of the walls.
+class NavigationGrid
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    NavigationGrid(const AABB2& worldBounds, float cellSize);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void MarkBlockedCells(const std::vector<AABB2>& geometry, float clearanceRadius);
+    unsigned int GetCellIndex(const Vector2& position) const;
+    Vector2 GetCellCenter(unsigned int cellIndex) const;
+    inline bool IsBlocked(unsigned int cellIndex) const { return m_isBlocked[cellIndex] != 0; };
+    inline unsigned int GetNumCells() const { return (unsigned int)m_isBlocked.size(); };
+    inline int GetNumColumns() const { return m_numColumns; };
+    inline int GetNumRows() const { return m_numRows; };
+
+private:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    AABB2 m_worldBounds;
+    float m_cellSize;
+    int m_numColumns;
+    int m_numRows;
+    std::vector<uint8_t> m_isBlocked;
+};
+
+//-----------------------------------------------------------------------------------
+//Every open cell's best step toward one target cell, from a single breadth-first pass out of the target. Anyone heading
+//for the same target reads the same field, so the cost is per target rather than per follower.
+class FlowField
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    FlowField();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Build(const NavigationGrid& grid, unsigned int targetCell);
+    bool GetDirection(const Vector2& position, Vector2& outDirection) const;
+    inline bool IsBuiltFor(unsigned int targetCell) const { return m_grid && m_targetCell == targetCell; };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const uint16_t UNREACHABLE = 0xFFFF;
+    static const uint8_t NO_DIRECTION = 0xFF;
+
+private:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    const NavigationGrid* m_grid;
+    unsigned int m_targetCell;
+    std::vector<uint16_t> m_distances;
+    std::vector<uint8_t> m_directions; //Index into the neighbor offsets, or NO_DIRECTION.
+    std::vector<unsigned int> m_frontier;
+};
@@ -10,9 +10,30 @@
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Renderer/2D/ResourceDatabase.hpp"
 #include "Engine/Renderer/2D/ParticleSystemDefinition.hpp"
+#include "Game/Rendering/OneShotParticlePool.hpp"
+#include "Game/MessageFragmenter.hpp"
+#include "Game/GameCommon.hpp"
 #include "Engine/Audio/Audio.hpp"
-#include "Engine/Time/Time.hpp"
 #include "Engine/Math/MathUtilities.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Time/Time.hpp"
+
+//Hashed at compile time, so playing an effect is a binary search over IDs instead of a string lookup.
+static constexpr NameID DEAD_LINK_PARTICLE_IDS[2] = { NameID("DeadLink1"), NameID("DeadLink2") };
+static constexpr NameID SWORD_ATTACK_PARTICLE_ID("SwordAttack");
+static constexpr NameID BLOOD_POOL_PARTICLE_ID("BloodPool");
+static constexpr NameID HEART_SPRITE_IDS[ClientSimulation::NUM_HEART_SPRITES] = { NameID("fullHeart"), NameID("halfHeart"), NameID("emptyHeart") };
+
+//A changed input goes out this many more times after the first, so one lost packet doesn't leave the host holding it.
+static const uint8_t INPUT_REDUNDANT_SENDS = 2;
+//Acks ride on input updates. The host codes snapshots against the last one, so letting them lag costs downstream bytes.
+static const uint8_t SNAPSHOT_ACK_NET_TICKS = 4;
+static const uint8_t INPUT_KEEPALIVE_NET_TICKS = 20;
+
+const double ClientSimulation::MIN_INPUT_SEND_SECONDS = 1.0 / 120.0;
+bool ClientSimulation::s_isImmediateInputEnabled = true;
 
 //-----------------------------------------------------------------------------------
 ClientSimulation::ClientSimulation()
@@ -28,6 +49,12 @@ ClientSimulation::ClientSimulation()
     {
         m_hearts[i] = new Sprite("fullHeart", TheGame::FOREGROUND_LAYER, true);
     }
+    for (int i = 0; i < NUM_HEART_SPRITES; ++i)
+    {
+        m_heartSprites[i] = TheGame::instance->m_spriteResources.Find(HEART_SPRITE_IDS[i]);
+        ASSERT_OR_DIE(m_heartSprites[i], "Heart sprites must be registered before the client simulation is created.");
+    }
+    m_localMovementAxes.Resolve(TheGame::instance->m_gameplayMapping);
 
     TheGame::instance->m_gameplayMapping.FindInputValue("Attack")->m_OnPress.RegisterMethod(this, &ClientSimulation::OnLocalPlayerAttackInput);
     TheGame::instance->m_gameplayMapping.FindInputValue("FireBow")->m_OnPress.RegisterMethod(this, &ClientSimulation::OnLocalPlayerFireBowInput);
@@ -53,7 +80,12 @@ ClientSimulation::~ClientSimulation()
 //-----------------------------------------------------------------------------------
 void ClientSimulation::Update(float deltaSeconds)
 {
-    UNUSED(deltaSeconds);
+    //Clients only simulate cosmetics, so the ticks just need to be counted.
+    unsigned int numTicks = m_clock.Advance(deltaSeconds);
+    for (unsigned int i = 0; i < numTicks; ++i)
+    {
+        m_clock.Tick();
+    }
     if (m_localPlayer)
     {
         SpriteGameRenderer::instance->SetCameraPosition(m_localPlayer->m_position);
@@ -80,17 +112,17 @@ void ClientSimulation::UpdateHearts(float hp)
         m_hearts[i]->m_tintColor = m_localPlayerColor;
         if (hp >= 2.0f)
         {
-            m_hearts[i]->m_spriteResource = ResourceDatabase::instance->GetSpriteResource("fullHeart");
+            m_hearts[i]->m_spriteResource = m_heartSprites[FULL_HEART];
             hp -= 2.0f;
         }
         else if (hp >= 1.0f)
         {
-            m_hearts[i]->m_spriteResource = ResourceDatabase::instance->GetSpriteResource("halfHeart");
+            m_hearts[i]->m_spriteResource = m_heartSprites[HALF_HEART];
             hp -= 1.0f;
         }
         else
         {
-            m_hearts[i]->m_spriteResource = ResourceDatabase::instance->GetSpriteResource("emptyHeart");
+            m_hearts[i]->m_spriteResource = m_heartSprites[EMPTY_HEART];
         }
     }
 }
@@ -100,45 +132,221 @@ void ClientSimulation::OnUpdateFromHostReceived(const NetSender& from, NetMessag
 {
     if (from.connection)
     {
-        for (Link* networkedPlayer : m_players)
+        uint8_t format = PLAIN_SNAPSHOT;
+        message.Read<uint8_t>(format);
+        if (format == CODED_SNAPSHOT)
         {
-            if (networkedPlayer)
-            {
-                message.Read<Vector2>(networkedPlayer->m_position);
-                message.Read<Link::Facing>(networkedPlayer->m_facing);
-                message.Read<float>(networkedPlayer->m_hp);
-                networkedPlayer->ApplyClientUpdate();
-            }
+            ReadCodedSnapshot(message);
         }
+        else
+        {
+            ReadPlainSnapshot(message);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void ClientSimulation::ReadPlainSnapshot(NetMessage& message)
+{
+    uint8_t numLinks = 0;
+    message.Read<uint8_t>(numLinks);
+    for (unsigned int i = 0; i < numLinks; ++i)
+    {
+        uint16_t networkId = SlotMap<Entity>::INVALID_HANDLE;
+        Vector2 position;
+        Link::Facing facing = Link::SOUTH;
+        float hp = 0.0f;
+        message.Read<uint16_t>(networkId);
+        message.Read<Vector2>(position);
+        message.Read<Link::Facing>(facing);
+        message.Read<float>(hp);
+        ApplyLinkSnapshot(networkId, position, (uint8_t)facing, hp);
     }
-//         unsigned int numEntities = 0;
-//         message.Read<unsigned int>(numEntities);
-//         for (unsigned int i = 0; i < numEntities; ++i)
-//         {
-//             uint16_t networkId = 0;
-//             message.Read<uint16_t>(networkId);
-//             auto localEntity = m_entities.find(networkId);
-//             if (localEntity != m_entities.end())
-//             {
-//                 Entity* entity = localEntity->second;
-//                 message.Read<Vector2>(entity->m_position);
-//                 message.Read<float>(entity->m_rotationDegrees);
-//                 entity->ApplyClientUpdate();
-//             }
-//         }
 }
 
 //-----------------------------------------------------------------------------------
+//A piece coded against a baseline we no longer have is dropped. The host only codes against snapshots we've acked,
+//so this only happens after a long stall, and the next ack puts it right.
+void ClientSimulation::ReadCodedSnapshot(NetMessage& message)
+{
+    uint16_t sequence = 0;
+    uint16_t baselineSequence = 0;
+    bool hasBaseline = false;
+    uint8_t pieceIndex = 0;
+    uint8_t numPieces = 0;
+    uint8_t numLinks = 0;
+    uint16_t numBytes = 0;
+    message.Read<uint16_t>(sequence);
+    message.Read<uint16_t>(baselineSequence);
+    message.Read<bool>(hasBaseline);
+    message.Read<uint8_t>(pieceIndex);
+    message.Read<uint8_t>(numPieces);
+    message.Read<uint8_t>(numLinks);
+    message.Read<uint16_t>(numBytes);
+    if (numLinks > SnapshotFrame::MAX_SLOTS || numBytes > MessageFragmenter::MAX_MTU_BYTES)
+    {
+        return;
+    }
+    const SnapshotFrame* baseline = hasBaseline ? m_snapshots.FindBaseline(baselineSequence) : &SnapshotFrame::EMPTY;
+    if (!baseline)
+    {
+        return;
+    }
+
+    uint8_t coded[MessageFragmenter::MAX_MTU_BYTES];
+    for (unsigned int i = 0; i < numBytes; ++i)
+    {
+        message.Read<uint8_t>(coded[i]);
+    }
+    SnapshotLink links[SnapshotFrame::MAX_SLOTS];
+    if (!SnapshotCodec::GetTrained().Decode(*baseline, coded, numBytes, numLinks, links))
+    {
+        return;
+    }
+    if (!m_snapshots.AddPiece(sequence, pieceIndex, numPieces, links, numLinks))
+    {
+        return;
+    }
+    for (unsigned int i = 0; i < numLinks; ++i)
+    {
+        Vector2 position;
+        float hp = 0.0f;
+        SnapshotCodec::Dequantize(links[i].m_record, position.x, position.y, hp);
+        ApplyLinkSnapshot(links[i].m_record.m_networkId, position, links[i].m_record.m_facing, hp);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void ClientSimulation::ApplyLinkSnapshot(uint16_t networkId, const Vector2& position, uint8_t facing, float hp)
+{
+    //Records for links that have since been destroyed (or whose slot was reused) fail the handle check and are dropped.
+    Entity* entity = m_entities.Find(networkId);
+    if (entity && entity->IsPlayer())
+    {
+        Link* networkedPlayer = static_cast<Link*>(entity);
+        networkedPlayer->m_position = position;
+        networkedPlayer->m_facing = (Link::Facing)facing;
+        networkedPlayer->m_hp = hp;
+        networkedPlayer->ApplyClientUpdate();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Changes normally leave from SubmitInput() as they happen. The net tick repeats each one a couple of times in case it
+//was lost, and otherwise only sends often enough to keep the snapshot ack fresh, or as a keepalive. Attacks and
+//respawns have reliable messages of their own and never wait on this.
 void ClientSimulation::SendNetClientUpdate(NetConnection* cp)
 {
+    if (cp != NetSession::instance->m_hostConnection)
+    {
+        return; //Nobody else reads these.
+    }
+    double timeSeconds = GetCurrentTimeSeconds();
+    if (m_inputLatency.m_isAwaitingTick)
+    {
+        m_inputLatency.m_totalTickDelaySeconds += timeSeconds - m_inputLatency.m_awaitingTickSeconds;
+        ++m_inputLatency.m_numTickSamples;
+        m_inputLatency.m_isAwaitingTick = false;
+    }
+
+    InputSendState& state = m_inputSendState;
+    MovementInput input = MovementInput::Sample(m_localMovementAxes);
+    uint16_t newestSnapshot = 0;
+    bool hasSnapshot = m_snapshots.GetNewestComplete(newestSnapshot);
+    bool hasNewAck = hasSnapshot && (!state.m_hasSentAck || newestSnapshot != state.m_lastSentAck);
+    ++state.m_netTicksSinceSent;
+    if (input == state.m_lastSent)
+    {
+        if (state.m_redundantSendsLeft > 0)
+        {
+            --state.m_redundantSendsLeft;
+        }
+        else if (!(hasNewAck && state.m_netTicksSinceSent >= SNAPSHOT_ACK_NET_TICKS) && state.m_netTicksSinceSent < INPUT_KEEPALIVE_NET_TICKS)
+        {
+            return;
+        }
+    }
+    SendInputUpdate(cp, input, timeSeconds);
+}
+
+//-----------------------------------------------------------------------------------
+//The message pump stamps key and mouse messages as it takes them off the queue. Only the oldest unsent one matters,
+//since that's how long the input it caused has been waiting.
+void ClientSimulation::OnInputEvent(double timeSeconds)
+{
+    if (!m_inputSendState.m_hasPendingEvent)
+    {
+        m_inputSendState.m_pendingEventSeconds = timeSeconds;
+        m_inputSendState.m_hasPendingEvent = true;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Runs every frame straight after the input system updates and before the net session does, so a change goes out the
+//frame it happens instead of on the next net tick. Changes closer together than MIN_INPUT_SEND_SECONDS are held, and
+//whatever the input is by the time the window closes goes out as one update.
+void ClientSimulation::SubmitInput(double timeSeconds)
+{
+    InputSendState& state = m_inputSendState;
+    MovementInput input = MovementInput::Sample(m_localMovementAxes);
+    if (input == state.m_lastSent)
+    {
+        state.m_hasPendingEvent = false; //Whatever was pressed wasn't movement.
+        return;
+    }
+    if (!state.m_hasPendingEvent)
+    {
+        OnInputEvent(timeSeconds); //Sticks are polled rather than pumped, so they're stamped here.
+    }
+    if (!m_inputLatency.m_isAwaitingTick)
+    {
+        m_inputLatency.m_awaitingTickSeconds = state.m_pendingEventSeconds;
+        m_inputLatency.m_isAwaitingTick = true;
+    }
+
+    NetConnection* hostConnection = NetSession::instance->m_hostConnection;
+    if (s_isImmediateInputEnabled && hostConnection && timeSeconds - state.m_lastSentSeconds >= MIN_INPUT_SEND_SECONDS)
+    {
+        SendInputUpdate(hostConnection, input, timeSeconds);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void ClientSimulation::SendInputUpdate(NetConnection* cp, const MovementInput& input, double timeSeconds)
+{
+    InputSendState& state = m_inputSendState;
+    if (input != state.m_lastSent)
+    {
+        double sendDelaySeconds = state.m_hasPendingEvent ? timeSeconds - state.m_pendingEventSeconds : 0.0;
+        m_inputLatency.m_totalSendDelaySeconds += sendDelaySeconds;
+        m_inputLatency.m_maxSendDelaySeconds = sendDelaySeconds > m_inputLatency.m_maxSendDelaySeconds ? sendDelaySeconds : m_inputLatency.m_maxSendDelaySeconds;
+        ++m_inputLatency.m_numSends;
+        state.m_lastSent = input;
+        state.m_redundantSendsLeft = INPUT_REDUNDANT_SENDS;
+        state.m_hasPendingEvent = false;
+    }
+    state.m_lastSentSeconds = timeSeconds;
+    state.m_netTicksSinceSent = 0;
+
+    uint16_t newestSnapshot = 0;
+    bool hasSnapshot = m_snapshots.GetNewestComplete(newestSnapshot);
+    uint8_t header = input.m_buttons;
+    header |= input.m_isAnalog ? ANALOG_INPUT_FLAG : 0;
+    header |= hasSnapshot ? SNAPSHOT_ACK_FLAG : 0;
     NetMessage update(GameNetMessages::CLIENT_TO_HOST_UPDATE);
-    InputMap& input = TheGame::instance->m_gameplayMapping;
-    InputAxis* rightAxis = input.FindInputAxis("Right");
-    InputAxis* upAxis = input.FindInputAxis("Up");
-    Vector2 rightAxisValues(rightAxis->m_positiveValue->m_currentValue, rightAxis->m_negativeValue->m_currentValue);
-    Vector2 upAxisValues(upAxis->m_positiveValue->m_currentValue, upAxis->m_negativeValue->m_currentValue);
-    update.Write<Vector2>(rightAxisValues);
-    update.Write<Vector2>(upAxisValues);
+    update.Write<uint8_t>(state.m_sequence++);
+    update.Write<uint8_t>(header);
+    if (input.m_isAnalog)
+    {
+        update.Write<int8_t>(input.m_right);
+        update.Write<int8_t>(input.m_up);
+    }
+    if (hasSnapshot)
+    {
+        update.Write<uint16_t>(newestSnapshot);
+        state.m_lastSentAck = newestSnapshot;
+        state.m_hasSentAck = true;
+    }
     cp->SendMessage(update);
 }
 
@@ -147,19 +355,25 @@ void ClientSimulation::OnPlayerCreate(const NetSender&, NetMessage message)
 {
     static const SoundID spawnSound = AudioSystem::instance->CreateOrGetSound("Data\\SFX\\Oracle_SwordShimmer.wav");
     static const SoundID twahSound = AudioSystem::instance->CreateOrGetSound("Data\\SFX\\mars1e.wav");
-    Link* player = new Link();
     unsigned int color = 0;
     bool isRequest = false;
+    uint8_t index = NetSession::INVALID_CONNECTION_INDEX;
+    uint16_t networkId = SlotMap<Entity>::INVALID_HANDLE;
 
     //Read in link data
     message.Read<bool>(isRequest);
-    message.Read<uint8_t>(player->m_netOwnerIndex);
+    message.Read<uint8_t>(index);
     message.Read<unsigned int>(color);
 
     if (!isRequest)
     {
+        message.Read<uint16_t>(networkId);
+        Link* player = new Link(&m_clock);
+        player->m_netOwnerIndex = index;
+        player->m_networkId = networkId;
         player->SetColor(color);
         m_players[player->m_netOwnerIndex] = player;
+        m_entities.InsertAt(networkId, player);
         if (player->m_netOwnerIndex == NetSession::instance->GetMyConnectionIndex())
         {
             m_localPlayer = player;
@@ -168,37 +382,58 @@ void ClientSimulation::OnPlayerCreate(const NetSender&, NetMessage message)
         }
         AudioSystem::instance->PlaySound(m_isTwahMode ? twahSound : spawnSound);
     }
-    else
+}
+
+//-----------------------------------------------------------------------------------
+void ClientSimulation::OnEntityDespawnBatch(const NetSender&, NetMessage message)
+{
+    uint16_t numDespawns = 0;
+    message.Read<uint16_t>(numDespawns);
+    for (unsigned int i = 0; i < numDespawns; ++i)
     {
-        delete player;
+        uint16_t networkId = SlotMap<Entity>::INVALID_HANDLE;
+        message.Read<uint16_t>(networkId);
+
+        //Ignore anything we never saw spawn, or a handle that's already been reused.
+        Entity* entity = m_entities.Find(networkId);
+        if (!entity)
+        {
+            continue;
+        }
+        m_entities.Remove(networkId);
+        if (entity->IsPlayer())
+        {
+            DestroyPlayer(static_cast<Link*>(entity));
+        }
+        else
+        {
+            delete entity;
+        }
     }
 }
 
 //-----------------------------------------------------------------------------------
-void ClientSimulation::OnPlayerDestroy(const NetSender&, NetMessage message)
+void ClientSimulation::DestroyPlayer(Link* player)
 {
     static const SoundID deathSound = AudioSystem::instance->CreateOrGetSound("Data\\SFX\\Oracle_Link_Dying.wav");
     static const SoundID twahSound = AudioSystem::instance->CreateOrGetSound("Data\\SFX\\mars16.wav");
-    uint8_t index = NetSession::INVALID_CONNECTION_INDEX;
-    message.Read<uint8_t>(index);
 
     //Spawn a deadboy right here.
-    if (m_players[index])
-    {
-        const std::string particleEffect = MathUtils::GetRandomIntFromZeroTo(2) == 0 ? "DeadLink1" : "DeadLink2";
-        ResourceDatabase::instance->GetParticleSystemResource(particleEffect)->m_emitterDefinitions[0]->m_initialTintPerParticle = m_players[index]->m_color;
-        ParticleSystem::PlayOneShotParticleEffect(particleEffect, TheGame::BODY_LAYER, m_players[index]->m_position, 0.0f);
-        ParticleSystem::PlayOneShotParticleEffect("BloodPool", TheGame::BLOOD_LAYER, m_players[index]->m_position, GetRandomFloatInRange(0.0f, 360.0f));
-    }
+    const ParticleSystemDefinition* deadLinkSystem = TheGame::instance->m_particleSystems.Find(DEAD_LINK_PARTICLE_IDS[MathUtils::GetRandomIntFromZeroTo(2)]);
+    TheGame::instance->m_bodyParticles->Play(*deadLinkSystem, player->m_position, 0.0f, player->m_color);
+    TheGame::instance->m_bloodParticles->Play(*TheGame::instance->m_particleSystems.Find(BLOOD_POOL_PARTICLE_ID), player->m_position, GetRandomFloatInRange(0.0f, 360.0f), RGBA::WHITE);
 
-    if (m_players[index] == m_localPlayer)
+    if (player == m_localPlayer)
     {
         m_localPlayer = nullptr;
         UpdateHearts(0.0f);
         SpriteGameRenderer::instance->AddEffectToLayer(TheGame::instance->m_playerDeathEffect, TheGame::FOREGROUND_LAYER);
     }
-    delete m_players[index];
-    m_players[index] = nullptr;
+    if (m_players[player->m_netOwnerIndex] == player)
+    {
+        m_players[player->m_netOwnerIndex] = nullptr;
+    }
+    delete player;
 
     AudioSystem::instance->PlaySound(m_isTwahMode ? twahSound : deathSound);
 }
@@ -266,8 +501,8 @@ void ClientSimulation::OnPlayerAttack(const NetSender&, NetMessage message)
 
         if (attackingPlayer)
         {
-            ResourceDatabase::instance->GetParticleSystemResource("SwordAttack")->m_emitterDefinitions[0]->m_initialTintPerParticle = attackingPlayer->m_color;
-            ParticleSystem::PlayOneShotParticleEffect("SwordAttack", TheGame::WEAPON_LAYER, swordPosition, swordRotation);
+            attackingPlayer->m_attackStunEndTick = m_clock.GetDeadline(Link::SWORD_STUN_DURATION_TICKS);
+            TheGame::instance->m_weaponParticles->Play(*TheGame::instance->m_particleSystems.Find(SWORD_ATTACK_PARTICLE_ID), swordPosition, swordRotation, attackingPlayer->m_color);
 
             if (m_isTwahMode)
             {
@@ -305,7 +540,7 @@ void ClientSimulation::OnPlayerDamaged(const NetSender&, NetMessage message)
     hurtPlayer = m_players[index];
     if (hurtPlayer)
     {
-        hurtPlayer->m_timeOfLastHurt = GetCurrentTimeSeconds();
+        hurtPlayer->m_hurtFlashEndTick = m_clock.GetDeadline(Link::HURT_FLASH_DURATION_TICKS);
     }
 
     AudioSystem::instance->PlaySound(m_isTwahMode ? twahSound : hurtSound);
@@ -318,3 +553,32 @@ void ClientSimulation::OnPlayerFireBow(const NetSender& from, NetMessage& messag
     static const SoundID twahSound = AudioSystem::instance->CreateOrGetSound("Data\\SFX\\mars1d.wav");
     AudioSystem::instance->PlaySound(m_isTwahMode ? twahSound : shootSound);
 }
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(immediateinput)
+{
+    if (args.HasArgs(1))
+    {
+        ClientSimulation::s_isImmediateInputEnabled = atoi(args.GetStringArgument(0).c_str()) != 0;
+    }
+    Console::instance->PrintLine(Stringf("Immediate input is %s", ClientSimulation::s_isImmediateInputEnabled ? "on" : "off"), RGBA::WHITE);
+}
+
+//-----------------------------------------------------------------------------------
+//Only covers the client's side of the trip, from the message pump until the update is handed to the session.
+CONSOLE_COMMAND(inputlatency)
+{
+    UNUSED(args);
+    ClientSimulation* client = TheGame::instance->m_client;
+    if (!client)
+    {
+        Console::instance->PrintLine("inputlatency only works while connected as a client", RGBA::RED);
+        return;
+    }
+    ClientSimulation::InputLatencyStats& stats = client->m_inputLatency;
+    double averageSendMs = stats.m_numSends > 0 ? 1000.0 * stats.m_totalSendDelaySeconds / stats.m_numSends : 0.0;
+    double averageTickMs = stats.m_numTickSamples > 0 ? 1000.0 * stats.m_totalTickDelaySeconds / stats.m_numTickSamples : 0.0;
+    Console::instance->PrintLine(Stringf("%u input changes sent, %.2fms average (%.2fms max) from pump to send", stats.m_numSends, averageSendMs, 1000.0 * stats.m_maxSendDelaySeconds), RGBA::WHITE);
+    Console::instance->PrintLine(Stringf("Waiting for the net tick would have been %.2fms average", averageTickMs), RGBA::WHITE);
+    stats = ClientSimulation::InputLatencyStats();
+}
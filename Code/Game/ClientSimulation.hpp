@@ -1,6 +1,9 @@
 #pragma once
 #include <vector>
-#include <map>
+#include "Game/Entities/SlotMap.hpp"
+#include "Game/SimulationClock.hpp"
+#include "Game/PlayerInput.hpp"
+#include "Game/Net/SnapshotHistory.hpp"
 
 class Link;
 class NetMessage;
@@ -8,6 +11,7 @@ class Entity;
 class NetConnection;
 class InputValue;
 class Sprite;
+class SpriteResource;
 struct NetSender;
 
 class ClientSimulation
@@ -21,9 +25,16 @@ public:
     void Update(float deltaSeconds);
     void UpdateHearts(float hp);
     void OnUpdateFromHostReceived(const NetSender& from, NetMessage& message);
+    void ReadPlainSnapshot(NetMessage& message);
+    void ReadCodedSnapshot(NetMessage& message);
+    void ApplyLinkSnapshot(uint16_t networkId, const Vector2& position, uint8_t facing, float hp);
     void SendNetClientUpdate(NetConnection* cp);
+    void OnInputEvent(double timeSeconds);
+    void SubmitInput(double timeSeconds);
+    void SendInputUpdate(NetConnection* cp, const MovementInput& input, double timeSeconds);
     void OnPlayerCreate(const NetSender& from, NetMessage message);
-    void OnPlayerDestroy(const NetSender& from, NetMessage message);
+    void OnEntityDespawnBatch(const NetSender& from, NetMessage message);
+    void DestroyPlayer(Link* player);
     void OnLocalPlayerAttackInput(const InputValue* attackInput);
     void OnLocalPlayerFireBowInput(const InputValue* bowInput);
     void OnLocalPlayerRespawnInput(const InputValue* respawnInput);
@@ -32,11 +43,60 @@ public:
     void OnPlayerFireBow(const NetSender& from, NetMessage& message);
     inline void ToggleTwah(const InputValue*) { m_isTwahMode = !m_isTwahMode; };
 
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    enum HeartSprite
+    {
+        FULL_HEART,
+        HALF_HEART,
+        EMPTY_HEART,
+        NUM_HEART_SPRITES
+    };
+
+    //What was last sent to the host, and when.
+    struct InputSendState
+    {
+        InputSendState() : m_lastSentSeconds(0.0), m_pendingEventSeconds(0.0), m_sequence(0), m_netTicksSinceSent(0), m_redundantSendsLeft(0), m_lastSentAck(0), m_hasSentAck(false), m_hasPendingEvent(false) {};
+
+        MovementInput m_lastSent;
+        double m_lastSentSeconds;
+        double m_pendingEventSeconds; //When the oldest input that hasn't gone out yet came off the message pump.
+        uint8_t m_sequence;
+        uint8_t m_netTicksSinceSent;
+        uint8_t m_redundantSendsLeft;
+        uint16_t m_lastSentAck;
+        bool m_hasSentAck;
+        bool m_hasPendingEvent;
+    };
+
+    //From the message pump to the movement update leaving, against how long the same change would have waited for the
+    //net tick. Read and reset by "inputlatency".
+    struct InputLatencyStats
+    {
+        InputLatencyStats() : m_totalSendDelaySeconds(0.0), m_maxSendDelaySeconds(0.0), m_totalTickDelaySeconds(0.0), m_awaitingTickSeconds(0.0), m_numSends(0), m_numTickSamples(0), m_isAwaitingTick(false) {};
+
+        double m_totalSendDelaySeconds;
+        double m_maxSendDelaySeconds;
+        double m_totalTickDelaySeconds;
+        double m_awaitingTickSeconds;
+        unsigned int m_numSends;
+        unsigned int m_numTickSamples;
+        bool m_isAwaitingTick;
+    };
+
+    static const double MIN_INPUT_SEND_SECONDS; //Caps immediate sends at 120 a second, however fast frames come.
+    static bool s_isImmediateInputEnabled;
+
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     Link* m_localPlayer;
     unsigned int m_localPlayerColor;
     std::vector<Link*> m_players;
-    std::map<uint16_t, Entity*> m_entities;
+    SlotMap<Entity> m_entities;
     Sprite* m_hearts[5];
+    const SpriteResource* m_heartSprites[NUM_HEART_SPRITES];
+    MovementAxes m_localMovementAxes;
+    SimulationClock m_clock;
+    SnapshotReceiveHistory m_snapshots;
+    InputSendState m_inputSendState;
+    InputLatencyStats m_inputLatency;
     bool m_isTwahMode;
 };
\ No newline at end of file
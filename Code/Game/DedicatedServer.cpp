@@ -0,0 +1,110 @@
+#include "Game/DedicatedServer.hpp"
+#include "Game/TheGame.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/MatchManager.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Core/Event.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <thread>
+#include <iostream>
+
+extern Event<float> NetworkUpdate;
+
+DedicatedServer* DedicatedServer::instance = nullptr;
+
+//-----------------------------------------------------------------------------------
+DedicatedServer::DedicatedServer(float ticksPerSecond)
+    : m_secondsPerTick(1.0f / ticksPerSecond)
+    , m_tickPacer(ticksPerSecond, 0.0)
+    , m_isQuitting(false)
+{
+    ASSERT_OR_DIE(ticksPerSecond > 0.0f, "A dedicated server needs a positive tick rate.");
+}
+
+//-----------------------------------------------------------------------------------
+DedicatedServer::~DedicatedServer()
+{
+}
+
+//-----------------------------------------------------------------------------------
+//The pacer schedules ticks against absolute deadlines, so oversleeping one tick shortens the next wait rather than
+//drifting. A server that falls too far behind (a debugger break, a stalled VM) drops the backlog instead of
+//fast-forwarding it.
+void DedicatedServer::Run(const std::string& hostName, unsigned int numMatches, unsigned int playersPerMatch)
+{
+    TheGame::instance->StartDedicatedHost(hostName, numMatches, playersPerMatch);
+
+    //getline can't be interrupted portably, so the reader is detached and simply dies with the process.
+    std::thread consoleThread(&DedicatedServer::ReadConsoleInput, this);
+    consoleThread.detach();
+
+    m_tickPacer.Restart();
+    while (!m_isQuitting)
+    {
+        m_tickPacer.Wait();
+        m_tickPacer.BeginFrame(FramePacer::Clock::now());
+        Tick(m_secondsPerTick);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void DedicatedServer::Tick(float deltaSeconds)
+{
+    RunQueuedCommands();
+    NetworkUpdate.Trigger(deltaSeconds);
+    TheGame::instance->Update(deltaSeconds);
+}
+
+//-----------------------------------------------------------------------------------
+void DedicatedServer::ReadConsoleInput()
+{
+    std::string line;
+    while (!m_isQuitting && std::getline(std::cin, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(m_commandLock);
+        m_queuedCommands.push_back(line);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Commands touch the simulation and the session, so they only ever run here on the tick thread.
+void DedicatedServer::RunQueuedCommands()
+{
+    std::vector<std::string> commands;
+    {
+        std::lock_guard<std::mutex> lock(m_commandLock);
+        commands.swap(m_queuedCommands);
+    }
+    for (const std::string& command : commands)
+    {
+        if (command == "quit")
+        {
+            RequestQuit();
+            continue;
+        }
+        Console::instance->RunCommand(command);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(serverstats)
+{
+    UNUSED(args);
+    if (!DedicatedServer::instance)
+    {
+        Console::instance->PrintLine("serverstats only runs on a dedicated server.", RGBA::RED);
+        return;
+    }
+    const FrameTimeStats& tickStats = DedicatedServer::instance->GetTickStats();
+    Console::instance->PrintLine(Stringf("Late ticks: %u, %.2fms average tick interval, %.3fms jitter, %.2fms worst", tickStats.m_numLateFrames, 1000.0 * tickStats.GetAverageSeconds(), 1000.0 * tickStats.GetJitterSeconds(), 1000.0 * tickStats.m_maxSeconds), RGBA::WHITE);
+    MatchManager* matches = TheGame::instance->m_matches;
+    for (unsigned int i = 0; matches && i < matches->GetNumMatches(); ++i)
+    {
+        Console::instance->PrintLine(Stringf("Match %u: %u players", i, matches->GetNumPlayers(i)), RGBA::WHITE);
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Game/FramePacer.hpp"
+
+//-----------------------------------------------------------------------------------
+//Runs a headless TheGame as a host at a fixed tick, with no window, renderer, input or audio. Between ticks the thread
+//sleeps until the next tick is due instead of spinning, so many servers can share a core. Console commands are read
+//from stdin and run on the tick thread, the same as anything typed into the in-game console.
+class DedicatedServer
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    DedicatedServer(float ticksPerSecond);
+    ~DedicatedServer();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Run(const std::string& hostName, unsigned int numMatches, unsigned int playersPerMatch);
+    inline void RequestQuit() { m_isQuitting = true; };
+    inline const FrameTimeStats& GetTickStats() const { return m_tickPacer.GetStats(); };
+
+    static DedicatedServer* instance;
+
+private:
+    void Tick(float deltaSeconds);
+    void ReadConsoleInput();
+    void RunQueuedCommands();
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    float m_secondsPerTick;
+    FramePacer m_tickPacer; //Never spins: servers share cores, and a tick a fraction of a millisecond late costs nothing.
+    std::atomic<bool> m_isQuitting;
+    std::mutex m_commandLock;
+    std::vector<std::string> m_queuedCommands; //Filled by the stdin thread, drained at the start of each tick.
+};
@@ -1,6 +1,10 @@
 #include "Game/Entities/Arrow.hpp"
 #include "Engine/Renderer/2D/Sprite.hpp"
 #include "Game/TheGame.hpp"
+#include "Game/Entities/FixedBlockPool.hpp"
+
+//Sized for everyone emptying a quiver at once.
+static FixedBlockPool<Arrow, 256> s_arrowPool;
 
 //-----------------------------------------------------------------------------------
 Arrow::Arrow(Entity* owner, uint16_t networkId) 
@@ -11,7 +15,8 @@ Arrow::Arrow(Entity* owner, uint16_t networkId)
     , m_owner(owner)
 {
     m_networkId = networkId;
-    m_sprite = new Sprite("Arrow", TheGame::WEAPON_LAYER);
+    SetCollisionLayer(PROJECTILE_COLLISION);
+    m_sprite = CreateSprite("Arrow", TheGame::WEAPON_LAYER);
     m_sprite->m_scale = Vector2(1.0f, 1.0f);
 
     m_sprite->m_position = m_owner->m_sprite->m_position;
@@ -23,6 +28,18 @@ Arrow::~Arrow()
 {
 }
 
+//-----------------------------------------------------------------------------------
+void* Arrow::operator new(size_t size)
+{
+    return s_arrowPool.Allocate(size);
+}
+
+//-----------------------------------------------------------------------------------
+void Arrow::operator delete(void* pointer)
+{
+    s_arrowPool.Free(pointer);
+}
+
 //-----------------------------------------------------------------------------------
 void Arrow::Update(float deltaSeconds)
 {
@@ -46,10 +63,9 @@ void Arrow::Render() const
 }
 
 //-----------------------------------------------------------------------------------
-void Arrow::ResolveCollision(Entity* otherEntity)
+void Arrow::OnHit(Entity* otherEntity)
 {
-    Entity::ResolveCollision(otherEntity);
-    if (otherEntity != m_owner)
+    if (!m_isDead && otherEntity != m_owner)
     {
         otherEntity->TakeDamage(m_power);
         this->m_isDead = true;
@@ -7,10 +7,12 @@ class Arrow : public Entity
 public:
     Arrow(Entity* Owner, uint16_t networkId);
     virtual ~Arrow();
+    static void* operator new(size_t size);
+    static void operator delete(void* pointer);
 
     virtual void Update(float deltaSeconds);
     virtual void Render() const;
-    virtual void ResolveCollision(Entity* otherEntity);
+    void OnHit(Entity* otherEntity);
 
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     float m_speed;
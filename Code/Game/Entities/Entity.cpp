@@ -1,5 +1,9 @@
 #include "Game/Entities/Entity.hpp"
 #include "Engine/Renderer/2D/Sprite.hpp"
+#include "Game/Entities/FixedBlockPool.hpp"
+
+//Every entity owns exactly one sprite, so they come out of their own pool rather than the heap.
+static FixedBlockPool<Sprite, 512> s_spritePool;
 
 //-----------------------------------------------------------------------------------
 Entity::Entity()
@@ -8,6 +12,8 @@ Entity::Entity()
     , m_rotationDegrees(0.0f)
     , m_maxHp(1.0f)
     , m_collisionRadius(1.0f)
+    , m_collisionLayer(PROP_COLLISION)
+    , m_collisionMask(GetDefaultCollisionMask(PROP_COLLISION))
     , m_age(0.0f)
     , m_isDead(false)
     , m_position(0.0f)
@@ -21,7 +27,7 @@ Entity::~Entity()
 {
     if (m_sprite)
     {
-        delete m_sprite;
+        DestroySprite(m_sprite);
     }
 }
 
@@ -37,25 +43,6 @@ void Entity::Render() const
 
 }
 
-//-----------------------------------------------------------------------------------
-bool Entity::IsCollidingWith(Entity* otherEntity)
-{
-    return MathUtils::DoDiscsOverlap(this->m_position, this->m_collisionRadius, otherEntity->m_position, otherEntity->m_collisionRadius);
-}
-
-//-----------------------------------------------------------------------------------
-void Entity::ResolveCollision(Entity* otherEntity)
-{
-    Vector2& myPosition = m_position;
-    Vector2& otherPosition = otherEntity->m_position;
-    Vector2 difference = myPosition - otherPosition;
-    float distanceBetweenPoints = MathUtils::CalcDistanceBetweenPoints(otherPosition, myPosition);
-    float pushDistance = (this->m_collisionRadius - distanceBetweenPoints) / 8.f;
-    difference *= pushDistance;
-    myPosition -= difference;
-    otherPosition += difference;
-}
-
 //-----------------------------------------------------------------------------------
 void Entity::TakeDamage(float damage)
 {
@@ -76,3 +63,23 @@ void Entity::ApplyClientUpdate()
     }
 }
 
+//-----------------------------------------------------------------------------------
+void Entity::SetCollisionLayer(CollisionLayer layer)
+{
+    m_collisionLayer = layer;
+    m_collisionMask = GetDefaultCollisionMask(layer);
+}
+
+//-----------------------------------------------------------------------------------
+Sprite* Entity::CreateSprite(const std::string& spriteResourceName, unsigned int layer)
+{
+    return new (s_spritePool.Allocate()) Sprite(spriteResourceName, layer);
+}
+
+//-----------------------------------------------------------------------------------
+void Entity::DestroySprite(Sprite* sprite)
+{
+    sprite->~Sprite();
+    s_spritePool.Free(sprite);
+}
+
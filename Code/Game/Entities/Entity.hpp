@@ -1,7 +1,9 @@
 #pragma once
 #include "Engine/Components/Transform3D.hpp"
 #include "Engine/Math/Vector2.hpp"
+#include "Game/Physics/CollisionFilter.hpp"
 #include <stdint.h>
+#include <string>
 
 class Sprite;
 
@@ -13,11 +15,13 @@ public:
 
     virtual void Update(float deltaSeconds);
     virtual void Render() const;
-    virtual bool IsCollidingWith(Entity* otherEntity);
-    virtual void ResolveCollision(Entity* otherEntity);
     virtual void TakeDamage(float m_power);
     virtual void ApplyClientUpdate();
     inline virtual bool IsPlayer() { return false; }
+    void SetCollisionLayer(CollisionLayer layer);
+    static Sprite* CreateSprite(const std::string& spriteResourceName, unsigned int layer);
+    static void DestroySprite(Sprite* sprite);
+
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     uint16_t m_networkId;
     Sprite* m_sprite;
@@ -26,6 +30,8 @@ public:
     float m_hp;
     float m_maxHp;
     float m_collisionRadius;
+    CollisionLayer m_collisionLayer;
+    CollisionMask m_collisionMask;
     float m_age;
     bool m_isDead;
 };
\ No newline at end of file
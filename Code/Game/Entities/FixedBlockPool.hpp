@@ -0,0 +1,85 @@
+#pragma once
+#include <stddef.h>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+//-----------------------------------------------------------------------------------
+//Fixed-capacity free list of blocks sized for T. Used as the backing store for class-level operator new/delete,
+//so spawning and despawning entities never touches the general-purpose heap while the pool has room.
+//Requests for a different size (derived classes) or past capacity spill to the heap, and Free() sends them back there.
+//Matches tick on different threads and share the pool, so the free list is locked; it's uncontended almost always.
+template <typename T, unsigned int NUM_BLOCKS>
+class FixedBlockPool
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    FixedBlockPool()
+        : m_freeList(nullptr)
+        , m_numAllocated(0)
+    {
+        for (int i = NUM_BLOCKS - 1; i >= 0; --i)
+        {
+            m_blocks[i].m_next = m_freeList;
+            m_freeList = &m_blocks[i];
+        }
+    }
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void* Allocate(size_t size = sizeof(T))
+    {
+        if (size != sizeof(T))
+        {
+            return ::operator new(size);
+        }
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (!m_freeList)
+        {
+            return ::operator new(size);
+        }
+        Block* block = m_freeList;
+        m_freeList = block->m_next;
+        ++m_numAllocated;
+        return block;
+    }
+
+    void Free(void* pointer)
+    {
+        if (!pointer)
+        {
+            return;
+        }
+        if (!Owns(pointer))
+        {
+            ::operator delete(pointer);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_lock);
+        Block* block = static_cast<Block*>(pointer);
+        block->m_next = m_freeList;
+        m_freeList = block;
+        --m_numAllocated;
+    }
+
+    inline bool Owns(const void* pointer) const { return pointer >= &m_blocks[0] && pointer < &m_blocks[NUM_BLOCKS]; };
+    inline unsigned int GetNumAllocated() const { return m_numAllocated; };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int CAPACITY = NUM_BLOCKS;
+
+private:
+    FixedBlockPool(const FixedBlockPool&) = delete;
+    FixedBlockPool& operator= (const FixedBlockPool&) = delete;
+
+    union Block
+    {
+        Block* m_next;
+        typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type m_storage;
+    };
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    Block m_blocks[NUM_BLOCKS];
+    Block* m_freeList;
+    unsigned int m_numAllocated;
+    std::mutex m_lock;
+};
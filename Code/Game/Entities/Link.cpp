@@ -6,24 +6,31 @@
 #include "Game/TheGame.hpp"
 #include "Engine/Renderer/2D/ResourceDatabase.hpp"
 #include "Game/HostSimulation.hpp"
-#include "Engine/Time/Time.hpp"
 #include "Engine/Renderer/AABB2.hpp"
+#include "Game/Entities/FixedBlockPool.hpp"
+
+static FixedBlockPool<Link, 64> s_linkPool;
+static constexpr NameID FACING_SPRITE_IDS[Link::NUM_DIRECTIONS] = { NameID("pLeft"), NameID("pUp"), NameID("pRight"), NameID("pDown") };
+const SpriteResource* Link::s_facingSprites[Link::NUM_DIRECTIONS] = {};
 
 //-----------------------------------------------------------------------------------
-Link::Link(const RGBA& color) 
+Link::Link(const SimulationClock* clock, const RGBA& color) 
     : Entity()
+    , m_simulation(nullptr)
     , m_netOwnerIndex(0)
     , m_facing(Facing::SOUTH)
     , m_rateOfFire(0.0f)
-    , m_timeOfLastHurt(0.0f)
-    , m_timeOfLastAttack(0.0f)
+    , m_clock(clock)
+    , m_hurtFlashEndTick(clock->GetCurrentTick())
+    , m_attackStunEndTick(clock->GetCurrentTick())
     , m_color(color)
 {
     m_collisionRadius = 0.3f;
+    SetCollisionLayer(PLAYER_COLLISION);
     m_isDead = false;
     m_maxHp = 10.0f;
     m_hp = 10.0f;
-    m_sprite = new Sprite("pDown", TheGame::PLAYER_LAYER);
+    m_sprite = CreateSprite("pDown", TheGame::PLAYER_LAYER);
     m_sprite->m_scale = Vector2(1.0f, 1.0f);
     m_sprite->m_tintColor = m_color;
     m_speed = 1.0f;
@@ -36,18 +43,27 @@ Link::~Link()
 
 }
 
+//-----------------------------------------------------------------------------------
+void* Link::operator new(size_t size)
+{
+    return s_linkPool.Allocate(size);
+}
+
+//-----------------------------------------------------------------------------------
+void Link::operator delete(void* pointer)
+{
+    s_linkPool.Free(pointer);
+}
+
 //-----------------------------------------------------------------------------------
 void Link::Update(float deltaSeconds)
 {
     const float SPEED_DIVISOR = 20.0f;
-    ASSERT_OR_DIE(TheGame::instance->m_host, "Update for the player should not be called on the clients.");
+    ASSERT_OR_DIE(m_simulation, "Update for the player should not be called on the clients.");
 
     Entity::Update(deltaSeconds);
-    m_timeOfLastHurt += deltaSeconds;
     float adjustedSpeed = m_speed / SPEED_DIVISOR;
-    InputMap& input = TheGame::instance->m_host->m_networkMappings[m_netOwnerIndex];
-    
-    Vector2 inputDirection = input.GetVector2("Right", "Up");
+    Vector2 inputDirection = m_simulation->m_movementAxes[m_netOwnerIndex].GetVector2();
     if (this->CanMove())
     {
         Vector2 attemptedPosition = m_position + inputDirection * adjustedSpeed;
@@ -60,15 +76,27 @@ void Link::Update(float deltaSeconds)
 //-----------------------------------------------------------------------------------
 void Link::AttemptMove(Vector2& attemptedPosition)
 {
-    for (AABB2& geometry : TheGame::instance->m_host->m_levelGeometry)
+    const HostSimulation* host = m_simulation;
+    const AABB2Batch& geometryBatch = host->m_levelGeometryBatch;
+    for (unsigned int block = 0; block < geometryBatch.GetNumBlocks(); ++block)
     {
-        while (geometry.IsIntersecting(attemptedPosition, m_collisionRadius))
+        uint32_t hitMask = CollisionKernels::DiscVsAABB2Block(attemptedPosition, m_collisionRadius, geometryBatch, block);
+        while (hitMask != 0)
         {
-            AABB2 minkowskiBox = AABB2(Vector2(geometry.mins.x - m_collisionRadius, geometry.mins.y - m_collisionRadius), Vector2(geometry.maxs.x + m_collisionRadius, geometry.maxs.y + m_collisionRadius));
-            Vector2 distInside = minkowskiBox.GetSmallestResolutionVector(attemptedPosition);
-            bool xIsSmaller = abs(distInside.x) < abs(distInside.y);
-            Vector2 displacement = Vector2(xIsSmaller ? distInside.x : 0.0f, xIsSmaller ? 0.0f : distInside.y);
-            attemptedPosition += displacement;
+            unsigned int bit = CollisionKernels::FindLowestSetBit(hitMask);
+            const AABB2& geometry = host->m_levelGeometry[(block * AABB2Batch::BLOCK_SIZE) + bit];
+            while (geometry.IsIntersecting(attemptedPosition, m_collisionRadius))
+            {
+                AABB2 minkowskiBox = AABB2(Vector2(geometry.mins.x - m_collisionRadius, geometry.mins.y - m_collisionRadius), Vector2(geometry.maxs.x + m_collisionRadius, geometry.maxs.y + m_collisionRadius));
+                Vector2 distInside = minkowskiBox.GetSmallestResolutionVector(attemptedPosition);
+                bool xIsSmaller = abs(distInside.x) < abs(distInside.y);
+                Vector2 displacement = Vector2(xIsSmaller ? distInside.x : 0.0f, xIsSmaller ? 0.0f : distInside.y);
+                attemptedPosition += displacement;
+            }
+
+            //Being pushed out of one box can push us into a later one, so retest whatever is left of this block.
+            uint32_t remainingBits = (bit == 31) ? 0 : (0xFFFFFFFFu << (bit + 1));
+            hitMask = CollisionKernels::DiscVsAABB2Block(attemptedPosition, m_collisionRadius, geometryBatch, block) & remainingBits;
         }
     }
     m_position = attemptedPosition;
@@ -85,37 +113,35 @@ void Link::Render() const
 }
 
 //-----------------------------------------------------------------------------------
-void Link::ResolveCollision(Entity* otherEntity)
+void Link::UpdateSpriteFromFacing()
 {
-    Entity::ResolveCollision(otherEntity);
+    if (m_facing < NUM_DIRECTIONS)
+    {
+        m_sprite->m_spriteResource = s_facingSprites[m_facing];
+    }
 }
 
 //-----------------------------------------------------------------------------------
-void Link::UpdateSpriteFromFacing()
+//Called once the sprites are registered. Every snapshot swaps facing sprites, so that shouldn't cost a name lookup.
+void Link::ResolveSpriteResources()
 {
-    switch (m_facing)
+    for (unsigned int facing = 0; facing < NUM_DIRECTIONS; ++facing)
     {
-    case Link::WEST:
-        m_sprite->m_spriteResource = ResourceDatabase::instance->GetSpriteResource("pLeft");
-        break;
-    case Link::NORTH:
-        m_sprite->m_spriteResource = ResourceDatabase::instance->GetSpriteResource("pUp");
-        break;
-    case Link::EAST:
-        m_sprite->m_spriteResource = ResourceDatabase::instance->GetSpriteResource("pRight");
-        break;
-    case Link::SOUTH:
-        m_sprite->m_spriteResource = ResourceDatabase::instance->GetSpriteResource("pDown");
-        break;
-    default:
-        break;
+        s_facingSprites[facing] = TheGame::instance->m_spriteResources.Find(FACING_SPRITE_IDS[facing]);
+        ASSERT_OR_DIE(s_facingSprites[facing], "Facing sprites must be registered before they're resolved.");
     }
 }
 
 //-----------------------------------------------------------------------------------
 float Link::CalculateSwordRotationDegrees()
 {
-    switch (m_facing)
+    return GetSwordRotationDegrees(m_facing);
+}
+
+//-----------------------------------------------------------------------------------
+float Link::GetSwordRotationDegrees(Facing facing)
+{
+    switch (facing)
     {
     case WEST:
         return 270.0f;
@@ -133,21 +159,30 @@ float Link::CalculateSwordRotationDegrees()
 //-----------------------------------------------------------------------------------
 Vector2 Link::CalculateSwordPosition()
 {
+    AABB2 bounds = GetBounds();
     switch (m_facing)
     {
     case WEST:
-        return m_sprite->GetBounds().GetTopLeft();
+        return bounds.GetTopLeft();
     case NORTH:
-        return m_sprite->GetBounds().maxs;
+        return bounds.maxs;
     case EAST:
-        return m_sprite->GetBounds().maxs;
+        return bounds.maxs;
     case SOUTH:
-        return m_sprite->GetBounds().mins;
+        return bounds.mins;
     default:
         ERROR_AND_DIE("Invalid state for facing");
     }
 }
 
+//-----------------------------------------------------------------------------------
+//Computed from m_position alone, never the sprite. The sprite lags behind pushes and knockback and isn't part of
+//SimulationState, so bounds read from it would differ between a peer that rolled back and one that didn't.
+AABB2 Link::GetBounds() const
+{
+    return m_simulation->m_linkBounds + m_position;
+}
+
 //-----------------------------------------------------------------------------------
 Link::Facing Link::GetFacingFromInput(const Vector2& inputDirection)
 {
@@ -199,11 +234,9 @@ void Link::ApplyClientUpdate()
 void Link::ApplyDamageEffect()
 {
     const float flashSpeed = 60.0f;
-    double currentTime = GetCurrentTimeSeconds();
-    
-    if (m_timeOfLastHurt > (currentTime - HURT_FLASH_DURATION_SECONDS))
+    if (!m_clock->HasReached(m_hurtFlashEndTick))
     {
-        double colorVariation = sin(currentTime * flashSpeed);
+        double colorVariation = sin(m_clock->GetCurrentTimeSeconds() * flashSpeed);
         if (colorVariation < 0.0)
         {
             m_sprite->m_tintColor = m_color.GetInverse();
@@ -228,6 +261,6 @@ bool Link::CanMove()
 //-----------------------------------------------------------------------------------
 bool Link::IsAttacking()
 {
-    return (m_timeOfLastAttack > (GetCurrentTimeSeconds() - SWORD_STUN_DURATION_SECONDS));
+    return !m_clock->HasReached(m_attackStunEndTick);
 }
 
@@ -2,8 +2,13 @@
 #include "Game/Entities/Entity.hpp"
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Renderer/RGBA.hpp"
+#include "Engine/Renderer/AABB2.hpp"
+#include "Game/SimulationClock.hpp"
 #include <stdint.h>
 
+class HostSimulation;
+class SpriteResource;
+
 class Link : public Entity
 {
 public:
@@ -16,8 +21,10 @@ public:
         NUM_DIRECTIONS
     };
 
-    Link(const RGBA& color = RGBA::WHITE);
+    Link(const SimulationClock* clock, const RGBA& color = RGBA::WHITE);
     ~Link();
+    static void* operator new(size_t size);
+    static void operator delete(void* pointer);
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     virtual void Update(float deltaSeconds);
@@ -25,12 +32,14 @@ public:
     void AttemptMove(Vector2& attemptedPosition);
 
     virtual void Render() const;
-    virtual void ResolveCollision(Entity* otherEntity);
     inline virtual bool IsPlayer() { return true; };
 
     void UpdateSpriteFromFacing();
+    static void ResolveSpriteResources();
     float CalculateSwordRotationDegrees();
+    static float GetSwordRotationDegrees(Facing facing);
     Vector2 CalculateSwordPosition();
+    AABB2 GetBounds() const;
     Facing GetFacingFromInput(const Vector2& inputDirection);
     void SetColor(unsigned int color);
     void ApplyClientUpdate();
@@ -39,15 +48,20 @@ public:
     bool IsAttacking();
 
     //CONSTANTS/////////////////////////////////////////////////////////////////////
-    const float HURT_FLASH_DURATION_SECONDS = 0.5f;
-    const float SWORD_STUN_DURATION_SECONDS = 0.1f;
+    static const SimulationTick HURT_FLASH_DURATION_TICKS = SimulationClock::TICKS_PER_SECOND / 2;
+    static const SimulationTick SWORD_STUN_DURATION_TICKS = SimulationClock::TICKS_PER_SECOND / 10;
 
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    HostSimulation* m_simulation; //Only set on the simulating side, clients just mirror.
     uint8_t m_netOwnerIndex;
     Facing m_facing;
     float m_speed;
     float m_rateOfFire;
     RGBA m_color;
-    double m_timeOfLastHurt;
-    double m_timeOfLastAttack;
+    const SimulationClock* m_clock;
+    SimulationTick m_hurtFlashEndTick;
+    SimulationTick m_attackStunEndTick;
+
+private:
+    static const SpriteResource* s_facingSprites[NUM_DIRECTIONS];
 };
\ No newline at end of file
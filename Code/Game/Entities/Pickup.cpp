@@ -3,6 +3,9 @@
 #include "Game/TheGame.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Link.hpp"
+#include "Game/Entities/FixedBlockPool.hpp"
+
+static FixedBlockPool<Pickup, 64> s_pickupPool;
 
 //-----------------------------------------------------------------------------------
 Pickup::Pickup(const Vector2& initialPosition)
@@ -12,19 +15,19 @@ Pickup::Pickup(const Vector2& initialPosition)
     switch (m_type)
     {
     case SPEED:
-        m_sprite = new Sprite("Player", TheGame::ITEM_LAYER);
+        m_sprite = CreateSprite("Player", TheGame::ITEM_LAYER);
         break;
     case POWER:
-        m_sprite = new Sprite("Player", TheGame::ITEM_LAYER);
+        m_sprite = CreateSprite("Player", TheGame::ITEM_LAYER);
         break;
     case DEFENCE:
-        m_sprite = new Sprite("Player", TheGame::ITEM_LAYER);
+        m_sprite = CreateSprite("Player", TheGame::ITEM_LAYER);
         break;
     case FIRERATE:
-        m_sprite = new Sprite("Player", TheGame::ITEM_LAYER);
+        m_sprite = CreateSprite("Player", TheGame::ITEM_LAYER);
         break;
     case HP:
-        m_sprite = new Sprite("Player", TheGame::ITEM_LAYER);
+        m_sprite = CreateSprite("Player", TheGame::ITEM_LAYER);
         break;
     default:
         break;
@@ -35,6 +38,7 @@ Pickup::Pickup(const Vector2& initialPosition)
     float y = MathUtils::GetRandomIntFromZeroTo(2) == 1 ? MathUtils::GetRandomFloatFromZeroTo(1.0f) : -MathUtils::GetRandomFloatFromZeroTo(1.0f);
     m_sprite->m_position = initialPosition + Vector2(x, y);
     m_sprite->m_rotationDegrees = MathUtils::GetRandomFloatFromZeroTo(15.0f);
+    SetCollisionLayer(PICKUP_COLLISION);
     m_maxHp = 9999999.0f;
     m_hp = 9999999.0f;
 }
@@ -44,6 +48,18 @@ Pickup::~Pickup()
 {
 }
 
+//-----------------------------------------------------------------------------------
+void* Pickup::operator new(size_t size)
+{
+    return s_pickupPool.Allocate(size);
+}
+
+//-----------------------------------------------------------------------------------
+void Pickup::operator delete(void* pointer)
+{
+    s_pickupPool.Free(pointer);
+}
+
 //-----------------------------------------------------------------------------------
 void Pickup::Update(float deltaSeconds)
 {
@@ -58,9 +74,9 @@ void Pickup::Render() const
 }
 
 //-----------------------------------------------------------------------------------
-void Pickup::ResolveCollision(Entity* otherEntity)
+void Pickup::OnOverlap(Entity* otherEntity)
 {
-    Entity::ResolveCollision(otherEntity);
+    UNUSED(otherEntity);
 //     for (Link* ent : TheGame::instance->m_players)
 //     {
 //         if ((Entity*)ent == otherEntity)
@@ -18,10 +18,12 @@ class Pickup : public Entity
 public:
     Pickup(const Vector2& position);
     virtual ~Pickup();
+    static void* operator new(size_t size);
+    static void operator delete(void* pointer);
 
     virtual void Update(float deltaSeconds);
     virtual void Render() const;
-    virtual void ResolveCollision(Entity* otherEntity);
+    void OnOverlap(Entity* otherEntity);
 
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     PickupType m_type;
@@ -0,0 +1,114 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+//Issues 16 bit generational handles: the low bits index a slot, the high bits count how many times that slot has been reused.
+//Handles double as network IDs, so an ID that arrives after its entity was despawned fails the generation check instead of
+//resolving to whatever took the slot. Freed slots are reused oldest-first to make that aliasing as unlikely as possible.
+template <typename T>
+class SlotMap
+{
+public:
+    typedef uint16_t Handle;
+
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SlotMap()
+        : m_slots(MAX_SLOTS)
+        , m_freeHead(0)
+        , m_freeTail(MAX_SLOTS - 1)
+    {
+        for (unsigned int i = 0; i < MAX_SLOTS; ++i)
+        {
+            m_slots[i].m_item = nullptr;
+            m_slots[i].m_generation = 1;
+            m_slots[i].m_nextFree = (uint16_t)(i + 1);
+        }
+        m_slots[MAX_SLOTS - 1].m_nextFree = END_OF_LIST;
+    }
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    Handle Insert(T* item)
+    {
+        if (m_freeHead == END_OF_LIST)
+        {
+            return INVALID_HANDLE;
+        }
+        uint16_t index = m_freeHead;
+        Slot& slot = m_slots[index];
+        m_freeHead = slot.m_nextFree;
+        if (m_freeHead == END_OF_LIST)
+        {
+            m_freeTail = END_OF_LIST;
+        }
+        slot.m_item = item;
+        slot.m_nextFree = END_OF_LIST;
+        return MakeHandle(index, slot.m_generation);
+    }
+
+    //Mirrors a handle issued by another SlotMap (the host's) so lookups on this side reject the same stale IDs.
+    void InsertAt(Handle handle, T* item)
+    {
+        Slot& slot = m_slots[GetIndex(handle)];
+        slot.m_item = item;
+        slot.m_generation = GetGeneration(handle);
+    }
+
+    T* Find(Handle handle) const
+    {
+        const Slot& slot = m_slots[GetIndex(handle)];
+        return (slot.m_generation == GetGeneration(handle)) ? slot.m_item : nullptr;
+    }
+
+    void Remove(Handle handle)
+    {
+        uint16_t index = GetIndex(handle);
+        Slot& slot = m_slots[index];
+        if (!slot.m_item || slot.m_generation != GetGeneration(handle))
+        {
+            return;
+        }
+        slot.m_item = nullptr;
+        slot.m_generation = (slot.m_generation == MAX_GENERATION) ? 1 : slot.m_generation + 1;
+        if (slot.m_nextFree != END_OF_LIST || m_freeTail == index)
+        {
+            //Mirrored slots are never on the free list, only ones we issued.
+            return;
+        }
+        if (m_freeTail == END_OF_LIST)
+        {
+            m_freeHead = index;
+        }
+        else
+        {
+            m_slots[m_freeTail].m_nextFree = index;
+        }
+        m_freeTail = index;
+    }
+
+    static inline uint16_t GetIndex(Handle handle) { return handle & INDEX_MASK; };
+    static inline uint16_t GetGeneration(Handle handle) { return handle >> INDEX_BITS; };
+    static inline Handle MakeHandle(uint16_t index, uint16_t generation) { return (Handle)((generation << INDEX_BITS) | index); };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int INDEX_BITS = 10;
+    static const unsigned int MAX_SLOTS = 1 << INDEX_BITS;
+    static const uint16_t INDEX_MASK = MAX_SLOTS - 1;
+    static const uint16_t MAX_GENERATION = (1 << (16 - INDEX_BITS)) - 1;
+    static const Handle INVALID_HANDLE = 0; //Generation 0 is never issued.
+
+private:
+    static const uint16_t END_OF_LIST = 0xFFFF;
+
+    struct Slot
+    {
+        T* m_item;
+        uint16_t m_generation;
+        uint16_t m_nextFree;
+    };
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<Slot> m_slots;
+    uint16_t m_freeHead;
+    uint16_t m_freeTail;
+};
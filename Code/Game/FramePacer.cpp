@@ -0,0 +1,216 @@
+#include "Game/FramePacer.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/SimulationClock.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <math.h>
+#include <stdlib.h>
+#include <thread>
+
+const double FramePacer::LATE_SECONDS = 0.001;
+
+GameLoopPacer* GameLoopPacer::instance = nullptr;
+const float GameLoopPacer::DEFAULT_FRAMES_PER_SECOND = 120.0f;
+const float GameLoopPacer::DEFAULT_BACKGROUND_FRAMES_PER_SECOND = 15.0f;
+const double GameLoopPacer::SPIN_SECONDS = 0.001;
+
+//-----------------------------------------------------------------------------------
+void FrameTimeStats::AddFrame(double seconds)
+{
+    m_minSeconds = (m_numFrames == 0 || seconds < m_minSeconds) ? seconds : m_minSeconds;
+    m_maxSeconds = (m_numFrames == 0 || seconds > m_maxSeconds) ? seconds : m_maxSeconds;
+    m_totalSeconds += seconds;
+    m_totalSquaredSeconds += seconds * seconds;
+    ++m_numFrames;
+}
+
+//-----------------------------------------------------------------------------------
+double FrameTimeStats::GetAverageSeconds() const
+{
+    return m_numFrames > 0 ? m_totalSeconds / m_numFrames : 0.0;
+}
+
+//-----------------------------------------------------------------------------------
+//Standard deviation of the frame time.
+double FrameTimeStats::GetJitterSeconds() const
+{
+    if (m_numFrames == 0)
+    {
+        return 0.0;
+    }
+    double average = GetAverageSeconds();
+    double variance = m_totalSquaredSeconds / m_numFrames - average * average;
+    return variance > 0.0 ? sqrt(variance) : 0.0;
+}
+
+//-----------------------------------------------------------------------------------
+FramePacer::FramePacer(float framesPerSecond, double spinSeconds)
+    : m_framesPerSecond(-1.0f)
+    , m_spinSeconds(spinSeconds)
+    , m_interval(Clock::duration::zero())
+    , m_nextDeadline(Clock::now())
+    , m_lastFrame(m_nextDeadline)
+    , m_hasLastFrame(false)
+{
+    SetRate(framesPerSecond);
+}
+
+//-----------------------------------------------------------------------------------
+//Only a change of rate restarts the schedule, so this is safe to call every frame.
+void FramePacer::SetRate(float framesPerSecond)
+{
+    if (framesPerSecond == m_framesPerSecond)
+    {
+        return;
+    }
+    m_framesPerSecond = framesPerSecond;
+    m_interval = framesPerSecond > 0.0f ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / framesPerSecond)) : Clock::duration::zero();
+    Restart();
+}
+
+//-----------------------------------------------------------------------------------
+//After a pause (say, while minimized) the next frame is due straight away, and the gap stays out of the stats.
+void FramePacer::Restart()
+{
+    m_nextDeadline = Clock::now();
+    m_hasLastFrame = false;
+}
+
+//-----------------------------------------------------------------------------------
+void FramePacer::Wait() const
+{
+    WaitUntil(m_nextDeadline, m_spinSeconds);
+}
+
+//-----------------------------------------------------------------------------------
+//Called as the frame starts, to record how long the last one took and schedule the next.
+void FramePacer::BeginFrame(Clock::time_point now)
+{
+    if (m_hasLastFrame)
+    {
+        m_stats.AddFrame(std::chrono::duration<double>(now - m_lastFrame).count());
+    }
+    m_lastFrame = now;
+    m_hasLastFrame = true;
+    if (m_framesPerSecond <= 0.0f)
+    {
+        m_nextDeadline = now;
+        return;
+    }
+
+    if (std::chrono::duration<double>(now - m_nextDeadline).count() > LATE_SECONDS)
+    {
+        ++m_stats.m_numLateFrames;
+    }
+    m_nextDeadline += m_interval;
+    if (now - m_nextDeadline > m_interval * MAX_CATCH_UP_FRAMES)
+    {
+        m_nextDeadline = now + m_interval;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Sleeps can wake late by up to the OS timer period, so the last stretch is spent yielding instead.
+void FramePacer::WaitUntil(Clock::time_point deadline, double spinSeconds)
+{
+    Clock::duration spin = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(spinSeconds));
+    if (deadline - Clock::now() > spin)
+    {
+        std::this_thread::sleep_until(deadline - spin);
+    }
+    while (Clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Updates default to the simulation's own tick, since the clock only catches up a few ticks per frame.
+GameLoopPacer::GameLoopPacer()
+    : m_framesPerSecond(DEFAULT_FRAMES_PER_SECOND)
+    , m_backgroundFramesPerSecond(DEFAULT_BACKGROUND_FRAMES_PER_SECOND)
+    , m_updatesPerSecond((float)SimulationClock::TICKS_PER_SECOND)
+    , m_renderPacer(DEFAULT_FRAMES_PER_SECOND, SPIN_SECONDS)
+    , m_updatePacer((float)SimulationClock::TICKS_PER_SECOND, SPIN_SECONDS)
+{
+}
+
+//-----------------------------------------------------------------------------------
+//Sleeps until the next update or frame is due, whichever is first, and returns whether this wake should render.
+bool GameLoopPacer::WaitForNextFrame(bool isInBackground, bool isMinimized)
+{
+    m_renderPacer.SetRate(isInBackground ? m_backgroundFramesPerSecond : m_framesPerSecond);
+    m_updatePacer.SetRate(m_updatesPerSecond);
+    if (isMinimized)
+    {
+        m_renderPacer.Restart();
+    }
+
+    FramePacer::Clock::time_point deadline = m_updatePacer.GetNextDeadline();
+    if (!isMinimized && m_renderPacer.GetNextDeadline() < deadline)
+    {
+        deadline = m_renderPacer.GetNextDeadline();
+    }
+    FramePacer::WaitUntil(deadline, SPIN_SECONDS);
+
+    FramePacer::Clock::time_point now = FramePacer::Clock::now();
+    if (m_updatePacer.IsDue(now))
+    {
+        m_updatePacer.BeginFrame(now);
+    }
+    bool shouldRender = !isMinimized && m_renderPacer.IsDue(now);
+    if (shouldRender)
+    {
+        m_renderPacer.BeginFrame(now);
+    }
+    return shouldRender;
+}
+
+//-----------------------------------------------------------------------------------
+void GameLoopPacer::SetRates(float framesPerSecond, float backgroundFramesPerSecond, float updatesPerSecond)
+{
+    m_framesPerSecond = framesPerSecond;
+    m_backgroundFramesPerSecond = backgroundFramesPerSecond;
+    m_updatesPerSecond = updatesPerSecond;
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(framerate)
+{
+    GameLoopPacer* pacer = GameLoopPacer::instance;
+    if (!pacer)
+    {
+        Console::instance->PrintLine("framerate only works in the windowed game", RGBA::RED);
+        return;
+    }
+    if (!args.HasArgs(1))
+    {
+        Console::instance->PrintLine(Stringf("framerate <fps> [backgroundFps] [updateHz], 0 fps for uncapped: currently %.0f, %.0f, %.0f", pacer->m_framesPerSecond, pacer->m_backgroundFramesPerSecond, pacer->m_updatesPerSecond), RGBA::WHITE);
+        return;
+    }
+    float framesPerSecond = (float)atof(args.GetStringArgument(0).c_str());
+    float backgroundFramesPerSecond = args.HasArgs(2) ? (float)atof(args.GetStringArgument(1).c_str()) : pacer->m_backgroundFramesPerSecond;
+    float updatesPerSecond = args.HasArgs(3) ? (float)atof(args.GetStringArgument(2).c_str()) : pacer->m_updatesPerSecond;
+    if (framesPerSecond < 0.0f || backgroundFramesPerSecond < 0.0f || updatesPerSecond <= 0.0f)
+    {
+        Console::instance->PrintLine("Frame rates can't be negative, and updates need a positive rate.", RGBA::RED);
+        return;
+    }
+    pacer->SetRates(framesPerSecond, backgroundFramesPerSecond, updatesPerSecond);
+    Console::instance->PrintLine(Stringf("Rendering at %.0f fps, %.0f in the background, updating at %.0f Hz", framesPerSecond, backgroundFramesPerSecond, updatesPerSecond), RGBA::WHITE);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(framestats)
+{
+    UNUSED(args);
+    GameLoopPacer* pacer = GameLoopPacer::instance;
+    if (!pacer)
+    {
+        Console::instance->PrintLine("framestats only works in the windowed game", RGBA::RED);
+        return;
+    }
+    const FrameTimeStats& stats = pacer->GetRenderPacer().GetStats();
+    Console::instance->PrintLine(Stringf("%u frames, %.2fms average, %.3fms jitter, %.2f-%.2fms range, %u late", stats.m_numFrames, 1000.0 * stats.GetAverageSeconds(), 1000.0 * stats.GetJitterSeconds(), 1000.0 * stats.m_minSeconds, 1000.0 * stats.m_maxSeconds, stats.m_numLateFrames), RGBA::WHITE);
+    pacer->ResetStats();
+}
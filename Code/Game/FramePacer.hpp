@@ -0,0 +1,95 @@
+#pragma once
+#include <chrono>
+
+//-----------------------------------------------------------------------------------
+//Frame time spread since the last reset, for telling a steady frame rate from one that only averages out.
+struct FrameTimeStats
+{
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    FrameTimeStats() : m_numFrames(0), m_numLateFrames(0), m_totalSeconds(0.0), m_totalSquaredSeconds(0.0), m_minSeconds(0.0), m_maxSeconds(0.0) {};
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void AddFrame(double seconds);
+    double GetAverageSeconds() const;
+    double GetJitterSeconds() const;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    unsigned int m_numFrames;
+    unsigned int m_numLateFrames;
+    double m_totalSeconds;
+    double m_totalSquaredSeconds;
+    double m_minSeconds;
+    double m_maxSeconds;
+};
+
+//-----------------------------------------------------------------------------------
+//Keeps something to a fixed rate against absolute deadlines, so oversleeping one frame shortens the next wait rather
+//than drifting. Waits sleep most of the way and spin the last spinSeconds, since a sleep can overshoot by a scheduler
+//quantum. A rate of 0 is uncapped, and the deadline is always now.
+class FramePacer
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    FramePacer(float framesPerSecond, double spinSeconds);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void SetRate(float framesPerSecond);
+    void Restart();
+    void Wait() const;
+    void BeginFrame(Clock::time_point now);
+    inline bool IsDue(Clock::time_point now) const { return now >= m_nextDeadline; };
+    inline Clock::time_point GetNextDeadline() const { return m_nextDeadline; };
+    inline float GetRate() const { return m_framesPerSecond; };
+    inline const FrameTimeStats& GetStats() const { return m_stats; };
+    inline void ResetStats() { m_stats = FrameTimeStats(); };
+    static void WaitUntil(Clock::time_point deadline, double spinSeconds);
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const int MAX_CATCH_UP_FRAMES = 5; //Past this many frames behind, the schedule resets instead of bursting.
+    static const double LATE_SECONDS; //Starting this far past the deadline counts as a late frame.
+
+private:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    float m_framesPerSecond;
+    double m_spinSeconds;
+    Clock::duration m_interval;
+    Clock::time_point m_nextDeadline;
+    Clock::time_point m_lastFrame;
+    bool m_hasLastFrame;
+    FrameTimeStats m_stats;
+};
+
+//-----------------------------------------------------------------------------------
+//Paces the windowed game loop. Every wake runs input, net and simulation, at least m_updatesPerSecond times a second
+//however slowly frames are being drawn. Rendering is capped at m_framesPerSecond with focus, drops to
+//m_backgroundFramesPerSecond without it, and stops while minimized.
+class GameLoopPacer
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    GameLoopPacer();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    bool WaitForNextFrame(bool isInBackground, bool isMinimized);
+    void SetRates(float framesPerSecond, float backgroundFramesPerSecond, float updatesPerSecond);
+    inline const FramePacer& GetRenderPacer() const { return m_renderPacer; };
+    inline void ResetStats() { m_renderPacer.ResetStats(); m_updatePacer.ResetStats(); };
+
+    static GameLoopPacer* instance;
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const float DEFAULT_FRAMES_PER_SECOND;
+    static const float DEFAULT_BACKGROUND_FRAMES_PER_SECOND;
+    static const double SPIN_SECONDS; //A 1ms timer period's worth of oversleep. Every bit more is CPU burned per frame.
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    float m_framesPerSecond;
+    float m_backgroundFramesPerSecond;
+    float m_updatesPerSecond;
+
+private:
+    FramePacer m_renderPacer;
+    FramePacer m_updatePacer;
+};
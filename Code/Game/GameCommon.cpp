@@ -1,4 +1,4 @@
-#include "Game\GameCommon.hpp"
+#include "Game/GameCommon.hpp"
 
 int g_frameNumber = 0;
 bool g_renderDebug = true;
@@ -11,18 +11,73 @@
 #include "Engine/Net/UDPIP/NetSession.hpp"
 #include "Engine/Renderer/2D/ResourceDatabase.hpp"
 #include "Engine/Input/InputOutputUtils.hpp"
-#include "Engine/Time/Time.hpp"
+#include "Game/Jobs/JobSystem.hpp"
+#include "Game/MessageFragmenter.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <algorithm>
+#include <string.h>
+
+//Covers the walkable part of the level, anyone outside it just lands in the edge cells.
+static const AABB2 WALKABLE_BOUNDS = AABB2(Vector2(-15.0f, -8.0f), Vector2(15.0f, 8.0f));
+static const float DEFENDER_GRID_CELL_SIZE = 2.0f;
+static const float NAVIGATION_CELL_SIZE = 0.5f;
+static const float NAVIGATION_CLEARANCE_RADIUS = 0.3f; //Link's collision radius.
+
+//Fixed chunk sizes keep the work split, and so the results, independent of the thread count.
+static const unsigned int ENTITY_UPDATE_CHUNK_SIZE = 32;
+static const unsigned int PAIR_SEARCH_CHUNK_SIZE = 32;
+static const unsigned int PAIR_RESOLVE_CHUNK_SIZE = 64;
+
+static const unsigned int LINK_SNAPSHOT_BYTES = sizeof(uint16_t) + sizeof(Vector2) + sizeof(Link::Facing) + sizeof(float);
+//Format, sequence, baseline sequence, has baseline, piece index, piece count, link count and byte count.
+static const unsigned int CODED_PIECE_HEADER_BYTES = 11;
+static const unsigned int RANGE_CODER_FLUSH_BYTES = 5; //Finish() can spill a few bytes past the links' own worst case.
+
+bool HostSimulation::s_isSnapshotCodingEnabled = true;
+FILE* HostSimulation::s_snapshotRecording = nullptr;
 
 //-----------------------------------------------------------------------------------
-HostSimulation::HostSimulation()
+template <typename Function>
+static void RunParallel(unsigned int count, unsigned int chunkSize, Function& function)
+{
+    if (JobSystem::instance)
+    {
+        JobSystem::instance->ParallelFor(count, chunkSize, function);
+    }
+    else
+    {
+        function(0, count);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+HostSimulation::HostSimulation(Mode mode, uint32_t connectionMask)
+    : m_mode(mode)
+    , m_connectionMask(connectionMask)
+    , m_playerLimit(MAX_PLAYERS)
+    , m_defenderGrid(WALKABLE_BOUNDS, DEFENDER_GRID_CELL_SIZE)
+    , m_navigationGrid(WALKABLE_BOUNDS, NAVIGATION_CELL_SIZE)
+    , m_bots(m_navigationGrid)
 {
     InitializeKeyMappings();
-    m_players.reserve(8);
-    for (unsigned int i = 0; i < 8; ++i)
+    static_assert(MAX_PLAYERS <= 32, "The connection mask needs a bit for every player.");
+    static_assert(MAX_PLAYERS <= SnapshotFrame::MAX_SLOTS, "Snapshot frames need a slot for every player.");
+    m_snapshotHistories.resize(MAX_PLAYERS);
+    m_players.reserve(MAX_PLAYERS);
+    for (unsigned int i = 0; i < MAX_PLAYERS; ++i)
     {
         m_players.push_back(nullptr);
+        m_playerColors[i] = 0;
+        m_isInMatch[i] = false;
+        m_inputSequences[i] = 0;
+        m_hasInputSequence[i] = false;
     }
     InitializeLevelGeometry();
+    InitializeHitboxes();
+    m_navigationGrid.MarkBlockedCells(m_levelGeometry, NAVIGATION_CLEARANCE_RADIUS);
 }
 
 //-----------------------------------------------------------------------------------
@@ -34,18 +89,50 @@ HostSimulation::~HostSimulation()
         delete ent;
     }
     m_entities.clear();
+    for (Entity* ent : m_despawnedEntities)
+    {
+        delete ent;
+    }
+    m_despawnedEntities.clear();
     m_players.clear();
 }
 
 //-----------------------------------------------------------------------------------
+//Clients only send when their input changes and on a slow keepalive, so whatever arrived last holds until the next.
+//Updates are unreliable, and the sequence keeps a late copy of an older one from undoing a newer change.
 void HostSimulation::OnUpdateFromClientReceived(const NetSender& from, NetMessage& message)
 {
-    Vector2 rightValues;
-    Vector2 upValues;
-    message.Read<Vector2>(rightValues);
-    message.Read<Vector2>(upValues);
-    m_networkMappings[from.connection->m_index].FindInputAxis("Right")->SetValue(rightValues.x, rightValues.y);
-    m_networkMappings[from.connection->m_index].FindInputAxis("Up")->SetValue(upValues.x, upValues.y);
+    uint8_t index = from.connection->m_index;
+    uint8_t sequence = 0;
+    uint8_t header = 0;
+    message.Read<uint8_t>(sequence);
+    message.Read<uint8_t>(header);
+    MovementInput input;
+    input.m_buttons = header & PlayerInput::MOVEMENT_BUTTONS;
+    input.m_isAnalog = (header & ANALOG_INPUT_FLAG) != 0;
+    if (input.m_isAnalog)
+    {
+        message.Read<int8_t>(input.m_right);
+        message.Read<int8_t>(input.m_up);
+    }
+    if (header & SNAPSHOT_ACK_FLAG)
+    {
+        uint16_t ackedSequence = 0;
+        message.Read<uint16_t>(ackedSequence);
+        m_snapshotHistories[index].Acknowledge(ackedSequence);
+    }
+
+    if (m_hasInputSequence[index] && (int8_t)(sequence - m_inputSequences[index]) <= 0)
+    {
+        return;
+    }
+    m_inputSequences[index] = sequence;
+    m_hasInputSequence[index] = true;
+    if (input != m_networkInputs[index])
+    {
+        m_networkInputs[index] = input;
+        input.ApplyToMovementAxes(m_movementAxes[index]);
+    }
 }
 
 //-----------------------------------------------------------------------------------
@@ -53,8 +140,13 @@ void HostSimulation::OnConnectionJoined(NetConnection* cp)
 {
     uint8_t index = cp->m_index;
     bool isRequest = false;
+    m_bots.RemoveBot(*this, index);
+    m_bots.RemoveBotsOverLimit(*this);
     m_playerColors[index] = RGBA::GetRandom().ToUnsignedInt();
-    BroadcastLinkCreation(index, m_playerColors[index]);
+    m_snapshotHistories[index].Reset();
+    m_networkInputs[index] = MovementInput();
+    m_networkInputs[index].ApplyToMovementAxes(m_movementAxes[index]);
+    m_hasInputSequence[index] = false;
 
     //Bring the client up to speed.
     for (Link* link : m_players)
@@ -65,82 +157,85 @@ void HostSimulation::OnConnectionJoined(NetConnection* cp)
             message.Write<bool>(isRequest);
             message.Write<uint8_t>(link->m_netOwnerIndex);
             message.Write<unsigned int>(link->m_color.ToUnsignedInt());
+            message.Write<uint16_t>(link->m_networkId);
             cp->SendMessage(message);
         }
     }
+
+    BroadcastLinkCreation(index, m_playerColors[index]);
 }
 
 //-----------------------------------------------------------------------------------
 void HostSimulation::BroadcastLinkCreation(uint8_t index, unsigned int playerColor)
 {
     bool isRequest = false;
-
-    //Let everyone know about the guy we just created (Including ourselves!).
-    for (NetConnection* conn : NetSession::instance->m_allConnections)
+    if (m_players[index])
     {
-        if (conn)
-        {
-            NetMessage message(GameNetMessages::PLAYER_CREATE);
-            message.Write<bool>(isRequest);
-            message.Write<uint8_t>(index);
-            message.Write<unsigned int>(playerColor);
-            conn->SendMessage(message);
-        }
+        //Already alive, most likely a doubled up respawn request.
+        return;
     }
+    Link* player = SpawnLink(index, playerColor);
+    if (!player || !IsBroadcasting())
+    {
+        return;
+    }
+
+    //Let everyone know about the guy we just created (Including ourselves!).
+    NetMessage message(GameNetMessages::PLAYER_CREATE);
+    message.Write<bool>(isRequest);
+    message.Write<uint8_t>(index);
+    message.Write<unsigned int>(playerColor);
+    message.Write<uint16_t>(player->m_networkId);
+    Broadcast(message);
 }
 
 //-----------------------------------------------------------------------------------
-void HostSimulation::OnConnectionLeave(NetConnection* cp)
+//Returns null if the handle table is full, since a Link without a network ID can't be told apart on the wire.
+Link* HostSimulation::SpawnLink(uint8_t index, unsigned int playerColor)
 {
-    //Let everyone know about the guy who just disconnected (Including ourselves!).
-    for (NetConnection* conn : NetSession::instance->m_allConnections)
+    Link* player = new Link(&m_clock);
+    player->m_networkId = m_entityHandles.Insert(player);
+    if (player->m_networkId == SlotMap<Entity>::INVALID_HANDLE)
     {
-        if (conn)
-        {
-            NetMessage message(GameNetMessages::PLAYER_DESTROY);
-            message.Write<uint8_t>(cp->m_index);
-            conn->SendMessage(message);
-        }
+        ERROR_RECOVERABLE("Ran out of entity handles, refusing to spawn a player.");
+        delete player;
+        return nullptr;
     }
+    player->m_simulation = this;
+    player->m_netOwnerIndex = index;
+    player->SetColor(playerColor);
+    player->m_sprite->Disable();
+    m_players[index] = player;
+    m_entities.push_back(player);
+    return player;
 }
 
 //-----------------------------------------------------------------------------------
-void HostSimulation::OnPlayerDestroy(const NetSender&, NetMessage message)
+void HostSimulation::OnConnectionLeave(NetConnection* cp)
 {
-    uint8_t index = NetSession::INVALID_CONNECTION_INDEX;
-    message.Read<uint8_t>(index);
-
-    //Entity cleanup will delete the player within the next frame.
-    if (m_players[index])
+    //Entity cleanup despawns the player at the end of the tick and lets everyone know (Including ourselves!).
+    if (m_players[cp->m_index])
     {
-        m_players[index]->m_isDead = true;
-        m_players[index] = nullptr;
+        m_players[cp->m_index]->m_isDead = true;
     }
 }
 
 //-----------------------------------------------------------------------------------
 void HostSimulation::OnPlayerCreate(const NetSender&, NetMessage message)
 {
-    Link* player = new Link();
     unsigned int color = 0;
     bool isRequest = false;
+    uint8_t index = NetSession::INVALID_CONNECTION_INDEX;
 
     //Read the link data
     message.Read<bool>(isRequest);
-    message.Read<uint8_t>(player->m_netOwnerIndex);
+    message.Read<uint8_t>(index);
     message.Read<unsigned int>(color);
 
+    //Links are spawned as they're broadcast, so our own echo of the broadcast has nothing left to do.
     if (isRequest)
     {
-        BroadcastLinkCreation(player->m_netOwnerIndex, color);
-        delete player;
-    }
-    else
-    {
-        player->SetColor(color);
-        player->m_sprite->Disable();
-        m_players[player->m_netOwnerIndex] = player;
-        m_entities.push_back(player);
+        BroadcastLinkCreation(index, color);
     }
 }
 
@@ -148,46 +243,65 @@ void HostSimulation::OnPlayerCreate(const NetSender&, NetMessage message)
 void HostSimulation::OnPlayerAttack(const NetSender& from, NetMessage message)
 {
     bool wasSentARequest = false;
-    uint8_t index = from.connection->m_index;
     message.Read<bool>(wasSentARequest);
 
     if (wasSentARequest)
     {
-        Link* attackingPlayer = m_players[index];
-        if (!attackingPlayer)
-        {
-            return;
-        }
-        Vector2 swordPosition = attackingPlayer->CalculateSwordPosition();
-        float swordRotation = attackingPlayer->CalculateSwordRotationDegrees();
-        attackingPlayer->m_timeOfLastAttack = GetCurrentTimeSeconds();
+        PerformAttack(from.connection->m_index);
+    }
+}
 
-        for (NetConnection* conn : NetSession::instance->m_allConnections)
-        {
-            if (conn)
-            {
-                bool isRequest = false;
-                NetMessage attackMessage(GameNetMessages::PLAYER_ATTACK);
-                attackMessage.Write<bool>(isRequest);
-                attackMessage.Write<uint8_t>(index);
-                attackMessage.Write<Vector2>(swordPosition);
-                attackMessage.Write<float>(swordRotation);
-                conn->SendMessage(attackMessage);
-            }
-        }
+//-----------------------------------------------------------------------------------
+void HostSimulation::PerformAttack(uint8_t index)
+{
+    Link* attackingPlayer = m_players[index];
+    if (!attackingPlayer)
+    {
+        return;
+    }
+    Vector2 swordPosition = attackingPlayer->CalculateSwordPosition();
+    float swordRotation = attackingPlayer->CalculateSwordRotationDegrees();
+    attackingPlayer->m_attackStunEndTick = m_clock.GetDeadline(Link::SWORD_STUN_DURATION_TICKS);
 
-        CheckForAndBroadcastDamage(attackingPlayer, swordPosition);
+    if (IsBroadcasting())
+    {
+        bool isRequest = false;
+        NetMessage attackMessage(GameNetMessages::PLAYER_ATTACK);
+        attackMessage.Write<bool>(isRequest);
+        attackMessage.Write<uint8_t>(index);
+        attackMessage.Write<Vector2>(swordPosition);
+        attackMessage.Write<float>(swordRotation);
+        Broadcast(attackMessage);
+    }
+
+    CheckForAndBroadcastDamage(attackingPlayer, swordPosition);
+}
+
+//-----------------------------------------------------------------------------------
+//Rollback mode feeds every player's input in here before each Step(), in place of the client messages.
+void HostSimulation::ApplyPlayerInput(uint8_t index, const PlayerInput& input, const PlayerInput& previousInput)
+{
+    input.ApplyToMovementAxes(m_movementAxes[index]);
+    Link* player = m_players[index];
+    if (player && !player->IsAttacking() && input.WasJustPressed(PlayerInput::ATTACK, previousInput))
+    {
+        PerformAttack(index);
+    }
+    else if (!player && m_isInMatch[index] && input.WasJustPressed(PlayerInput::RESPAWN, previousInput))
+    {
+        SpawnLink(index, m_playerColors[index]);
     }
 }
 
 //-----------------------------------------------------------------------------------
 void HostSimulation::CheckForAndBroadcastDamage(Link* attackingPlayer, const Vector2& swordPosition)
 {
-    AABB2 swordBoundingBox = ResourceDatabase::instance->GetSpriteResource("swordSwing")->GetDefaultBounds();
-    swordBoundingBox += swordPosition;
-    for (Link* player : m_players)
+    AABB2 swordBoundingBox = m_swordHitboxes[attackingPlayer->m_facing] + swordPosition;
+    m_defenderGrid.Query(swordBoundingBox, m_defenderCandidates);
+    for (Link* player : m_defenderCandidates)
     {
-        if (player && player != attackingPlayer && swordBoundingBox.IsIntersecting(player->m_sprite->GetBounds()))
+        //Earlier hits this tick may have knocked the candidate out of the way, so check where they are now.
+        if (player != attackingPlayer && !player->m_isDead && swordBoundingBox.IsIntersecting(player->GetBounds()))
         {
             //Update the damaged player
             Vector2 fromAttackerToDefender = player->m_position - attackingPlayer->m_position;
@@ -196,29 +310,25 @@ void HostSimulation::CheckForAndBroadcastDamage(Link* attackingPlayer, const Vec
             float distFromSwordToDefender = MathUtils::CalcDistanceBetweenPoints(swordPosition, attackingPlayer->m_position);
             player->m_position += fromAttackerToDefender * (distFromSwordToDefender / distFromAttackerToDefender);
             player->m_hp -= 1.0f;
+            if (player->m_hp <= 0.0f)
+            {
+                player->m_isDead = true;
+            }
+
+            if (!IsBroadcasting())
+            {
+                continue;
+            }
 
             //Create messages
             NetMessage attack(GameNetMessages::PLAYER_DAMAGED);
             attack.Write<uint8_t>(player->m_netOwnerIndex);
-            NetMessage died(GameNetMessages::PLAYER_DESTROY);
-            died.Write<uint8_t>(player->m_netOwnerIndex);
             NetMessage update(GameNetMessages::HOST_TO_CLIENT_UPDATE);
-            update.Write<Vector2>(player->m_position);
-            update.Write<Link::Facing>(player->m_facing);
-
-
-            for (NetConnection* conn : NetSession::instance->m_allConnections)
-            {
-                if (conn)
-                {
-                    conn->SendMessage(attack);
-                    conn->SendMessage(update);
-                    if (player->m_hp <= 0.0f)
-                    {
-                        conn->SendMessage(died);
-                    }
-                }
-            }
+            update.Write<uint8_t>(PLAIN_SNAPSHOT);
+            update.Write<uint8_t>(1);
+            WriteLinkSnapshot(update, player);
+            Broadcast(attack);
+            Broadcast(update);
 
         }
     }
@@ -233,58 +343,321 @@ void HostSimulation::OnPlayerFireBow(const NetSender& from, NetMessage& message)
 //-----------------------------------------------------------------------------------
 void HostSimulation::SendNetHostUpdate(NetConnection* cp)
 {
-    NetMessage update(GameNetMessages::HOST_TO_CLIENT_UPDATE);
-    for (Link* link : m_players)
+    if (s_isSnapshotCodingEnabled)
     {
+        SendCodedSnapshot(cp);
+    }
+    else
+    {
+        SendPlainSnapshot(cp);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Snapshots are unreliable, so rather than one message that IP would fragment (and lose whole to any missing piece), the
+//links are split over as many messages as it takes to keep each under the MTU. Every piece carries its own count and
+//full records, so the client applies whichever pieces arrive and only the lost links wait for the next tick.
+void HostSimulation::SendPlainSnapshot(NetConnection* cp)
+{
+    unsigned int linksPerMessage = (MessageFragmenter::GetMaxMessageBytes() - 2 * sizeof(uint8_t)) / LINK_SNAPSHOT_BYTES;
+    unsigned int playerIndex = 0;
+    while (playerIndex < MAX_PLAYERS)
+    {
+        const Link* batch[MAX_PLAYERS];
+        uint8_t numLinks = 0;
+        for (; playerIndex < MAX_PLAYERS && numLinks < linksPerMessage; ++playerIndex)
+        {
+            if (m_players[playerIndex])
+            {
+                batch[numLinks++] = m_players[playerIndex];
+            }
+        }
+        if (numLinks == 0)
+        {
+            break;
+        }
+
+        NetMessage update(GameNetMessages::HOST_TO_CLIENT_UPDATE);
+        update.Write<uint8_t>(PLAIN_SNAPSHOT);
+        update.Write<uint8_t>(numLinks);
+        for (unsigned int i = 0; i < numLinks; ++i)
+        {
+            WriteLinkSnapshot(update, batch[i]);
+        }
+        cp->SendMessage(update);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Quantizes every link and entropy codes it against the last snapshot this client acknowledged, or from scratch if it
+//hasn't acknowledged one recently. Pieces split the same way plain snapshots do, and each decodes on its own.
+//An empty snapshot still goes out as one piece, so the client has something to acknowledge.
+void HostSimulation::SendCodedSnapshot(NetConnection* cp)
+{
+    SnapshotSendHistory& history = m_snapshotHistories[cp->m_index];
+    SnapshotFrame& frame = history.BeginFrame();
+    SnapshotLink links[MAX_PLAYERS];
+    unsigned int numLinks = 0;
+    for (unsigned int playerIndex = 0; playerIndex < MAX_PLAYERS; ++playerIndex)
+    {
+        const Link* link = m_players[playerIndex];
         if (link)
         {
-            update.Write<Vector2>(link->m_position);
-            update.Write<Link::Facing>(link->m_facing);
-            update.Write<float>(link->m_hp);
+            SnapshotLink& snapshotLink = links[numLinks++];
+            snapshotLink.m_slot = (uint8_t)playerIndex;
+            snapshotLink.m_record = SnapshotCodec::Quantize(link->m_networkId, link->m_position.x, link->m_position.y, (uint8_t)link->m_facing, link->m_hp);
+            frame.SetSlot(playerIndex, snapshotLink.m_record);
         }
     }
-    cp->SendMessage(update);
 
-//         unsigned int* numEntities = update.Reserve<unsigned int>(m_entities.size());
-//         for (Entity* entity : m_entities)
-//         {
-//             if (entity->IsPlayer())
-//             {
-//                 ByteSwap<unsigned int>(numEntities, sizeof(unsigned int));
-//                 *numEntities -= 1;
-//                 ByteSwap<unsigned int>(numEntities, sizeof(unsigned int));
-//                 continue;
-//             }
-//             update.Write<uint16_t>(entity->m_networkId);
-//             update.Write<Vector2>(entity->m_position);
-//             update.Write<float>(entity->m_rotationDegrees);
-//         }
+    const SnapshotFrame* baseline = history.GetBaseline(frame.m_sequence);
+    const SnapshotFrame& codingBaseline = baseline ? *baseline : SnapshotFrame::EMPTY;
+    unsigned int maxCodedBytes = MessageFragmenter::GetMaxMessageBytes() - CODED_PIECE_HEADER_BYTES;
+    unsigned int linksPerPiece = (maxCodedBytes - RANGE_CODER_FLUSH_BYTES) / SnapshotCodec::MAX_CODED_LINK_BYTES;
+    unsigned int numPieces = numLinks == 0 ? 1 : (numLinks + linksPerPiece - 1) / linksPerPiece;
+
+    uint8_t coded[MessageFragmenter::MAX_MTU_BYTES];
+    for (unsigned int pieceIndex = 0; pieceIndex < numPieces; ++pieceIndex)
+    {
+        unsigned int firstLink = pieceIndex * linksPerPiece;
+        unsigned int numPieceLinks = std::min(linksPerPiece, numLinks - firstLink);
+        unsigned int codedSize = 0;
+        bool didFit = SnapshotCodec::GetTrained().Encode(codingBaseline, &links[firstLink], numPieceLinks, coded, maxCodedBytes, codedSize);
+        ASSERT_OR_DIE(didFit, "Snapshot piece overran its worst case size.");
+        if (s_snapshotRecording)
+        {
+            SnapshotCodec::WriteRecording(s_snapshotRecording, codingBaseline, &links[firstLink], numPieceLinks);
+        }
+
+        NetMessage update(GameNetMessages::HOST_TO_CLIENT_UPDATE);
+        update.Write<uint8_t>(CODED_SNAPSHOT);
+        update.Write<uint16_t>(frame.m_sequence);
+        update.Write<uint16_t>(codingBaseline.m_sequence);
+        update.Write<bool>(baseline != nullptr);
+        update.Write<uint8_t>((uint8_t)pieceIndex);
+        update.Write<uint8_t>((uint8_t)numPieces);
+        update.Write<uint8_t>((uint8_t)numPieceLinks);
+        update.Write<uint16_t>((uint16_t)codedSize);
+        for (unsigned int i = 0; i < codedSize; ++i)
+        {
+            update.Write<uint8_t>(coded[i]);
+        }
+        cp->SendMessage(update);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void HostSimulation::WriteLinkSnapshot(NetMessage& message, const Link* link)
+{
+    message.Write<uint16_t>(link->m_networkId);
+    message.Write<Vector2>(link->m_position);
+    message.Write<Link::Facing>(link->m_facing);
+    message.Write<float>(link->m_hp);
 }
 
 //-----------------------------------------------------------------------------------
 void HostSimulation::Update(float deltaSeconds)
 {
-    UpdateEntities(deltaSeconds);
+    Simulate(deltaSeconds);
+    FinishUpdate();
+}
+
+//-----------------------------------------------------------------------------------
+//Touches nothing outside this simulation, so separate matches can run it at the same time. Whatever it would send,
+//spawn or free waits for FinishUpdate(), back on the thread that owns the session.
+void HostSimulation::Simulate(float deltaSeconds)
+{
+    //Gameplay always steps at the fixed tick rate, however fast frames are coming in.
+    unsigned int numTicks = m_clock.Advance(deltaSeconds);
+    for (unsigned int i = 0; i < numTicks; ++i)
+    {
+        Step();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void HostSimulation::Step()
+{
+    m_bots.Update(*this);
+    UpdateEntities(SimulationClock::SECONDS_PER_TICK);
     AddNewEntities();
     CleanUpDeadEntities();
+    if (m_mode == ROLLBACK_MODE)
+    {
+        SortEntitiesCanonically();
+    }
+    m_clock.Tick();
 }
 
 //-----------------------------------------------------------------------------------
 void HostSimulation::UpdateEntities(float deltaSeconds)
 {
+    //Phase one: every entity integrates on its own, touching nothing but itself.
+    auto integrateEntities = [this, deltaSeconds](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            m_entities[i]->Update(deltaSeconds);
+        }
+    };
+    RunParallel((unsigned int)m_entities.size(), ENTITY_UPDATE_CHUNK_SIZE, integrateEntities);
+
+    //Phase two: find every touching pair, then resolve them in batches that never share an entity.
+    PackColliders();
+    FindCollidingPairs();
+    ResolveCollidingPairs();
+
+    RebuildDefenderGrid();
+}
+
+//-----------------------------------------------------------------------------------
+void HostSimulation::PackColliders()
+{
+    //Every live collider goes into its layer's batch, so whole layers a collider ignores are never tested at all.
+    //m_colliders holds the same entities layer by layer, giving each one a single index for the pair lists.
+    unsigned int layerCounts[NUM_COLLISION_LAYERS] = { 0 };
+    for (unsigned int layer = 0; layer < NUM_COLLISION_LAYERS; ++layer)
+    {
+        m_layerDiscs[layer].Clear();
+    }
     for (Entity* ent : m_entities)
     {
-        ent->Update(deltaSeconds);
-        for (Entity* other : m_entities)
+        if (!ent->m_isDead)
         {
-            if ((ent != other) && (ent->IsCollidingWith(other)))
+            ++layerCounts[ent->m_collisionLayer];
+        }
+    }
+    m_layerStarts[0] = 0;
+    for (unsigned int layer = 0; layer < NUM_COLLISION_LAYERS; ++layer)
+    {
+        m_layerStarts[layer + 1] = m_layerStarts[layer] + layerCounts[layer];
+    }
+    m_colliders.resize(m_layerStarts[NUM_COLLISION_LAYERS]);
+    for (Entity* ent : m_entities)
+    {
+        if (!ent->m_isDead)
+        {
+            DiscBatch& discs = m_layerDiscs[ent->m_collisionLayer];
+            m_colliders[m_layerStarts[ent->m_collisionLayer] + discs.GetCount()] = ent;
+            discs.Add(ent->m_position, ent->m_collisionRadius);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void HostSimulation::FindCollidingPairs()
+{
+    unsigned int numColliders = (unsigned int)m_colliders.size();
+    unsigned int numChunks = (numColliders + PAIR_SEARCH_CHUNK_SIZE - 1) / PAIR_SEARCH_CHUNK_SIZE;
+    if (m_pairChunks.size() < numChunks)
+    {
+        m_pairChunks.resize(numChunks);
+    }
+
+    //Each pair is found once, from the side with the lower layer (or lower index within a layer).
+    auto findPairs = [this](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int colliderIndex = begin; colliderIndex < end; ++colliderIndex)
+        {
+            std::vector<ColliderPair>& pairs = m_pairChunks[colliderIndex / PAIR_SEARCH_CHUNK_SIZE];
+            if (colliderIndex % PAIR_SEARCH_CHUNK_SIZE == 0)
             {
-                ent->ResolveCollision(other);
+                pairs.clear();
+            }
+            Entity* ent = m_colliders[colliderIndex];
+            unsigned int layer = ent->m_collisionLayer;
+            unsigned int entityIndex = colliderIndex - m_layerStarts[layer];
+            for (unsigned int otherLayer = layer; otherLayer < NUM_COLLISION_LAYERS; ++otherLayer)
+            {
+                if (GetCollisionResponse((CollisionLayer)layer, (CollisionLayer)otherLayer) == IGNORE_COLLISION
+                    || !(ent->m_collisionMask & GetCollisionLayerBit((CollisionLayer)otherLayer)))
+                {
+                    continue;
+                }
+                const DiscBatch& otherDiscs = m_layerDiscs[otherLayer];
+                unsigned int firstBlock = (otherLayer == layer) ? entityIndex / DiscBatch::BLOCK_SIZE : 0;
+                for (unsigned int block = firstBlock; block < otherDiscs.GetNumBlocks(); ++block)
+                {
+                    uint32_t hitMask = CollisionKernels::DiscVsDiscBlock(ent->m_position, ent->m_collisionRadius, otherDiscs, block);
+                    for (; hitMask != 0; hitMask &= hitMask - 1)
+                    {
+                        unsigned int otherIndex = (block * DiscBatch::BLOCK_SIZE) + CollisionKernels::FindLowestSetBit(hitMask);
+                        if (otherLayer == layer && otherIndex <= entityIndex)
+                        {
+                            continue;
+                        }
+                        unsigned int otherColliderIndex = m_layerStarts[otherLayer] + otherIndex;
+                        if (m_colliders[otherColliderIndex]->m_collisionMask & GetCollisionLayerBit((CollisionLayer)layer))
+                        {
+                            pairs.push_back({ colliderIndex, otherColliderIndex });
+                        }
+                    }
+                }
+            }
+        }
+    };
+    RunParallel(numColliders, PAIR_SEARCH_CHUNK_SIZE, findPairs);
+
+    //Merge in chunk order so the pair list comes out the same whatever the thread count. Overlaps are only recorded.
+    m_overlaps.clear();
+    m_contactPairs.clear();
+    for (unsigned int chunk = 0; chunk < numChunks; ++chunk)
+    {
+        for (const ColliderPair& pair : m_pairChunks[chunk])
+        {
+            Entity* first = m_colliders[pair.m_first];
+            Entity* second = m_colliders[pair.m_second];
+            if (GetCollisionResponse(first->m_collisionLayer, second->m_collisionLayer) == OVERLAP_COLLISION)
+            {
+                m_overlaps.push_back({ first, second });
+            }
+            else
+            {
+                m_contactPairs.push_back(pair);
             }
         }
     }
 }
 
+//-----------------------------------------------------------------------------------
+void HostSimulation::ResolveCollidingPairs()
+{
+    m_pairBatcher.Build(m_contactPairs, (unsigned int)m_colliders.size());
+    for (unsigned int batchIndex = 0; batchIndex < m_pairBatcher.GetNumBatches(); ++batchIndex)
+    {
+        const unsigned int* batch = m_pairBatcher.GetBatch(batchIndex);
+        auto resolvePairs = [this, batch](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                const ColliderPair& pair = m_contactPairs[batch[i]];
+                CollisionResolver::Resolve(m_colliders[pair.m_first], m_colliders[pair.m_second]);
+            }
+        };
+        if (m_pairBatcher.IsSerialBatch(batchIndex))
+        {
+            resolvePairs(0, m_pairBatcher.GetBatchSize(batchIndex));
+        }
+        else
+        {
+            RunParallel(m_pairBatcher.GetBatchSize(batchIndex), PAIR_RESOLVE_CHUNK_SIZE, resolvePairs);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void HostSimulation::RebuildDefenderGrid()
+{
+    m_defenderGrid.Clear();
+    for (Link* player : m_players)
+    {
+        if (player && !player->m_isDead)
+        {
+            m_defenderGrid.Insert(player, player->GetBounds());
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------------
 void HostSimulation::AddNewEntities()
 {
@@ -298,17 +671,82 @@ void HostSimulation::AddNewEntities()
 //-----------------------------------------------------------------------------------
 void HostSimulation::CleanUpDeadEntities()
 {
-    for (auto iter = m_entities.begin(); iter != m_entities.end(); ++iter)
+    //Single pass, swapping the last live entity into each dead one's spot, so a mass death is O(n) instead of O(n^2).
+    unsigned int index = 0;
+    while (index < m_entities.size())
     {
-        Entity* gameObject = *iter;
-        if (gameObject->m_isDead)
+        Entity* gameObject = m_entities[index];
+        if (!gameObject->m_isDead)
+        {
+            ++index;
+            continue;
+        }
+
+        if (gameObject->IsPlayer())
+        {
+            Link* player = static_cast<Link*>(gameObject);
+            if (m_players[player->m_netOwnerIndex] == player)
+            {
+                m_players[player->m_netOwnerIndex] = nullptr;
+            }
+        }
+        m_entityHandles.Remove(gameObject->m_networkId);
+        if (IsBroadcasting())
+        {
+            m_pendingDespawns.push_back(gameObject->m_networkId);
+            m_despawnedEntities.push_back(gameObject);
+        }
+        else
         {
             delete gameObject;
-            iter = m_entities.erase(iter);
         }
-        if (iter == m_entities.end())
+
+        m_entities[index] = m_entities.back();
+        m_entities.pop_back();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//The serial half of an update: everything the ticks left for the session's thread, despawns first so a bot's respawn
+//never goes out ahead of its old Link's removal.
+void HostSimulation::FinishUpdate()
+{
+    BroadcastDespawns();
+    m_bots.ApplyQueuedActions(*this);
+}
+
+//-----------------------------------------------------------------------------------
+void HostSimulation::BroadcastDespawns()
+{
+    for (Entity* entity : m_despawnedEntities)
+    {
+        delete entity;
+    }
+    m_despawnedEntities.clear();
+    if (m_pendingDespawns.empty())
+    {
+        return;
+    }
+
+    //Everything that died since the last update goes out together (Including to ourselves!).
+    NetMessage despawns(GameNetMessages::ENTITY_DESPAWN_BATCH);
+    despawns.Write<uint16_t>((uint16_t)m_pendingDespawns.size());
+    for (uint16_t networkId : m_pendingDespawns)
+    {
+        despawns.Write<uint16_t>(networkId);
+    }
+    Broadcast(despawns);
+    m_pendingDespawns.clear();
+}
+
+//-----------------------------------------------------------------------------------
+void HostSimulation::Broadcast(NetMessage& message) const
+{
+    for (NetConnection* conn : NetSession::instance->m_allConnections)
+    {
+        if (conn && (m_connectionMask & (1u << conn->m_index)))
         {
-            break;
+            conn->SendMessage(message);
         }
     }
 }
@@ -316,27 +754,30 @@ void HostSimulation::CleanUpDeadEntities()
 //-----------------------------------------------------------------------------------
 void HostSimulation::InitializeKeyMappings()
 {
-    m_networkMappings.resize(8);
-    for (unsigned int i = 0; i < 8; ++i)
+    m_networkMappings.resize(MAX_PLAYERS);
+    m_movementAxes.resize(MAX_PLAYERS);
+    for (unsigned int i = 0; i < MAX_PLAYERS; ++i)
     {
         m_networkMappings[i].AddInputAxis("Up", new InputValue(&m_networkMappings[i]), new InputValue(&m_networkMappings[i]));
         m_networkMappings[i].AddInputAxis("Right", new InputValue(&m_networkMappings[i]), new InputValue(&m_networkMappings[i]));
+        m_movementAxes[i].Resolve(m_networkMappings[i]);
     }
 }
 
 //-----------------------------------------------------------------------------------
 void HostSimulation::UninitializeKeyMappings()
 {
-    for (unsigned int i = 0; i < 8; ++i)
+    for (unsigned int i = 0; i < MAX_PLAYERS; ++i)
     {
-        InputAxis* tempAxis = m_networkMappings[i].FindInputAxis("Up");
+        InputAxis* tempAxis = m_movementAxes[i].m_up;
         delete tempAxis->m_positiveValue;
         delete tempAxis->m_negativeValue;
 
-        tempAxis = m_networkMappings[i].FindInputAxis("Right");
+        tempAxis = m_movementAxes[i].m_right;
         delete tempAxis->m_positiveValue;
         delete tempAxis->m_negativeValue;
     }
+    m_movementAxes.clear();
 }
 
 //-----------------------------------------------------------------------------------
@@ -375,4 +816,164 @@ void HostSimulation::InitializeLevelGeometry()
 
     //Volcano
     m_levelGeometry.emplace_back(Vector2(192.0f, 193.0f) * UNITS_PER_PIXEL - UNITS_OFFSET, Vector2(287.0f, 240.0f) * UNITS_PER_PIXEL - UNITS_OFFSET);
+
+    for (const AABB2& geometry : m_levelGeometry)
+    {
+        m_levelGeometryBatch.Add(geometry);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void HostSimulation::InitializeHitboxes()
+{
+    //Match the swing the clients draw for each facing, so the hit test doesn't need the sprite lookup per attack.
+    //Links are never scaled or rotated on the host, so their resting bounds stand in for the sprite's.
+    m_linkBounds = ResourceDatabase::instance->GetSpriteResource("pDown")->GetDefaultBounds();
+    AABB2 swordBounds = ResourceDatabase::instance->GetSpriteResource("swordSwing")->GetDefaultBounds();
+    for (unsigned int facing = 0; facing < Link::NUM_DIRECTIONS; ++facing)
+    {
+        m_swordHitboxes[facing] = RotateBoundsByQuarterTurns(swordBounds, Link::GetSwordRotationDegrees((Link::Facing)facing));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+AABB2 HostSimulation::RotateBoundsByQuarterTurns(const AABB2& bounds, float degrees)
+{
+    int quarterTurns = ((int)(degrees / 90.0f) % 4 + 4) % 4;
+    AABB2 rotatedBounds = bounds;
+    for (int i = 0; i < quarterTurns; ++i)
+    {
+        //Counter-clockwise about the sprite's pivot: (x, y) -> (-y, x)
+        rotatedBounds = AABB2(Vector2(-rotatedBounds.maxs.y, rotatedBounds.mins.x), Vector2(-rotatedBounds.mins.y, rotatedBounds.maxs.x));
+    }
+    return rotatedBounds;
+}
+
+//-----------------------------------------------------------------------------------
+void HostSimulation::SaveState(SimulationState& outState) const
+{
+    static_assert(SimulationState::MAX_PLAYERS == MAX_PLAYERS, "SimulationState needs a slot for every player.");
+    memset(&outState, 0, sizeof(SimulationState));
+    outState.m_tick = m_clock.GetCurrentTick();
+    for (unsigned int i = 0; i < MAX_PLAYERS; ++i)
+    {
+        outState.m_playerColors[i] = m_playerColors[i];
+        outState.m_isInMatch[i] = m_isInMatch[i] ? 1 : 0;
+        const Link* player = m_players[i];
+        if (player && !player->m_isDead)
+        {
+            LinkState& linkState = outState.m_links[i];
+            linkState.m_positionX = player->m_position.x;
+            linkState.m_positionY = player->m_position.y;
+            linkState.m_hp = player->m_hp;
+            linkState.m_age = player->m_age;
+            linkState.m_attackStunEndTick = player->m_attackStunEndTick;
+            linkState.m_hurtFlashEndTick = player->m_hurtFlashEndTick;
+            linkState.m_facing = (uint8_t)player->m_facing;
+            linkState.m_isAlive = 1;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Links are the only entities spawned in a match, so they're all there is to restore. Existing Links are reused
+//so a rollback doesn't churn through sprites.
+void HostSimulation::LoadState(const SimulationState& state)
+{
+    m_clock.SetCurrentTick(state.m_tick);
+    for (unsigned int i = 0; i < MAX_PLAYERS; ++i)
+    {
+        m_playerColors[i] = state.m_playerColors[i];
+        m_isInMatch[i] = state.m_isInMatch[i] != 0;
+        const LinkState& linkState = state.m_links[i];
+        Link* player = m_players[i];
+        if (!linkState.m_isAlive)
+        {
+            if (player)
+            {
+                RemoveEntity(player);
+            }
+            continue;
+        }
+        if (!player)
+        {
+            player = SpawnLink((uint8_t)i, m_playerColors[i]);
+            if (!player)
+            {
+                continue;
+            }
+        }
+        player->m_position = Vector2(linkState.m_positionX, linkState.m_positionY);
+        player->m_sprite->m_position = player->m_position;
+        player->m_hp = linkState.m_hp;
+        player->m_age = linkState.m_age;
+        player->m_attackStunEndTick = linkState.m_attackStunEndTick;
+        player->m_hurtFlashEndTick = linkState.m_hurtFlashEndTick;
+        player->m_facing = (Link::Facing)linkState.m_facing;
+        player->m_isDead = false;
+    }
+    m_pendingDespawns.clear();
+    SortEntitiesCanonically();
+    RebuildDefenderGrid();
+}
+
+//-----------------------------------------------------------------------------------
+void HostSimulation::RemoveEntity(Entity* entity)
+{
+    if (entity->IsPlayer())
+    {
+        Link* player = static_cast<Link*>(entity);
+        if (m_players[player->m_netOwnerIndex] == player)
+        {
+            m_players[player->m_netOwnerIndex] = nullptr;
+        }
+    }
+    m_entities.erase(std::find(m_entities.begin(), m_entities.end(), entity));
+    m_entityHandles.Remove(entity->m_networkId);
+    delete entity;
+}
+
+//-----------------------------------------------------------------------------------
+//Collision pairs are found and batched in entity order, so peers have to agree on it, however their entities came to be.
+void HostSimulation::SortEntitiesCanonically()
+{
+    auto getSortKey = [](Entity* entity)
+    {
+        return entity->IsPlayer() ? (unsigned int)static_cast<Link*>(entity)->m_netOwnerIndex : MAX_PLAYERS + (unsigned int)entity->m_networkId;
+    };
+    std::sort(m_entities.begin(), m_entities.end(), [&getSortKey](Entity* first, Entity* second) { return getSortKey(first) < getSortKey(second); });
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(snapcoding)
+{
+    if (args.HasArgs(1))
+    {
+        HostSimulation::s_isSnapshotCodingEnabled = atoi(args.GetStringArgument(0).c_str()) != 0;
+    }
+    Console::instance->PrintLine(Stringf("Snapshot coding is %s", HostSimulation::s_isSnapshotCodingEnabled ? "on" : "off"), RGBA::WHITE);
+}
+
+//-----------------------------------------------------------------------------------
+//Records every coded snapshot piece for SnapshotTrainer. With no file, stops recording.
+CONSOLE_COMMAND(snaprecord)
+{
+    if (HostSimulation::s_snapshotRecording)
+    {
+        fclose(HostSimulation::s_snapshotRecording);
+        HostSimulation::s_snapshotRecording = nullptr;
+        Console::instance->PrintLine("Stopped recording snapshots.", RGBA::WHITE);
+    }
+    if (!args.HasArgs(1))
+    {
+        return;
+    }
+    std::string fileName = args.GetStringArgument(0);
+    HostSimulation::s_snapshotRecording = fopen(fileName.c_str(), "wb");
+    if (!HostSimulation::s_snapshotRecording)
+    {
+        Console::instance->PrintLine(Stringf("Couldn't open %s for recording.", fileName.c_str()), RGBA::RED);
+        return;
+    }
+    Console::instance->PrintLine(Stringf("Recording snapshots to %s", fileName.c_str()), RGBA::WHITE);
 }
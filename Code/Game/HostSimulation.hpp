@@ -1,11 +1,22 @@
 #pragma once
 #include <vector>
-#include "Engine\Input\InputMap.hpp"
-#include "Engine\Net\UDPIP\NetSession.hpp"
-#include "Engine\Renderer\AABB2.hpp"
+#include "Engine/Input/InputMap.hpp"
+#include "Engine/Net/UDPIP/NetSession.hpp"
+#include "Engine/Renderer/AABB2.hpp"
+#include "Game/Physics/CollisionKernels.hpp"
+#include "Game/Physics/CollisionResolver.hpp"
+#include "Game/Physics/PairBatcher.hpp"
+#include "Game/Physics/SpatialGrid.hpp"
+#include "Game/AI/FlowField.hpp"
+#include "Game/AI/BotDirector.hpp"
+#include "Game/Entities/Link.hpp"
+#include "Game/Entities/SlotMap.hpp"
+#include "Game/Net/SnapshotHistory.hpp"
+#include "Game/SimulationClock.hpp"
+#include "Game/SimulationState.hpp"
+#include "Game/PlayerInput.hpp"
 
 class Entity;
-class Link;
 class NetConnection;
 class NetMessage;
 struct NetSender;
@@ -13,39 +24,97 @@ struct NetSender;
 class HostSimulation
 {
 public:
+    enum Mode
+    {
+        AUTHORITATIVE_MODE, //We're the host, everyone else mirrors what we send.
+        ROLLBACK_MODE //Every peer runs its own copy from shared inputs, so nothing is broadcast and order must be canonical.
+    };
+
     //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
-    HostSimulation();
+    HostSimulation(Mode mode = AUTHORITATIVE_MODE, uint32_t connectionMask = 0);
     ~HostSimulation();
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     void SendNetHostUpdate(NetConnection* cp);
+    void SendPlainSnapshot(NetConnection* cp);
+    void SendCodedSnapshot(NetConnection* cp);
     void Update(float deltaSeconds);
+    void Simulate(float deltaSeconds);
+    void Step();
     void UpdateEntities(float deltaSeconds);
+    void PackColliders();
+    void FindCollidingPairs();
+    void ResolveCollidingPairs();
     void AddNewEntities();
     void CleanUpDeadEntities();
+    void FinishUpdate();
+    void BroadcastDespawns();
+    void Broadcast(NetMessage& message) const;
+    inline void AddConnection(uint8_t index) { m_connectionMask |= (1u << index); };
+    inline void RemoveConnection(uint8_t index) { m_connectionMask &= ~(1u << index); };
     void InitializeKeyMappings();
     void UninitializeKeyMappings();
     void OnConnectionJoined(NetConnection* cp);
     void OnConnectionLeave(NetConnection* cp);
     void BroadcastLinkCreation(uint8_t index, unsigned int playerColor);
+    Link* SpawnLink(uint8_t index, unsigned int playerColor);
+    static void WriteLinkSnapshot(NetMessage& message, const Link* link);
+    void PerformAttack(uint8_t index);
+    void ApplyPlayerInput(uint8_t index, const PlayerInput& input, const PlayerInput& previousInput);
+    void SaveState(SimulationState& outState) const;
+    void LoadState(const SimulationState& state);
+    void RemoveEntity(Entity* entity);
+    void SortEntitiesCanonically();
+    inline bool IsBroadcasting() const { return m_mode == AUTHORITATIVE_MODE; };
 
     //These functions take a copy of the NetMessage intentionally, so that they can read the contents on their own
     void OnUpdateFromClientReceived(const NetSender& from, NetMessage& message);
-    void OnPlayerDestroy(const NetSender& from, NetMessage message);
     void OnPlayerCreate(const NetSender& from, NetMessage message);
     void OnPlayerAttack(const NetSender& from, NetMessage message);
     void CheckForAndBroadcastDamage(Link* attackingPlayer, const Vector2& swordPosition);
     void OnPlayerFireBow(const NetSender& from, NetMessage& message);
     void InitializeLevelGeometry();
+    void InitializeHitboxes();
+    void RebuildDefenderGrid();
+    static AABB2 RotateBoundsByQuarterTurns(const AABB2& bounds, float degrees);
 
     //CONSTANTS/////////////////////////////////////////////////////////////////////
     const static int MAX_PLAYERS = NetSession::MAX_CONNECTIONS;
+    static bool s_isSnapshotCodingEnabled;
+    static FILE* s_snapshotRecording; //Training input for SnapshotTrainer, while "snaprecord" is on.
 
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    Mode m_mode;
+    uint32_t m_connectionMask; //Bit per connection index this simulation talks to, set as they join. Matches sharing a session each own a few.
+    unsigned int m_playerLimit; //Connections plus bots. Slots are still connection indices, so this caps a match without shrinking it.
     std::vector<Link*> m_players;
     unsigned int m_playerColors[MAX_PLAYERS];
+    bool m_isInMatch[MAX_PLAYERS];
     std::vector<AABB2> m_levelGeometry;
+    AABB2Batch m_levelGeometryBatch;
+    DiscBatch m_layerDiscs[NUM_COLLISION_LAYERS];
+    std::vector<Entity*> m_colliders;
+    unsigned int m_layerStarts[NUM_COLLISION_LAYERS + 1];
+    std::vector<std::vector<ColliderPair>> m_pairChunks;
+    std::vector<ColliderPair> m_contactPairs;
+    PairBatcher m_pairBatcher;
+    std::vector<CollisionOverlap> m_overlaps;
+    AABB2 m_swordHitboxes[Link::NUM_DIRECTIONS];
+    AABB2 m_linkBounds; //Link's sprite bounds about its position. Hit tests use these rather than the sprite, so they only depend on saved state.
+    SpatialGrid<Link> m_defenderGrid;
+    std::vector<Link*> m_defenderCandidates;
+    NavigationGrid m_navigationGrid;
+    BotDirector m_bots;
     std::vector<Entity*> m_entities;
     std::vector<Entity*> m_newEntities;
+    SlotMap<Entity> m_entityHandles;
+    std::vector<uint16_t> m_pendingDespawns;
+    std::vector<Entity*> m_despawnedEntities; //Freed by BroadcastDespawns(), since the entity and sprite pools are shared by every match.
     std::vector<InputMap> m_networkMappings;
+    std::vector<MovementAxes> m_movementAxes; //Resolved handles into m_networkMappings, one per player slot.
+    MovementInput m_networkInputs[MAX_PLAYERS]; //Held from one client update to the next, which only come on change.
+    uint8_t m_inputSequences[MAX_PLAYERS];
+    bool m_hasInputSequence[MAX_PLAYERS];
+    std::vector<SnapshotSendHistory> m_snapshotHistories; //Per connection index, what each client has acknowledged.
+    SimulationClock m_clock;
 };
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "Game/Jobs/JobSystem.hpp"
+#include "Game/Physics/CollisionKernels.hpp"
+#include "Game/Physics/PairBatcher.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Time/Time.hpp"
+#include <string.h>
+#include <stdlib.h>
+
+//-----------------------------------------------------------------------------------
+//Stand-in for the host's two-phase update over plain discs, so thread scaling can be measured without a live match.
+struct BenchDiscs
+{
+    std::vector<Vector2> m_positions;
+    std::vector<Vector2> m_velocities;
+    std::vector<float> m_radii;
+    DiscBatch m_batch;
+    std::vector<std::vector<ColliderPair>> m_pairChunks;
+    std::vector<ColliderPair> m_pairs;
+    PairBatcher m_batcher;
+};
+
+static const unsigned int BENCH_CHUNK_SIZE = 32;
+static const float BENCH_WORLD_WIDTH = 30.0f;
+static const float BENCH_WORLD_HEIGHT = 16.0f;
+
+//-----------------------------------------------------------------------------------
+static void StepBenchDiscs(JobSystem& jobSystem, BenchDiscs& discs, float deltaSeconds)
+{
+    unsigned int numDiscs = (unsigned int)discs.m_positions.size();
+    auto integrate = [&discs, deltaSeconds](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            Vector2& position = discs.m_positions[i];
+            Vector2& velocity = discs.m_velocities[i];
+            position += velocity * deltaSeconds;
+            velocity.x = (position.x < 0.0f || position.x > BENCH_WORLD_WIDTH) ? -velocity.x : velocity.x;
+            velocity.y = (position.y < 0.0f || position.y > BENCH_WORLD_HEIGHT) ? -velocity.y : velocity.y;
+        }
+    };
+    jobSystem.ParallelFor(numDiscs, BENCH_CHUNK_SIZE, integrate);
+
+    discs.m_batch.Clear();
+    for (unsigned int i = 0; i < numDiscs; ++i)
+    {
+        discs.m_batch.Add(discs.m_positions[i], discs.m_radii[i]);
+    }
+    auto findPairs = [&discs](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            std::vector<ColliderPair>& pairs = discs.m_pairChunks[i / BENCH_CHUNK_SIZE];
+            if (i % BENCH_CHUNK_SIZE == 0)
+            {
+                pairs.clear();
+            }
+            for (unsigned int block = i / DiscBatch::BLOCK_SIZE; block < discs.m_batch.GetNumBlocks(); ++block)
+            {
+                uint32_t hitMask = CollisionKernels::DiscVsDiscBlock(discs.m_positions[i], discs.m_radii[i], discs.m_batch, block);
+                for (; hitMask != 0; hitMask &= hitMask - 1)
+                {
+                    unsigned int other = (block * DiscBatch::BLOCK_SIZE) + CollisionKernels::FindLowestSetBit(hitMask);
+                    if (other > i)
+                    {
+                        pairs.push_back({ i, other });
+                    }
+                }
+            }
+        }
+    };
+    jobSystem.ParallelFor(numDiscs, BENCH_CHUNK_SIZE, findPairs);
+
+    discs.m_pairs.clear();
+    for (const std::vector<ColliderPair>& chunk : discs.m_pairChunks)
+    {
+        discs.m_pairs.insert(discs.m_pairs.end(), chunk.begin(), chunk.end());
+    }
+    discs.m_batcher.Build(discs.m_pairs, numDiscs);
+    for (unsigned int batchIndex = 0; batchIndex < discs.m_batcher.GetNumBatches(); ++batchIndex)
+    {
+        const unsigned int* batch = discs.m_batcher.GetBatch(batchIndex);
+        auto resolve = [&discs, batch](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                const ColliderPair& pair = discs.m_pairs[batch[i]];
+                Vector2 difference = discs.m_positions[pair.m_first] - discs.m_positions[pair.m_second];
+                float distance = difference.Normalize();
+                float penetration = discs.m_radii[pair.m_first] + discs.m_radii[pair.m_second] - distance;
+                if (distance > 0.0f && penetration > 0.0f)
+                {
+                    difference *= penetration * 0.125f;
+                    discs.m_positions[pair.m_first] += difference;
+                    discs.m_positions[pair.m_second] -= difference;
+                }
+            }
+        };
+        if (discs.m_batcher.IsSerialBatch(batchIndex))
+        {
+            resolve(0, discs.m_batcher.GetBatchSize(batchIndex));
+        }
+        else
+        {
+            jobSystem.ParallelFor(discs.m_batcher.GetBatchSize(batchIndex), BENCH_CHUNK_SIZE, resolve);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+static uint32_t HashBenchPositions(const BenchDiscs& discs)
+{
+    uint32_t hash = 2166136261u;
+    for (const Vector2& position : discs.m_positions)
+    {
+        uint32_t bits[2];
+        memcpy(bits, &position.x, sizeof(float));
+        memcpy(bits + 1, &position.y, sizeof(float));
+        hash = (hash ^ bits[0]) * 16777619u;
+        hash = (hash ^ bits[1]) * 16777619u;
+    }
+    return hash;
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(benchjobs)
+{
+    int numDiscs = args.HasArgs(1) ? atoi(args.GetStringArgument(0).c_str()) : 4096;
+    int numTicks = args.HasArgs(2) ? atoi(args.GetStringArgument(1).c_str()) : 60;
+    if (numDiscs <= 0 || numTicks <= 0)
+    {
+        Console::instance->PrintLine("benchjobs <numDiscs> <numTicks>", RGBA::RED);
+        return;
+    }
+
+    //Every thread count starts from the same scene, so the final positions must hash the same.
+    BenchDiscs initialDiscs;
+    for (int i = 0; i < numDiscs; ++i)
+    {
+        initialDiscs.m_positions.push_back(Vector2(MathUtils::GetRandomFloatFromZeroTo(BENCH_WORLD_WIDTH), MathUtils::GetRandomFloatFromZeroTo(BENCH_WORLD_HEIGHT)));
+        initialDiscs.m_velocities.push_back(Vector2(MathUtils::GetRandomFloatFromZeroTo(2.0f) - 1.0f, MathUtils::GetRandomFloatFromZeroTo(2.0f) - 1.0f));
+        initialDiscs.m_radii.push_back(0.05f + MathUtils::GetRandomFloatFromZeroTo(0.1f));
+    }
+    initialDiscs.m_pairChunks.resize((numDiscs + BENCH_CHUNK_SIZE - 1) / BENCH_CHUNK_SIZE);
+
+    unsigned int maxThreads = JobSystem::GetDefaultNumWorkerThreads() + 1;
+    double singleThreadSeconds = 0.0;
+    uint32_t expectedHash = 0;
+    for (unsigned int numThreads = 1; numThreads <= maxThreads; ++numThreads)
+    {
+        JobSystem jobSystem(numThreads - 1);
+        BenchDiscs discs = initialDiscs;
+        double startSeconds = GetCurrentTimeSeconds();
+        for (int tick = 0; tick < numTicks; ++tick)
+        {
+            StepBenchDiscs(jobSystem, discs, 1.0f / 60.0f);
+        }
+        double elapsedSeconds = GetCurrentTimeSeconds() - startSeconds;
+        uint32_t hash = HashBenchPositions(discs);
+
+        if (numThreads == 1)
+        {
+            singleThreadSeconds = elapsedSeconds;
+            expectedHash = hash;
+        }
+        bool isDeterministic = (hash == expectedHash);
+        Console::instance->PrintLine(Stringf("%2u threads: %7.3f ms/tick, %5.2fx, hash %08x", numThreads, (elapsedSeconds * 1000.0) / numTicks,
+            singleThreadSeconds / elapsedSeconds, hash), isDeterministic ? RGBA::WHITE : RGBA::RED);
+    }
+}
@@ -0,0 +1,245 @@
+#include "Game/Jobs/JobSystem.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+JobSystem* JobSystem::instance = nullptr;
+
+//Lets a thread find its own queue, and tells a nested ParallelFor on a worker which queue to push to.
+static thread_local const JobSystem* t_owningJobSystem = nullptr;
+static thread_local unsigned int t_queueIndex = 0;
+
+//-----------------------------------------------------------------------------------
+JobSystem::JobSystem(unsigned int numWorkerThreads)
+    : m_numQueuedJobs(0)
+    , m_isShuttingDown(false)
+{
+    for (unsigned int i = 0; i < numWorkerThreads + 1; ++i)
+    {
+        m_queues.push_back(new WorkQueue());
+    }
+    for (unsigned int i = 0; i < numWorkerThreads; ++i)
+    {
+        m_threads.emplace_back(&JobSystem::WorkerMain, this, i + 1);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_isShuttingDown = true;
+    }
+    m_wakeCondition.notify_all();
+    for (std::thread& thread : m_threads)
+    {
+        thread.join();
+    }
+    for (WorkQueue* queue : m_queues)
+    {
+        ASSERT_OR_DIE(queue->m_jobs.empty() && queue->m_pinnedJobs.empty(), "Job system shut down with jobs still queued.");
+        delete queue;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int JobSystem::GetDefaultNumWorkerThreads()
+{
+    //Leave the calling thread's core for the caller, it helps out while it waits anyway.
+    unsigned int numCores = std::thread::hardware_concurrency();
+    return numCores > 1 ? numCores - 1 : 0;
+}
+
+//-----------------------------------------------------------------------------------
+void JobSystem::ParallelFor(unsigned int count, unsigned int chunkSize, JobFunction function, void* data)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (chunkSize == 0)
+    {
+        chunkSize = 1;
+    }
+    unsigned int numChunks = (count + chunkSize - 1) / chunkSize;
+    if (numChunks == 1 || m_threads.empty())
+    {
+        function(data, 0, count);
+        return;
+    }
+
+    std::atomic<unsigned int> numRemaining(numChunks);
+    unsigned int queueIndex = GetCurrentQueueIndex();
+    {
+        //Counted along with the push, so a thief can never take a job before it's been counted and wrap the count.
+        std::lock_guard<std::mutex> sleepLock(m_sleepMutex);
+        WorkQueue* queue = m_queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue->m_mutex);
+        for (unsigned int chunk = 0; chunk < numChunks; ++chunk)
+        {
+            unsigned int begin = chunk * chunkSize;
+            unsigned int end = (begin + chunkSize < count) ? begin + chunkSize : count;
+            queue->m_jobs.push_back({ function, data, begin, end, &numRemaining });
+        }
+        m_numQueuedJobs += numChunks;
+    }
+    m_wakeCondition.notify_all();
+
+    //Help out instead of blocking. Anything we pick up, ours or stolen, brings the range closer to done.
+    while (numRemaining.load(std::memory_order_acquire) != 0)
+    {
+        if (!TryRunJob(queueIndex))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Each item is its own job, queued for the thread it's pinned to. The caller runs its share and then keeps helping with
+//anything stealable until the rest are done.
+void JobSystem::ParallelForPinned(unsigned int count, JobFunction function, void* data)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (m_threads.empty())
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            function(data, i, i + 1);
+        }
+        return;
+    }
+    ASSERT_OR_DIE(GetCurrentQueueIndex() == 0, "Pinned jobs have to be submitted from outside the pool.");
+
+    std::atomic<unsigned int> numRemaining(count);
+    unsigned int numQueues = (unsigned int)m_queues.size();
+    {
+        std::lock_guard<std::mutex> sleepLock(m_sleepMutex);
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            WorkQueue* queue = m_queues[i % numQueues];
+            std::lock_guard<std::mutex> lock(queue->m_mutex);
+            queue->m_pinnedJobs.push_back({ function, data, i, i + 1, &numRemaining });
+            ++queue->m_numPinnedJobs;
+        }
+    }
+    m_wakeCondition.notify_all();
+
+    while (numRemaining.load(std::memory_order_acquire) != 0)
+    {
+        if (!TryRunJob(0))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Worker i (and the calling thread, as thread 0) is locked to core firstCore + i, so pinned jobs keep their cache warm.
+//Several processes sharing a machine can each be given their own range of cores.
+void JobSystem::PinThreadsToCores(unsigned int firstCore)
+{
+    unsigned int numCores = std::thread::hardware_concurrency();
+    numCores = numCores > 0 ? numCores : 1;
+    for (unsigned int i = 0; i < GetNumThreads(); ++i)
+    {
+        unsigned int core = (firstCore + i) % numCores;
+#ifdef _WIN32
+        HANDLE thread = (i == 0) ? GetCurrentThread() : (HANDLE)m_threads[i - 1].native_handle();
+        SetThreadAffinityMask(thread, (DWORD_PTR)1 << core);
+#else
+        pthread_t thread = (i == 0) ? pthread_self() : m_threads[i - 1].native_handle();
+        cpu_set_t coreSet;
+        CPU_ZERO(&coreSet);
+        CPU_SET(core, &coreSet);
+        pthread_setaffinity_np(thread, sizeof(coreSet), &coreSet);
+#endif
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void JobSystem::WorkerMain(unsigned int queueIndex)
+{
+    t_owningJobSystem = this;
+    t_queueIndex = queueIndex;
+    while (!m_isShuttingDown)
+    {
+        if (TryRunJob(queueIndex))
+        {
+            continue;
+        }
+        WorkQueue* ownQueue = m_queues[queueIndex];
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wakeCondition.wait(lock, [this, ownQueue]() { return m_numQueuedJobs.load() != 0 || ownQueue->m_numPinnedJobs.load() != 0 || m_isShuttingDown.load(); });
+    }
+}
+
+//-----------------------------------------------------------------------------------
+bool JobSystem::TryRunJob(unsigned int queueIndex)
+{
+    Job job;
+    if (!TryPop(queueIndex, job) && !TrySteal(queueIndex, job))
+    {
+        return false;
+    }
+    job.m_function(job.m_data, job.m_begin, job.m_end);
+    job.m_numRemaining->fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+//Stealable jobs come first: they're most likely the inside of something this thread is already in the middle of.
+bool JobSystem::TryPop(unsigned int queueIndex, Job& outJob)
+{
+    WorkQueue* queue = m_queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue->m_mutex);
+    if (!queue->m_jobs.empty())
+    {
+        outJob = queue->m_jobs.back();
+        queue->m_jobs.pop_back();
+        --m_numQueuedJobs;
+        return true;
+    }
+    if (!queue->m_pinnedJobs.empty())
+    {
+        outJob = queue->m_pinnedJobs.front();
+        queue->m_pinnedJobs.pop_front();
+        --queue->m_numPinnedJobs;
+        return true;
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------------
+bool JobSystem::TrySteal(unsigned int thiefIndex, Job& outJob)
+{
+    unsigned int numQueues = (unsigned int)m_queues.size();
+    for (unsigned int offset = 1; offset < numQueues; ++offset)
+    {
+        WorkQueue* victim = m_queues[(thiefIndex + offset) % numQueues];
+        std::lock_guard<std::mutex> lock(victim->m_mutex);
+        if (!victim->m_jobs.empty())
+        {
+            outJob = victim->m_jobs.front();
+            victim->m_jobs.pop_front();
+            --m_numQueuedJobs;
+            return true;
+        }
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int JobSystem::GetCurrentQueueIndex() const
+{
+    return (t_owningJobSystem == this) ? t_queueIndex : 0;
+}
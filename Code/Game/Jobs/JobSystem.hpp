@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+//Work-stealing thread pool. Each thread owns a queue it pops from the back of, and idle threads steal from the front of
+//everyone else's. The thread that calls ParallelFor works through jobs alongside the workers until its range is done,
+//so a JobSystem with zero workers just runs everything inline. Pinned jobs go to one thread's queue and are never stolen,
+//for work that should keep to the same core from call to call.
+class JobSystem
+{
+public:
+    typedef void(*JobFunction)(void* data, unsigned int begin, unsigned int end);
+
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    JobSystem(unsigned int numWorkerThreads);
+    ~JobSystem();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void ParallelFor(unsigned int count, unsigned int chunkSize, JobFunction function, void* data);
+    template <typename Function> void ParallelFor(unsigned int count, unsigned int chunkSize, Function& function);
+    void ParallelForPinned(unsigned int count, JobFunction function, void* data);
+    template <typename Function> void ParallelForPinned(unsigned int count, Function& function);
+    void PinThreadsToCores(unsigned int firstCore);
+    inline unsigned int GetNumThreads() const { return (unsigned int)m_threads.size() + 1; };
+    static unsigned int GetDefaultNumWorkerThreads();
+
+    //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
+    static JobSystem* instance;
+
+private:
+    struct Job
+    {
+        JobFunction m_function;
+        void* m_data;
+        unsigned int m_begin;
+        unsigned int m_end;
+        std::atomic<unsigned int>* m_numRemaining;
+    };
+
+    struct WorkQueue
+    {
+        WorkQueue() : m_numPinnedJobs(0) {};
+
+        std::mutex m_mutex;
+        std::deque<Job> m_jobs;
+        std::deque<Job> m_pinnedJobs; //Only ever run by the queue's own thread.
+        std::atomic<unsigned int> m_numPinnedJobs;
+    };
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator= (const JobSystem&) = delete;
+
+    void WorkerMain(unsigned int queueIndex);
+    bool TryRunJob(unsigned int queueIndex);
+    bool TryPop(unsigned int queueIndex, Job& outJob);
+    bool TrySteal(unsigned int thiefIndex, Job& outJob);
+    unsigned int GetCurrentQueueIndex() const;
+
+    template <typename Function>
+    static void RunRange(void* data, unsigned int begin, unsigned int end) { (*static_cast<Function*>(data))(begin, end); };
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<std::thread> m_threads;
+    std::vector<WorkQueue*> m_queues; //Queue 0 belongs to whoever submits from outside the pool.
+    std::atomic<unsigned int> m_numQueuedJobs; //Stealable jobs only, pinned ones are counted on their queue.
+    std::atomic<bool> m_isShuttingDown;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeCondition;
+};
+
+//-----------------------------------------------------------------------------------
+//Calls function(begin, end) over [0, count) in chunks of chunkSize. Chunk boundaries only depend on count and chunkSize,
+//never on how many threads there are, so per-chunk outputs can be merged deterministically.
+template <typename Function>
+void JobSystem::ParallelFor(unsigned int count, unsigned int chunkSize, Function& function)
+{
+    ParallelFor(count, chunkSize, &RunRange<Function>, &function);
+}
+
+//-----------------------------------------------------------------------------------
+//Calls function(i, i + 1) for every i in [0, count), always on thread i % GetNumThreads(), where thread 0 is the caller.
+template <typename Function>
+void JobSystem::ParallelForPinned(unsigned int count, Function& function)
+{
+    ParallelForPinned(count, &RunRange<Function>, &function);
+}
@@ -0,0 +1,142 @@
+//-----------------------------------------------------------------------------------
+//Headless dedicated host for Linux: no window, GL context, input or audio, just the host simulation, the net session and
+//the console. Built by Code/Game/Makefile from every Game source except Main_Win32.cpp and the Tools, against a Linux
+//build of the engine library ("make" from Code/Game drops the binary in Run_Win32). From Run_Win32:
+//
+//  ./DedicatedServer -name Host -tickrate 60 -matches 2 -matchsize 3 -threads 1 -pin 0
+//
+//Every match runs in this one process off one session, so the session's connection limit is shared between them, and
+//-matchsize (at most HostSimulation::MAX_PLAYERS) only caps each match's share. The server's own connection takes one.
+//Console commands are typed (or piped) on stdin. "quit", SIGINT or SIGTERM shut the server down cleanly.
+#include "Engine/Core/Memory/MemoryTracking.hpp"
+#include "Engine/Core/Event.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Input/Logging.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include "Engine/Net/NetSystem.hpp"
+#include "Game/TheGame.hpp"
+#include "Game/DedicatedServer.hpp"
+#include "Game/HostSimulation.hpp"
+#include "Game/Jobs/JobSystem.hpp"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+//-----------------------------------------------------------------------------------------------
+bool g_isQuitting = false;
+Event<float> NetworkUpdate;
+Event<> NetworkCleanup;
+
+//-----------------------------------------------------------------------------------------------
+static void OnQuitSignal(int)
+{
+    if (DedicatedServer::instance)
+    {
+        DedicatedServer::instance->RequestQuit();
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+static void PrintUsage()
+{
+    printf("DedicatedServer [-name <hostName>] [-tickrate <ticksPerSecond>] [-matches n] [-matchsize <playersPerMatch>] [-threads <numWorkerThreads>] [-pin <firstCore>]\n");
+}
+
+//-----------------------------------------------------------------------------------------------
+//Many servers share a core, so the job system defaults to no workers and the simulation's jobs run inline. Pinning is
+//opt-in, since processes packed onto one machine need to be handed separate cores.
+void Initialize(float ticksPerSecond, unsigned int numWorkerThreads, int firstPinnedCore)
+{
+    NetSystem::instance = new NetSystem();
+    JobSystem::instance = new JobSystem(numWorkerThreads);
+    if (firstPinnedCore >= 0)
+    {
+        JobSystem::instance->PinThreadsToCores((unsigned int)firstPinnedCore);
+    }
+    Console::instance = new Console();
+    TheGame::instance = new TheGame(true);
+    DedicatedServer::instance = new DedicatedServer(ticksPerSecond);
+}
+
+//-----------------------------------------------------------------------------------------------
+void Shutdown()
+{
+    delete DedicatedServer::instance;
+    DedicatedServer::instance = nullptr;
+    NetworkCleanup.Trigger();
+    delete TheGame::instance;
+    TheGame::instance = nullptr;
+    delete Console::instance;
+    Console::instance = nullptr;
+    delete JobSystem::instance;
+    JobSystem::instance = nullptr;
+    delete NetSystem::instance;
+    NetSystem::instance = nullptr;
+    Texture::CleanUpTextureRegistry();
+}
+
+//-----------------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    std::string hostName = "Host";
+    float ticksPerSecond = 60.0f;
+    unsigned int numWorkerThreads = 0;
+    unsigned int numMatches = 1;
+    unsigned int playersPerMatch = HostSimulation::MAX_PLAYERS;
+    int firstPinnedCore = -1;
+    for (int i = 1; i < argc; ++i)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-name") == 0 && hasValue)
+        {
+            hostName = argv[++i];
+        }
+        else if (strcmp(argv[i], "-tickrate") == 0 && hasValue)
+        {
+            ticksPerSecond = (float)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-threads") == 0 && hasValue)
+        {
+            numWorkerThreads = (unsigned int)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-matches") == 0 && hasValue)
+        {
+            numMatches = (unsigned int)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-matchsize") == 0 && hasValue)
+        {
+            playersPerMatch = (unsigned int)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-pin") == 0 && hasValue)
+        {
+            firstPinnedCore = atoi(argv[++i]);
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (ticksPerSecond <= 0.0f || numMatches == 0 || playersPerMatch == 0 || playersPerMatch > HostSimulation::MAX_PLAYERS)
+    {
+        PrintUsage();
+        return 1;
+    }
+    if (numMatches * playersPerMatch > HostSimulation::MAX_PLAYERS - 1)
+    {
+        printf("Warning: only %i players fit in the session, so %u matches of %u will never all fill.\n", HostSimulation::MAX_PLAYERS - 1, numMatches, playersPerMatch);
+    }
+
+    MemoryAnalyticsStartup();
+    LoggerStartup();
+    Initialize(ticksPerSecond, numWorkerThreads, firstPinnedCore);
+    signal(SIGINT, &OnQuitSignal);
+    signal(SIGTERM, &OnQuitSignal);
+    DedicatedServer::instance->Run(hostName, numMatches, playersPerMatch);
+    Shutdown();
+    LoggerShutdown();
+    MemoryAnalyticsShutdown();
+    return 0;
+}
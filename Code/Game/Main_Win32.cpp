@@ -1,5 +1,6 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#include <mmsystem.h>
 #include <math.h>
 #include <cassert>
 #include <crtdbg.h>
@@ -20,6 +21,10 @@
 #include "Engine/Renderer/2D/SpriteGameRenderer.hpp"
 #include "Engine/Core/Event.hpp"
 #include "Engine/Net/NetSystem.hpp"
+#include "Game/Jobs/JobSystem.hpp"
+#include "Game/FramePacer.hpp"
+
+#pragma comment(lib, "winmm.lib") //timeBeginPeriod
 
 //-----------------------------------------------------------------------------------------------
 #define UNUSED(x) (void)(x);
@@ -189,6 +194,14 @@ void RunMessagePump()
             break;
         }
 
+        //Stamped as it comes off the queue, so the client can tell how long the input waited to reach the wire.
+        bool isKeyMessage = queuedMessage.message >= WM_KEYFIRST && queuedMessage.message <= WM_KEYLAST;
+        bool isMouseButtonMessage = queuedMessage.message >= WM_LBUTTONDOWN && queuedMessage.message <= WM_MBUTTONDBLCLK;
+        if (isKeyMessage || isMouseButtonMessage)
+        {
+            TheGame::instance->OnInputEvent(GetCurrentTimeSeconds());
+        }
+
         TranslateMessage(&queuedMessage);
         DispatchMessage(&queuedMessage);
     }
@@ -203,6 +216,7 @@ void Update()
     s_timeLastFrameStarted = timeNow;
 
     InputSystem::instance->Update(deltaSeconds);
+    TheGame::instance->SubmitInput();
     AudioSystem::instance->Update(deltaSeconds);
     Console::instance->Update(deltaSeconds);
     NetworkUpdate.Trigger(deltaSeconds);
@@ -218,24 +232,35 @@ void Render()
 }
 
 //-----------------------------------------------------------------------------------------------
+//Waits for the pacer first, so the frame works with the freshest input. Wakes that aren't due a frame still run the
+//update, which keeps the net session and simulation ticking while the window is hidden.
 void RunFrame()
 {
+    bool isMinimized = IsIconic(g_hWnd) != FALSE;
+    bool isInBackground = GetForegroundWindow() != g_hWnd;
+    bool shouldRender = GameLoopPacer::instance->WaitForNextFrame(isInBackground, isMinimized);
     InputSystem::instance->AdvanceFrameNumber();
     RunMessagePump();
     Update();
-    Render();
+    if (shouldRender)
+    {
+        Render();
+    }
 }
 
 //-----------------------------------------------------------------------------------------------
 void Initialize(HINSTANCE applicationInstanceHandle)
 {
     SetProcessDPIAware();
+    timeBeginPeriod(1); //Lets the frame pacer's sleeps wake within a millisecond, rather than a 15.6ms scheduler tick.
+    GameLoopPacer::instance = new GameLoopPacer();
     CreateOpenGLWindow(applicationInstanceHandle);
     Renderer::instance = new Renderer();
     SpriteGameRenderer::instance = new SpriteGameRenderer(RGBA::CORNFLOWER_BLUE, WINDOW_PHYSICAL_WIDTH, WINDOW_PHYSICAL_HEIGHT, IMPORT_RESOLUTION, VIRTUAL_SIZE);
     AudioSystem::instance = new AudioSystem();
     InputSystem::instance = new InputSystem(g_hWnd, 4);
     NetSystem::instance = new NetSystem();
+    JobSystem::instance = new JobSystem(JobSystem::GetDefaultNumWorkerThreads());
     Console::instance = new Console();
     TheGame::instance = new TheGame();
 }
@@ -257,6 +282,8 @@ void Shutdown()
     TheGame::instance = nullptr;
     delete Console::instance;
     Console::instance = nullptr;
+    delete JobSystem::instance;
+    JobSystem::instance = nullptr;
     delete NetSystem::instance;
     NetSystem::instance = nullptr;
     delete InputSystem::instance;
@@ -267,6 +294,9 @@ void Shutdown()
     SpriteGameRenderer::instance = nullptr;
     delete Renderer::instance;
     Renderer::instance = nullptr; 
+    delete GameLoopPacer::instance;
+    GameLoopPacer::instance = nullptr;
+    timeEndPeriod(1);
     EngineCleanup();
 }
 
@@ -0,0 +1,107 @@
+#include "Game/MatchManager.hpp"
+#include "Game/Jobs/JobSystem.hpp"
+#include "Engine/Net/UDPIP/NetConnection.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <string.h>
+
+//-----------------------------------------------------------------------------------
+MatchManager::MatchManager(unsigned int numMatches, unsigned int playersPerMatch)
+    : m_numPlayers(numMatches, 0)
+    , m_playersPerMatch(playersPerMatch)
+{
+    ASSERT_OR_DIE(numMatches > 0 && numMatches < NO_MATCH, "A match manager needs between 1 and 254 matches.");
+    ASSERT_OR_DIE(playersPerMatch > 0 && playersPerMatch <= HostSimulation::MAX_PLAYERS, "Matches hold between 1 and HostSimulation::MAX_PLAYERS players.");
+    memset(m_connectionMatches, NO_MATCH, sizeof(m_connectionMatches));
+    m_matches.reserve(numMatches);
+    for (unsigned int i = 0; i < numMatches; ++i)
+    {
+        m_matches.push_back(new HostSimulation(HostSimulation::AUTHORITATIVE_MODE, 0));
+        m_matches.back()->m_playerLimit = playersPerMatch;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+MatchManager::~MatchManager()
+{
+    for (HostSimulation* match : m_matches)
+    {
+        delete match;
+    }
+    m_matches.clear();
+}
+
+//-----------------------------------------------------------------------------------
+//Matches share no state, so each one simulates on its own thread. Match i always lands on the same thread, which
+//keeps its entities in one core's cache when the threads are pinned. Sends happen afterwards, one match at a time.
+void MatchManager::Update(float deltaSeconds)
+{
+    auto simulateMatches = [this, deltaSeconds](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            m_matches[i]->Simulate(deltaSeconds);
+        }
+    };
+    if (JobSystem::instance)
+    {
+        JobSystem::instance->ParallelForPinned((unsigned int)m_matches.size(), simulateMatches);
+    }
+    else
+    {
+        simulateMatches(0, (unsigned int)m_matches.size());
+    }
+    for (HostSimulation* match : m_matches)
+    {
+        match->FinishUpdate();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//New connections fill the emptiest match that still has room, so players spread out instead of queueing for one.
+//Returns null when every match is full.
+HostSimulation* MatchManager::AssignConnection(NetConnection* cp)
+{
+    unsigned int bestMatch = NO_MATCH;
+    for (unsigned int i = 0; i < m_matches.size(); ++i)
+    {
+        if (m_numPlayers[i] < m_playersPerMatch && (bestMatch == NO_MATCH || m_numPlayers[i] < m_numPlayers[bestMatch]))
+        {
+            bestMatch = i;
+        }
+    }
+    if (bestMatch == NO_MATCH)
+    {
+        return nullptr;
+    }
+    m_connectionMatches[cp->m_index] = (uint8_t)bestMatch;
+    ++m_numPlayers[bestMatch];
+    HostSimulation* match = m_matches[bestMatch];
+    match->AddConnection(cp->m_index);
+    match->OnConnectionJoined(cp);
+    return match;
+}
+
+//-----------------------------------------------------------------------------------
+void MatchManager::RemoveConnection(NetConnection* cp)
+{
+    uint8_t matchIndex = m_connectionMatches[cp->m_index];
+    if (matchIndex == NO_MATCH)
+    {
+        return;
+    }
+    HostSimulation* match = m_matches[matchIndex];
+    match->OnConnectionLeave(cp);
+    match->RemoveConnection(cp->m_index);
+    --m_numPlayers[matchIndex];
+    m_connectionMatches[cp->m_index] = NO_MATCH;
+}
+
+//-----------------------------------------------------------------------------------
+HostSimulation* MatchManager::FindMatch(uint8_t connectionIndex) const
+{
+    if (connectionIndex >= HostSimulation::MAX_PLAYERS || m_connectionMatches[connectionIndex] == NO_MATCH)
+    {
+        return nullptr;
+    }
+    return m_matches[m_connectionMatches[connectionIndex]];
+}
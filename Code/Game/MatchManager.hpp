@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include "Game/HostSimulation.hpp"
+
+class NetConnection;
+
+//-----------------------------------------------------------------------------------
+//Runs several independent matches in one process off a single NetSession. Every connection belongs to exactly one
+//match, which only hears from and broadcasts to its own connections. Matches simulate side by side, each pinned to
+//the same job system thread every tick, and only touch the session afterwards, back on the calling thread.
+//Players are identified by their session connection index on the wire, so every match keeps a slot per possible
+//connection and the session's connection limit is shared by all of them. playersPerMatch caps how many of those
+//slots a match fills, connections and bots together, rather than sizing it.
+class MatchManager
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    MatchManager(unsigned int numMatches, unsigned int playersPerMatch);
+    ~MatchManager();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Update(float deltaSeconds);
+    HostSimulation* AssignConnection(NetConnection* cp);
+    void RemoveConnection(NetConnection* cp);
+    HostSimulation* FindMatch(uint8_t connectionIndex) const;
+    inline HostSimulation* GetMatch(unsigned int matchIndex) const { return matchIndex < m_matches.size() ? m_matches[matchIndex] : nullptr; };
+    inline unsigned int GetNumMatches() const { return (unsigned int)m_matches.size(); };
+    inline unsigned int GetNumPlayers(unsigned int matchIndex) const { return m_numPlayers[matchIndex]; };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const uint8_t NO_MATCH = 0xFF;
+
+private:
+    MatchManager(const MatchManager&) = delete;
+    MatchManager& operator= (const MatchManager&) = delete;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<HostSimulation*> m_matches;
+    std::vector<unsigned int> m_numPlayers;
+    uint8_t m_connectionMatches[HostSimulation::MAX_PLAYERS]; //Match index per connection index, or NO_MATCH.
+    unsigned int m_playersPerMatch;
+};
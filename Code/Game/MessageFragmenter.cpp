@@ -0,0 +1,134 @@
+#include "Game/MessageFragmenter.hpp"
+#include "Game/TheGame.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Net/UDPIP/NetMessage.hpp"
+#include "Engine/Net/UDPIP/NetConnection.hpp"
+#include "Engine/Net/UDPIP/NetSession.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Time/Time.hpp"
+
+MessageFragmenter* MessageFragmenter::instance = nullptr;
+unsigned int MessageFragmenter::s_mtuBytes = MessageFragmenter::DEFAULT_MTU_BYTES;
+const double MessageFragmenter::REASSEMBLY_TIMEOUT_SECONDS = 5.0;
+
+//-----------------------------------------------------------------------------------
+MessageFragmenter::MessageFragmenter()
+    : m_reassembler(REASSEMBLY_TIMEOUT_SECONDS)
+    , m_nextGroupId(0)
+{
+    for (FragmentedMessageCallback& callback : m_callbacks)
+    {
+        callback = nullptr;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void MessageFragmenter::RegisterMessage(uint8_t messageType, FragmentedMessageCallback callback)
+{
+    m_callbacks[messageType] = callback;
+}
+
+//-----------------------------------------------------------------------------------
+//Everything fits in one fragment most of the time, in which case this costs a 7 byte header over sending it directly.
+void MessageFragmenter::SendMessage(NetConnection* cp, uint8_t messageType, const MessageBuffer& payload)
+{
+    unsigned int fragmentBytes = GetMaxFragmentBytes();
+    unsigned int numFragments = payload.GetSize() == 0 ? 1 : (payload.GetSize() + fragmentBytes - 1) / fragmentBytes;
+    ASSERT_OR_DIE(numFragments <= FragmentReassembler::MAX_FRAGMENTS, "Message is too large to send even in fragments");
+
+    uint16_t groupId = m_nextGroupId++;
+    const uint8_t* data = payload.GetData();
+    for (unsigned int fragmentIndex = 0; fragmentIndex < numFragments; ++fragmentIndex)
+    {
+        unsigned int offset = fragmentIndex * fragmentBytes;
+        unsigned int size = payload.GetSize() - offset < fragmentBytes ? payload.GetSize() - offset : fragmentBytes;
+        NetMessage fragment(GameNetMessages::MESSAGE_FRAGMENT);
+        fragment.Write<uint8_t>(messageType);
+        fragment.Write<uint16_t>(groupId);
+        fragment.Write<uint8_t>((uint8_t)fragmentIndex);
+        fragment.Write<uint8_t>((uint8_t)numFragments);
+        fragment.Write<uint16_t>((uint16_t)size);
+        for (unsigned int i = 0; i < size; ++i)
+        {
+            fragment.Write<uint8_t>(data[offset + i]);
+        }
+        cp->SendMessage(fragment);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void MessageFragmenter::OnMessageFragment(const NetSender& from, NetMessage& message)
+{
+    if (!from.connection)
+    {
+        return;
+    }
+    uint8_t messageType = 0;
+    uint16_t groupId = 0;
+    uint8_t fragmentIndex = 0;
+    uint8_t numFragments = 0;
+    uint16_t size = 0;
+    message.Read<uint8_t>(messageType);
+    message.Read<uint16_t>(groupId);
+    message.Read<uint8_t>(fragmentIndex);
+    message.Read<uint8_t>(numFragments);
+    message.Read<uint16_t>(size);
+    if (size > GetMaxMessageBytes())
+    {
+        return;
+    }
+
+    uint8_t data[MAX_MTU_BYTES];
+    for (unsigned int i = 0; i < size; ++i)
+    {
+        message.Read<uint8_t>(data[i]);
+    }
+    uint8_t completedType = 0;
+    if (m_reassembler.AddFragment(from.connection->m_index, messageType, groupId, fragmentIndex, numFragments, data, size, GetCurrentTimeSeconds(), completedType, m_completed))
+    {
+        FragmentedMessageCallback callback = m_callbacks[completedType];
+        if (callback)
+        {
+            callback(from, m_completed);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void MessageFragmenter::OnConnectionLeave(NetConnection* cp)
+{
+    m_reassembler.DropSender(cp->m_index);
+}
+
+//-----------------------------------------------------------------------------------
+//The most one message can carry and still go out as a single unfragmented datagram.
+unsigned int MessageFragmenter::GetMaxMessageBytes()
+{
+    return s_mtuBytes - UDP_IP_HEADER_BYTES - PACKET_OVERHEAD_BYTES;
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int MessageFragmenter::GetMaxFragmentBytes()
+{
+    return GetMaxMessageBytes() - FRAGMENT_HEADER_BYTES;
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(netmtu)
+{
+    if (!args.HasArgs(1))
+    {
+        Console::instance->PrintLine(Stringf("netmtu <bytes>: currently %u, fragments carry up to %u bytes", MessageFragmenter::s_mtuBytes, MessageFragmenter::GetMaxFragmentBytes()), RGBA::WHITE);
+        return;
+    }
+    int mtuBytes = atoi(args.GetStringArgument(0).c_str());
+    if (mtuBytes < (int)MessageFragmenter::MIN_MTU_BYTES || mtuBytes > (int)MessageFragmenter::MAX_MTU_BYTES)
+    {
+        Console::instance->PrintLine(Stringf("MTU must be between %u and %u bytes.", MessageFragmenter::MIN_MTU_BYTES, MessageFragmenter::MAX_MTU_BYTES), RGBA::RED);
+        return;
+    }
+    MessageFragmenter::s_mtuBytes = (unsigned int)mtuBytes;
+    Console::instance->PrintLine(Stringf("MTU set to %u bytes.", MessageFragmenter::s_mtuBytes), RGBA::WHITE);
+}
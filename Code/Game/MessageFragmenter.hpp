@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+#include "Game/Net/FragmentReassembler.hpp"
+#include "Game/Net/MessageBuffer.hpp"
+
+class NetConnection;
+class NetMessage;
+struct NetSender;
+
+typedef void(*FragmentedMessageCallback)(const NetSender&, MessageBuffer&);
+
+//-----------------------------------------------------------------------------------
+//Sends reliable payloads too big for one packet as a group of MESSAGE_FRAGMENTs, each sized to the configured MTU, and
+//puts them back together on the far side before handing them to the handler registered for their type. Relying on IP
+//fragmentation instead would lose the whole datagram to any one lost piece, with nothing to resend.
+//Unreliable traffic shouldn't come through here: a snapshot is better split into pieces that each stand on their own.
+class MessageFragmenter
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    MessageFragmenter();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void RegisterMessage(uint8_t messageType, FragmentedMessageCallback callback);
+    void SendMessage(NetConnection* cp, uint8_t messageType, const MessageBuffer& payload);
+    void OnMessageFragment(const NetSender& from, NetMessage& message);
+    void OnConnectionLeave(NetConnection* cp);
+    inline const FragmentReassembler& GetReassembler() const { return m_reassembler; };
+    static unsigned int GetMaxMessageBytes();
+    static unsigned int GetMaxFragmentBytes();
+
+    static MessageFragmenter* instance;
+    static unsigned int s_mtuBytes;
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int DEFAULT_MTU_BYTES = 1200; //Leaves room for tunnels and VPNs under a 1500 byte Ethernet MTU.
+    static const unsigned int MIN_MTU_BYTES = 576; //The smallest datagram every IPv4 host must accept.
+    static const unsigned int MAX_MTU_BYTES = 1500;
+    static const unsigned int UDP_IP_HEADER_BYTES = 28;
+    static const unsigned int PACKET_OVERHEAD_BYTES = 16; //Allowance for the session's packet and message headers.
+    static const unsigned int FRAGMENT_HEADER_BYTES = 7;
+    static const double REASSEMBLY_TIMEOUT_SECONDS;
+
+private:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    FragmentReassembler m_reassembler;
+    FragmentedMessageCallback m_callbacks[256];
+    MessageBuffer m_completed;
+    uint16_t m_nextGroupId;
+};
@@ -0,0 +1,20 @@
+#include "Game/NameID.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <map>
+#include <string>
+
+//-----------------------------------------------------------------------------------
+NameID NameID::Register(const char* name)
+{
+    NameID id(name);
+#if defined(_DEBUG)
+    static std::map<uint32_t, std::string> s_registeredNames;
+    auto inserted = s_registeredNames.insert(std::make_pair(id.m_hash, std::string(name)));
+    if (!inserted.second && inserted.first->second != name)
+    {
+        ERROR_AND_DIE(Stringf("NameID collision: \"%s\" and \"%s\" both hash to %08x", inserted.first->second.c_str(), name, id.m_hash));
+    }
+#endif
+    return id;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------
+//32-bit FNV-1a of a resource or input name. Constructing one from a literal in a constexpr context costs nothing at
+//runtime, so hot paths can key tables by ID instead of hashing and comparing std::strings.
+class NameID
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    constexpr NameID() : m_hash(0) {};
+    constexpr explicit NameID(const char* name) : m_hash(Hash(name, OFFSET_BASIS)) {};
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    inline constexpr uint32_t GetHash() const { return m_hash; };
+    inline constexpr bool operator==(const NameID& other) const { return m_hash == other.m_hash; };
+    inline constexpr bool operator!=(const NameID& other) const { return m_hash != other.m_hash; };
+    inline constexpr bool operator<(const NameID& other) const { return m_hash < other.m_hash; };
+
+    //Debug builds remember every registered name and die if two different ones share an ID. Release does nothing.
+    static NameID Register(const char* name);
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const uint32_t OFFSET_BASIS = 2166136261u;
+    static const uint32_t PRIME = 16777619u;
+
+private:
+    //Single-expression recursion, so it's still a valid constexpr function under VS2015's C++11 rules.
+    static constexpr uint32_t Hash(const char* name, uint32_t hash)
+    {
+        return *name == '\0' ? hash : Hash(name + 1, (hash ^ (uint32_t)(uint8_t)*name) * PRIME);
+    }
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    uint32_t m_hash;
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "Game/NameID.hpp"
+
+//-----------------------------------------------------------------------------------
+//Sorted NameID to pointer table. Filled once while loading, after which lookups are a binary search over IDs.
+template <typename T>
+class NameTable
+{
+public:
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Register(const char* name, T* value)
+    {
+        Entry entry = { NameID::Register(name), value };
+        auto found = std::lower_bound(m_entries.begin(), m_entries.end(), entry);
+        if (found != m_entries.end() && found->m_id == entry.m_id)
+        {
+            found->m_value = value;
+            return;
+        }
+        m_entries.insert(found, entry);
+    }
+
+    T* Find(NameID id) const
+    {
+        Entry key = { id, nullptr };
+        auto found = std::lower_bound(m_entries.begin(), m_entries.end(), key);
+        return (found != m_entries.end() && found->m_id == id) ? found->m_value : nullptr;
+    }
+
+    inline void Clear() { m_entries.clear(); };
+
+private:
+    struct Entry
+    {
+        NameID m_id;
+        T* m_value;
+        inline bool operator<(const Entry& other) const { return m_id < other.m_id; };
+    };
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<Entry> m_entries;
+};
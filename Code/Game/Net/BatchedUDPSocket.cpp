@@ -0,0 +1,353 @@
+#include "Game/Net/BatchedUDPSocket.hpp"
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103 //Older glibc headers predate GSO; the kernel still understands it from 4.18.
+#endif
+
+//-----------------------------------------------------------------------------------
+static const int SOCKET_BUFFER_BYTES = 4 * 1024 * 1024;
+static const size_t SEGMENT_CONTROL_BYTES = CMSG_SPACE(sizeof(uint16_t));
+
+//-----------------------------------------------------------------------------------
+static bool IsSameAddress(const PacketAddress& first, const PacketAddress& second)
+{
+    return first.m_length == second.m_length && memcmp(&first.m_storage, &second.m_storage, first.m_length) == 0;
+}
+
+//-----------------------------------------------------------------------------------
+static bool IsWouldBlock(int error)
+{
+    return error == EAGAIN || error == EWOULDBLOCK;
+}
+
+//-----------------------------------------------------------------------------------
+BatchedUDPSocket::BatchedUDPSocket(Mode mode, unsigned int ringCapacity)
+    : m_mode(mode)
+    , m_socket(-1)
+    , m_isSegmenting(false)
+    , m_received(ringCapacity)
+    , m_queued(ringCapacity)
+    , m_messages(MAX_MESSAGES_PER_CALL)
+    , m_iovecs(MAX_MESSAGES_PER_CALL * MAX_SEGMENTS_PER_MESSAGE)
+    , m_controls(MAX_MESSAGES_PER_CALL * SEGMENT_CONTROL_BYTES)
+    , m_messagePackets(MAX_MESSAGES_PER_CALL)
+    , m_numSyscalls(0)
+    , m_numDropped(0)
+{
+}
+
+//-----------------------------------------------------------------------------------
+BatchedUDPSocket::~BatchedUDPSocket()
+{
+    Close();
+}
+
+//-----------------------------------------------------------------------------------
+//Binds a non-blocking IPv4 socket. A null hostName binds every interface; port "0" lets the OS pick.
+bool BatchedUDPSocket::Open(const char* hostName, const char* port)
+{
+    Close();
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(hostName, port, &hints, &addresses) != 0 || !addresses)
+    {
+        return false;
+    }
+
+    m_socket = socket(addresses->ai_family, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP);
+    bool isBound = m_socket >= 0 && bind(m_socket, addresses->ai_addr, addresses->ai_addrlen) == 0;
+    freeaddrinfo(addresses);
+    if (!isBound)
+    {
+        Close();
+        return false;
+    }
+
+    //A host hears from every client at once, so give the kernel room to hold a whole tick's worth between drains.
+    setsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, &SOCKET_BUFFER_BYTES, sizeof(SOCKET_BUFFER_BYTES));
+    setsockopt(m_socket, SOL_SOCKET, SO_SNDBUF, &SOCKET_BUFFER_BYTES, sizeof(SOCKET_BUFFER_BYTES));
+
+    m_localAddress.m_length = sizeof(m_localAddress.m_storage);
+    getsockname(m_socket, (sockaddr*)&m_localAddress.m_storage, &m_localAddress.m_length);
+
+    //Kernels without GSO reject the option outright.
+    int segmentSize = 0;
+    socklen_t optionLength = sizeof(segmentSize);
+    m_isSegmenting = m_mode == BATCHED_MODE && getsockopt(m_socket, SOL_UDP, UDP_SEGMENT, &segmentSize, &optionLength) == 0;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+void BatchedUDPSocket::Close()
+{
+    if (m_socket >= 0)
+    {
+        close(m_socket);
+        m_socket = -1;
+    }
+    m_received.Clear();
+    m_queued.Clear();
+    m_isSegmenting = false;
+}
+
+//-----------------------------------------------------------------------------------
+//Drains whatever the kernel is holding into the receive ring, until either runs out. Callers Pop what they've read.
+unsigned int BatchedUDPSocket::Receive()
+{
+    if (m_socket < 0)
+    {
+        return 0;
+    }
+    return m_mode == BATCHED_MODE ? ReceiveBatched() : ReceivePerPacket();
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int BatchedUDPSocket::ReceivePerPacket()
+{
+    unsigned int numReceived = 0;
+    while (m_received.GetNumFree() > 0)
+    {
+        Packet& packet = m_received.GetFreeSlot(0);
+        packet.m_address.m_length = sizeof(packet.m_address.m_storage);
+        ++m_numSyscalls;
+        ssize_t size = recvfrom(m_socket, packet.m_data, Packet::MAX_SIZE, 0, (sockaddr*)&packet.m_address.m_storage, &packet.m_address.m_length);
+        if (size < 0)
+        {
+            break;
+        }
+        packet.m_size = (uint16_t)size;
+        m_received.CommitFreeSlots(1);
+        ++numReceived;
+    }
+    return numReceived;
+}
+
+//-----------------------------------------------------------------------------------
+//Each message reads straight into a free ring slot, so there's no copy between the kernel and the caller.
+unsigned int BatchedUDPSocket::ReceiveBatched()
+{
+    unsigned int numReceived = 0;
+    while (m_received.GetNumFree() > 0)
+    {
+        unsigned int numMessages = m_received.GetNumFree() < MAX_MESSAGES_PER_CALL ? m_received.GetNumFree() : MAX_MESSAGES_PER_CALL;
+        for (unsigned int i = 0; i < numMessages; ++i)
+        {
+            Packet& packet = m_received.GetFreeSlot(i);
+            m_iovecs[i].iov_base = packet.m_data;
+            m_iovecs[i].iov_len = Packet::MAX_SIZE;
+            msghdr& header = m_messages[i].msg_hdr;
+            memset(&header, 0, sizeof(header));
+            header.msg_name = &packet.m_address.m_storage;
+            header.msg_namelen = sizeof(packet.m_address.m_storage);
+            header.msg_iov = &m_iovecs[i];
+            header.msg_iovlen = 1;
+        }
+
+        ++m_numSyscalls;
+        int numRead = recvmmsg(m_socket, m_messages.data(), numMessages, MSG_DONTWAIT, nullptr);
+        if (numRead <= 0)
+        {
+            break;
+        }
+        for (int i = 0; i < numRead; ++i)
+        {
+            Packet& packet = m_received.GetFreeSlot(i);
+            packet.m_size = (uint16_t)m_messages[i].msg_len;
+            packet.m_address.m_length = m_messages[i].msg_hdr.msg_namelen;
+        }
+        m_received.CommitFreeSlots(numRead);
+        numReceived += numRead;
+        if ((unsigned int)numRead < numMessages)
+        {
+            break; //Short read means the kernel queue is empty.
+        }
+    }
+    return numReceived;
+}
+
+//-----------------------------------------------------------------------------------
+//Copies the payload into the send ring. A full ring flushes early rather than dropping.
+bool BatchedUDPSocket::QueueSend(const PacketAddress& to, const void* data, uint16_t size)
+{
+    if (size > Packet::MAX_SIZE)
+    {
+        ++m_numDropped;
+        return false;
+    }
+    Packet* packet = m_queued.Push();
+    if (!packet)
+    {
+        Flush();
+        packet = m_queued.Push();
+        if (!packet)
+        {
+            ++m_numDropped;
+            return false;
+        }
+    }
+    memcpy(packet->m_data, data, size);
+    packet->m_size = size;
+    packet->m_address = to;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+//Sends everything queued since the last flush and returns how many packets went out. If the kernel's send buffer
+//fills, whatever is left stays queued for the next flush.
+unsigned int BatchedUDPSocket::Flush()
+{
+    if (m_socket < 0)
+    {
+        m_queued.Clear();
+        return 0;
+    }
+    return m_mode == BATCHED_MODE ? FlushBatched() : FlushPerPacket();
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int BatchedUDPSocket::FlushPerPacket()
+{
+    unsigned int numSent = 0;
+    while (m_queued.GetCount() > 0)
+    {
+        Packet& packet = m_queued.GetPacket(0);
+        ++m_numSyscalls;
+        if (sendto(m_socket, packet.m_data, packet.m_size, 0, (const sockaddr*)&packet.m_address.m_storage, packet.m_address.m_length) < 0)
+        {
+            if (IsWouldBlock(errno))
+            {
+                break;
+            }
+            ++m_numDropped;
+        }
+        else
+        {
+            ++numSent;
+        }
+        m_queued.Pop(1);
+    }
+    return numSent;
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int BatchedUDPSocket::FlushBatched()
+{
+    unsigned int numSent = 0;
+    while (m_queued.GetCount() > 0)
+    {
+        unsigned int numPackets = 0;
+        unsigned int numMessages = BuildMessages(numPackets);
+
+        ++m_numSyscalls;
+        int numWritten = sendmmsg(m_socket, m_messages.data(), numMessages, 0);
+        if (numWritten < 0)
+        {
+            int error = errno;
+            if (IsWouldBlock(error))
+            {
+                break;
+            }
+            if (error == EIO && m_isSegmenting)
+            {
+                //The NIC or driver can't checksum segmented sends. Fall back to a message per packet for good.
+                m_isSegmenting = false;
+                continue;
+            }
+            //Anything else is particular to the first message (an unreachable address, say), so drop it and carry on.
+            m_numDropped += m_messagePackets[0];
+            m_queued.Pop(m_messagePackets[0]);
+            continue;
+        }
+
+        unsigned int numPacketsWritten = 0;
+        for (int i = 0; i < numWritten; ++i)
+        {
+            numPacketsWritten += m_messagePackets[i];
+        }
+        m_queued.Pop(numPacketsWritten);
+        numSent += numPacketsWritten;
+        if (numWritten == 0)
+        {
+            break;
+        }
+    }
+    return numSent;
+}
+
+//-----------------------------------------------------------------------------------
+//Fills m_messages from the front of the send queue. Without GSO that's one message per packet. With it, a run of
+//packets to the same address where every packet but the last is the same size becomes one message: the kernel gets
+//the payloads back to back and cuts them apart again at that size.
+unsigned int BatchedUDPSocket::BuildMessages(unsigned int& outNumPackets)
+{
+    unsigned int numQueued = m_queued.GetCount();
+    unsigned int numMessages = 0;
+    unsigned int numIovecs = 0;
+    outNumPackets = 0;
+    while (outNumPackets < numQueued && numMessages < MAX_MESSAGES_PER_CALL)
+    {
+        Packet& first = m_queued.GetPacket(outNumPackets);
+        iovec* iovecs = &m_iovecs[numIovecs];
+        unsigned int runLength = 1;
+        unsigned int runBytes = first.m_size;
+        iovecs[0].iov_base = first.m_data;
+        iovecs[0].iov_len = first.m_size;
+        if (m_isSegmenting && first.m_size > 0)
+        {
+            while (outNumPackets + runLength < numQueued && runLength < MAX_SEGMENTS_PER_MESSAGE)
+            {
+                Packet& next = m_queued.GetPacket(outNumPackets + runLength);
+                if (next.m_size > first.m_size || runBytes + next.m_size > MAX_SEGMENTED_BYTES || !IsSameAddress(next.m_address, first.m_address))
+                {
+                    break;
+                }
+                iovecs[runLength].iov_base = next.m_data;
+                iovecs[runLength].iov_len = next.m_size;
+                runBytes += next.m_size;
+                ++runLength;
+                if (next.m_size < first.m_size)
+                {
+                    break; //A short segment can only come last.
+                }
+            }
+        }
+
+        msghdr& header = m_messages[numMessages].msg_hdr;
+        memset(&header, 0, sizeof(header));
+        header.msg_name = &first.m_address.m_storage;
+        header.msg_namelen = first.m_address.m_length;
+        header.msg_iov = iovecs;
+        header.msg_iovlen = runLength;
+        if (runLength > 1)
+        {
+            header.msg_control = &m_controls[numMessages * SEGMENT_CONTROL_BYTES];
+            header.msg_controllen = SEGMENT_CONTROL_BYTES;
+            cmsghdr* control = CMSG_FIRSTHDR(&header);
+            control->cmsg_level = SOL_UDP;
+            control->cmsg_type = UDP_SEGMENT;
+            control->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            uint16_t segmentSize = first.m_size;
+            memcpy(CMSG_DATA(control), &segmentSize, sizeof(segmentSize));
+        }
+
+        m_messagePackets[numMessages] = runLength;
+        numIovecs += runLength;
+        outNumPackets += runLength;
+        ++numMessages;
+    }
+    return numMessages;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "Game/Net/PacketRing.hpp"
+#include <vector>
+#include <sys/uio.h>
+
+//-----------------------------------------------------------------------------------
+//Linux UDP transport for a host talking to many clients. Receive() drains everything waiting with recvmmsg, and sends
+//queue up over a tick so Flush() can hand them all to the kernel in one sendmmsg. Where the kernel supports UDP GSO,
+//runs of same-sized packets to the same address go down as a single segmented message. PER_PACKET_MODE does one
+//recvfrom/sendto per packet instead, the way the session's socket does today, as the baseline to measure against.
+//Linux only, so it isn't part of the Win32 project.
+class BatchedUDPSocket
+{
+public:
+    enum Mode
+    {
+        PER_PACKET_MODE,
+        BATCHED_MODE
+    };
+
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    BatchedUDPSocket(Mode mode, unsigned int ringCapacity = DEFAULT_RING_CAPACITY);
+    ~BatchedUDPSocket();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    bool Open(const char* hostName, const char* port);
+    void Close();
+    unsigned int Receive();
+    bool QueueSend(const PacketAddress& to, const void* data, uint16_t size);
+    unsigned int Flush();
+    inline PacketRing& GetReceived() { return m_received; };
+    inline const PacketAddress& GetLocalAddress() const { return m_localAddress; };
+    inline bool IsSegmenting() const { return m_isSegmenting; };
+    inline unsigned int GetNumSyscalls() const { return m_numSyscalls; };
+    inline unsigned int GetNumDropped() const { return m_numDropped; };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int DEFAULT_RING_CAPACITY = 1024;
+    static const unsigned int MAX_MESSAGES_PER_CALL = 64;
+    static const unsigned int MAX_SEGMENTS_PER_MESSAGE = 64; //Kernel's UDP_MAX_SEGMENTS on older kernels.
+    static const unsigned int MAX_SEGMENTED_BYTES = 65000; //Under the 64k a single UDP datagram can carry before splitting.
+
+private:
+    BatchedUDPSocket(const BatchedUDPSocket&) = delete;
+    BatchedUDPSocket& operator= (const BatchedUDPSocket&) = delete;
+
+    unsigned int ReceivePerPacket();
+    unsigned int ReceiveBatched();
+    unsigned int FlushPerPacket();
+    unsigned int FlushBatched();
+    unsigned int BuildMessages(unsigned int& outNumPackets);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    Mode m_mode;
+    int m_socket;
+    bool m_isSegmenting;
+    PacketAddress m_localAddress;
+    PacketRing m_received;
+    PacketRing m_queued; //Sends waiting for Flush().
+    std::vector<mmsghdr> m_messages;
+    std::vector<iovec> m_iovecs; //Receives use one per message, segmented sends one per packet in the message.
+    std::vector<uint8_t> m_controls; //One UDP_SEGMENT control message per outgoing message.
+    std::vector<unsigned int> m_messagePackets; //How many queued packets each built message covers.
+    unsigned int m_numSyscalls;
+    unsigned int m_numDropped;
+};
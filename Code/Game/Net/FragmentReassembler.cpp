@@ -0,0 +1,120 @@
+#include "Game/Net/FragmentReassembler.hpp"
+
+//-----------------------------------------------------------------------------------
+FragmentReassembler::FragmentReassembler(double timeoutSeconds)
+    : m_timeoutSeconds(timeoutSeconds)
+    , m_numExpired(0)
+{
+    for (PendingMessage& pending : m_pending)
+    {
+        pending.m_isActive = false;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Returns true when this fragment completes its message, with the whole payload in outPayload. Duplicates (a reliable
+//resend of a fragment we already have) and fragments that disagree with the rest of their group are ignored.
+bool FragmentReassembler::AddFragment(uint8_t senderIndex, uint8_t messageType, uint16_t groupId, uint8_t fragmentIndex, uint8_t numFragments,
+    const uint8_t* data, unsigned int size, double currentTimeSeconds, uint8_t& outMessageType, MessageBuffer& outPayload)
+{
+    if (numFragments == 0 || numFragments > MAX_FRAGMENTS || fragmentIndex >= numFragments)
+    {
+        return false;
+    }
+    ExpireStale(currentTimeSeconds);
+
+    PendingMessage& pending = FindOrStart(senderIndex, messageType, groupId, numFragments, currentTimeSeconds);
+    uint64_t fragmentBit = 1ull << fragmentIndex;
+    if (pending.m_numFragments != numFragments || pending.m_messageType != messageType || (pending.m_receivedMask & fragmentBit) != 0)
+    {
+        return false;
+    }
+    pending.m_fragments[fragmentIndex].assign(data, data + size);
+    pending.m_receivedMask |= fragmentBit;
+    ++pending.m_numReceived;
+    if (pending.m_numReceived < pending.m_numFragments)
+    {
+        return false;
+    }
+
+    outMessageType = pending.m_messageType;
+    outPayload.Clear();
+    for (unsigned int i = 0; i < pending.m_numFragments; ++i)
+    {
+        outPayload.WriteBytes(pending.m_fragments[i].data(), (unsigned int)pending.m_fragments[i].size());
+    }
+    pending.m_isActive = false;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+void FragmentReassembler::ExpireStale(double currentTimeSeconds)
+{
+    for (PendingMessage& pending : m_pending)
+    {
+        if (pending.m_isActive && currentTimeSeconds - pending.m_startTimeSeconds > m_timeoutSeconds)
+        {
+            pending.m_isActive = false;
+            ++m_numExpired;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Half-built messages from someone who has left will never finish.
+void FragmentReassembler::DropSender(uint8_t senderIndex)
+{
+    for (PendingMessage& pending : m_pending)
+    {
+        if (pending.m_isActive && pending.m_senderIndex == senderIndex)
+        {
+            pending.m_isActive = false;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int FragmentReassembler::GetNumPending() const
+{
+    unsigned int numPending = 0;
+    for (const PendingMessage& pending : m_pending)
+    {
+        if (pending.m_isActive)
+        {
+            ++numPending;
+        }
+    }
+    return numPending;
+}
+
+//-----------------------------------------------------------------------------------
+//With every slot busy, the oldest message gives up its slot: it's the one most likely to have lost a fragment for good.
+FragmentReassembler::PendingMessage& FragmentReassembler::FindOrStart(uint8_t senderIndex, uint8_t messageType, uint16_t groupId, uint8_t numFragments, double currentTimeSeconds)
+{
+    PendingMessage* slot = nullptr;
+    for (PendingMessage& pending : m_pending)
+    {
+        if (pending.m_isActive && pending.m_senderIndex == senderIndex && pending.m_groupId == groupId)
+        {
+            return pending;
+        }
+        if (!slot || (slot->m_isActive && (!pending.m_isActive || pending.m_startTimeSeconds < slot->m_startTimeSeconds)))
+        {
+            slot = &pending;
+        }
+    }
+
+    if (slot->m_isActive)
+    {
+        ++m_numExpired;
+    }
+    slot->m_isActive = true;
+    slot->m_senderIndex = senderIndex;
+    slot->m_messageType = messageType;
+    slot->m_groupId = groupId;
+    slot->m_numFragments = numFragments;
+    slot->m_numReceived = 0;
+    slot->m_receivedMask = 0;
+    slot->m_startTimeSeconds = currentTimeSeconds;
+    return *slot;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "Game/Net/MessageBuffer.hpp"
+
+//-----------------------------------------------------------------------------------
+//Collects the numbered fragments of messages split by MessageFragmenter, keyed by sender and fragment group, and hands
+//back the payload once every fragment has arrived. A fixed number of messages can be in flight at once; any that stall
+//past the timeout (or get pushed out by newer ones) are thrown away along with their fragments.
+class FragmentReassembler
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    FragmentReassembler(double timeoutSeconds);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    bool AddFragment(uint8_t senderIndex, uint8_t messageType, uint16_t groupId, uint8_t fragmentIndex, uint8_t numFragments,
+        const uint8_t* data, unsigned int size, double currentTimeSeconds, uint8_t& outMessageType, MessageBuffer& outPayload);
+    void ExpireStale(double currentTimeSeconds);
+    void DropSender(uint8_t senderIndex);
+    inline unsigned int GetNumExpired() const { return m_numExpired; };
+    unsigned int GetNumPending() const;
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int MAX_PENDING_MESSAGES = 16;
+    static const unsigned int MAX_FRAGMENTS = 64; //One bit each in the received mask.
+
+private:
+    struct PendingMessage
+    {
+        bool m_isActive;
+        uint8_t m_senderIndex;
+        uint8_t m_messageType;
+        uint16_t m_groupId;
+        uint8_t m_numFragments;
+        uint8_t m_numReceived;
+        uint64_t m_receivedMask;
+        double m_startTimeSeconds;
+        std::vector<uint8_t> m_fragments[MAX_FRAGMENTS]; //Kept between messages so reassembly stops allocating once warm.
+    };
+
+    PendingMessage& FindOrStart(uint8_t senderIndex, uint8_t messageType, uint16_t groupId, uint8_t numFragments, double currentTimeSeconds);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    double m_timeoutSeconds;
+    unsigned int m_numExpired;
+    PendingMessage m_pending[MAX_PENDING_MESSAGES];
+};
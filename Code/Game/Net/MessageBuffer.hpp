@@ -0,0 +1,49 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+//Growable byte buffer with the same Write/Read calls as NetMessage, for payloads that can outgrow a single message and
+//go through MessageFragmenter instead. Reads past the end come back zeroed rather than reading garbage.
+class MessageBuffer
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    MessageBuffer() : m_readOffset(0) {};
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    template <typename T>
+    inline void Write(const T& value) { WriteBytes(&value, sizeof(T)); };
+    template <typename T>
+    inline bool Read(T& outValue) { return ReadBytes(&outValue, sizeof(T)); };
+    inline const uint8_t* GetData() const { return m_bytes.data(); };
+    inline unsigned int GetSize() const { return (unsigned int)m_bytes.size(); };
+    inline void Clear() { m_bytes.clear(); m_readOffset = 0; };
+
+    //-----------------------------------------------------------------------------------
+    inline void WriteBytes(const void* data, unsigned int size)
+    {
+        const uint8_t* bytes = (const uint8_t*)data;
+        m_bytes.insert(m_bytes.end(), bytes, bytes + size);
+    }
+
+    //-----------------------------------------------------------------------------------
+    inline bool ReadBytes(void* outData, unsigned int size)
+    {
+        if (m_readOffset + size > m_bytes.size())
+        {
+            memset(outData, 0, size);
+            m_readOffset = (unsigned int)m_bytes.size();
+            return false;
+        }
+        memcpy(outData, &m_bytes[m_readOffset], size);
+        m_readOffset += size;
+        return true;
+    }
+
+private:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<uint8_t> m_bytes;
+    unsigned int m_readOffset;
+};
@@ -0,0 +1,39 @@
+#include "Game/Net/PacketRing.hpp"
+
+//-----------------------------------------------------------------------------------
+//Capacity is rounded up to a power of two, so wrapping is a mask.
+static unsigned int RoundUpToPowerOfTwo(unsigned int value)
+{
+    unsigned int powerOfTwo = 1;
+    while (powerOfTwo < value)
+    {
+        powerOfTwo <<= 1;
+    }
+    return powerOfTwo;
+}
+
+//-----------------------------------------------------------------------------------
+PacketRing::PacketRing(unsigned int capacity)
+    : m_packets(RoundUpToPowerOfTwo(capacity))
+    , m_head(0)
+    , m_tail(0)
+{
+    m_mask = (unsigned int)m_packets.size() - 1;
+}
+
+//-----------------------------------------------------------------------------------
+//Returns null when the ring is full.
+Packet* PacketRing::Push()
+{
+    if (GetNumFree() == 0)
+    {
+        return nullptr;
+    }
+    return &m_packets[m_tail++ & m_mask];
+}
+
+//-----------------------------------------------------------------------------------
+void PacketRing::Pop(unsigned int count)
+{
+    m_head += count < GetCount() ? count : GetCount();
+}
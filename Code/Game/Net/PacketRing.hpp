@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <sys/socket.h>
+
+//-----------------------------------------------------------------------------------
+struct PacketAddress
+{
+    PacketAddress() : m_length(0) {};
+
+    sockaddr_storage m_storage;
+    socklen_t m_length;
+};
+
+//-----------------------------------------------------------------------------------
+struct Packet
+{
+    static const unsigned int MAX_SIZE = 1472; //Largest UDP payload that fits an Ethernet MTU unfragmented.
+
+    uint8_t m_data[MAX_SIZE];
+    uint16_t m_size;
+    PacketAddress m_address;
+};
+
+//-----------------------------------------------------------------------------------
+//Fixed ring of packet buffers, allocated once. Sockets receive straight into the free slots and send straight out of
+//the queued ones, so moving a packet through the transport never touches the heap.
+class PacketRing
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    PacketRing(unsigned int capacity);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    Packet* Push();
+    void Pop(unsigned int count);
+    inline void Clear() { m_head = m_tail = 0; };
+    inline Packet& GetPacket(unsigned int index) { return m_packets[(m_head + index) & m_mask]; };
+    inline Packet& GetFreeSlot(unsigned int index) { return m_packets[(m_tail + index) & m_mask]; };
+    inline void CommitFreeSlots(unsigned int count) { m_tail += count; };
+    inline unsigned int GetCount() const { return m_tail - m_head; };
+    inline unsigned int GetNumFree() const { return GetCapacity() - GetCount(); };
+    inline unsigned int GetCapacity() const { return (unsigned int)m_packets.size(); };
+
+private:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<Packet> m_packets;
+    unsigned int m_mask;
+    unsigned int m_head; //Free-running, wrapped by m_mask on access.
+    unsigned int m_tail;
+};
@@ -0,0 +1,192 @@
+#include "Game/Net/RangeCoder.hpp"
+
+static const uint32_t TOP_VALUE = 1u << 24; //Below this the range has lost a byte of precision and is shifted back up.
+
+//-----------------------------------------------------------------------------------
+RangeEncoder::RangeEncoder(uint8_t* buffer, unsigned int capacity)
+    : m_low(0)
+    , m_range(0xFFFFFFFF)
+    , m_cache(0)
+    , m_cacheSize(1)
+    , m_isFirstByte(true)
+    , m_hasOverflowed(false)
+    , m_buffer(buffer)
+    , m_capacity(capacity)
+    , m_size(0)
+{
+}
+
+//-----------------------------------------------------------------------------------
+void RangeEncoder::Encode(uint32_t cumulativeFrequency, uint32_t frequency)
+{
+    uint32_t step = m_range >> PROBABILITY_BITS;
+    m_low += (uint64_t)step * cumulativeFrequency;
+    m_range = step * frequency;
+    while (m_range < TOP_VALUE)
+    {
+        m_range <<= 8;
+        ShiftLow();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Equally likely values, for the low bits of large deltas where a model wouldn't earn its keep.
+void RangeEncoder::EncodeBits(uint32_t value, unsigned int numBits)
+{
+    m_range >>= numBits;
+    m_low += (uint64_t)m_range * value;
+    while (m_range < TOP_VALUE)
+    {
+        m_range <<= 8;
+        ShiftLow();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Flushes what's left of low and returns the encoded size. Check HasOverflowed() for whether it all fit.
+unsigned int RangeEncoder::Finish()
+{
+    for (int i = 0; i < 5; ++i)
+    {
+        ShiftLow();
+    }
+    while (m_size > 0 && m_buffer[m_size - 1] == 0)
+    {
+        --m_size;
+    }
+    return m_size;
+}
+
+//-----------------------------------------------------------------------------------
+//Holds back the top byte, and any run of 0xFFs after it, until it's known whether a carry will bump them.
+void RangeEncoder::ShiftLow()
+{
+    if ((uint32_t)m_low < 0xFF000000u || (m_low >> 32) != 0)
+    {
+        uint8_t carry = (uint8_t)(m_low >> 32);
+        uint8_t pending = m_cache;
+        do
+        {
+            WriteByte((uint8_t)(pending + carry));
+            pending = 0xFF;
+        } while (--m_cacheSize != 0);
+        m_cache = (uint8_t)(m_low >> 24);
+    }
+    ++m_cacheSize;
+    m_low = (m_low & 0x00FFFFFF) << 8;
+}
+
+//-----------------------------------------------------------------------------------
+void RangeEncoder::WriteByte(uint8_t value)
+{
+    if (m_isFirstByte)
+    {
+        m_isFirstByte = false;
+        return;
+    }
+    if (m_size == m_capacity)
+    {
+        m_hasOverflowed = true;
+        return;
+    }
+    m_buffer[m_size++] = value;
+}
+
+//-----------------------------------------------------------------------------------
+RangeDecoder::RangeDecoder(const uint8_t* data, unsigned int size)
+    : m_code(0)
+    , m_range(0xFFFFFFFF)
+    , m_step(1)
+    , m_data(data)
+    , m_size(size)
+    , m_offset(0)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        m_code = (m_code << 8) | ReadByte();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Where the next symbol falls in [0, TOTAL_FREQUENCY). Has to be followed by Consume() with that symbol's range.
+uint32_t RangeDecoder::PeekFrequency()
+{
+    m_step = m_range >> RangeEncoder::PROBABILITY_BITS;
+    uint32_t frequency = m_code / m_step;
+    uint32_t maxFrequency = (1u << RangeEncoder::PROBABILITY_BITS) - 1;
+    return frequency < maxFrequency ? frequency : maxFrequency; //Only corrupt data lands past the end.
+}
+
+//-----------------------------------------------------------------------------------
+void RangeDecoder::Consume(uint32_t cumulativeFrequency, uint32_t frequency)
+{
+    m_code -= m_step * cumulativeFrequency;
+    m_range = m_step * frequency;
+    Normalize();
+}
+
+//-----------------------------------------------------------------------------------
+uint32_t RangeDecoder::DecodeBits(unsigned int numBits)
+{
+    m_range >>= numBits;
+    uint32_t value = m_code / m_range;
+    uint32_t maxValue = (1u << numBits) - 1;
+    value = value < maxValue ? value : maxValue;
+    m_code -= m_range * value;
+    Normalize();
+    return value;
+}
+
+//-----------------------------------------------------------------------------------
+void RangeDecoder::Normalize()
+{
+    while (m_range < TOP_VALUE)
+    {
+        m_code = (m_code << 8) | ReadByte();
+        m_range <<= 8;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Scales the counts to TOTAL_FREQUENCY. Every symbol keeps at least one slot, so nothing the training didn't see becomes
+//unencodable, and the rounding error goes to the most common symbol, where it costs the least.
+SymbolModel::SymbolModel(const uint32_t* counts, unsigned int numSymbols)
+    : m_numSymbols(numSymbols < MAX_SYMBOLS ? numSymbols : MAX_SYMBOLS)
+{
+    uint64_t totalCount = 0;
+    unsigned int mostCommon = 0;
+    for (unsigned int i = 0; i < m_numSymbols; ++i)
+    {
+        totalCount += counts[i];
+        mostCommon = counts[i] > counts[mostCommon] ? i : mostCommon;
+    }
+
+    uint32_t frequencies[MAX_SYMBOLS];
+    uint32_t assigned = 0;
+    uint32_t available = TOTAL_FREQUENCY - m_numSymbols;
+    for (unsigned int i = 0; i < m_numSymbols; ++i)
+    {
+        uint32_t scaled = totalCount == 0 ? 0 : (uint32_t)(((uint64_t)counts[i] * available) / totalCount);
+        frequencies[i] = 1 + scaled;
+        assigned += frequencies[i];
+    }
+    frequencies[mostCommon] += TOTAL_FREQUENCY - assigned;
+
+    m_cumulative[0] = 0;
+    for (unsigned int i = 0; i < m_numSymbols; ++i)
+    {
+        m_cumulative[i + 1] = (uint16_t)(m_cumulative[i] + frequencies[i]);
+        for (uint32_t slot = m_cumulative[i]; slot < m_cumulative[i + 1]; ++slot)
+        {
+            m_symbolLookup[slot] = (uint8_t)i;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int SymbolModel::Decode(RangeDecoder& decoder) const
+{
+    unsigned int symbol = m_symbolLookup[decoder.PeekFrequency()];
+    decoder.Consume(m_cumulative[symbol], m_cumulative[symbol + 1] - m_cumulative[symbol]);
+    return symbol;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------
+//Byte-wise range coder in the style of LZMA's, with carry propagation so no precision is lost. Every model's
+//frequencies sum to 1 << PROBABILITY_BITS, which turns the divide in the encoder into a shift.
+class RangeEncoder
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    RangeEncoder(uint8_t* buffer, unsigned int capacity);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Encode(uint32_t cumulativeFrequency, uint32_t frequency);
+    void EncodeBits(uint32_t value, unsigned int numBits);
+    unsigned int Finish();
+    inline bool HasOverflowed() const { return m_hasOverflowed; };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int PROBABILITY_BITS = 12;
+    static const unsigned int MAX_RAW_BITS = 16;
+
+private:
+    void ShiftLow();
+    void WriteByte(uint8_t value);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    uint64_t m_low;
+    uint32_t m_range;
+    uint8_t m_cache;
+    uint32_t m_cacheSize; //Pending 0xFF bytes a carry could still ripple through, plus the cached byte.
+    bool m_isFirstByte; //Always zero, so it's never written and the decoder assumes it.
+    bool m_hasOverflowed;
+    uint8_t* m_buffer;
+    unsigned int m_capacity;
+    unsigned int m_size;
+};
+
+//-----------------------------------------------------------------------------------
+//Reads past the end of the data as zeroes, which is what lets the encoder trim its trailing zero bytes.
+class RangeDecoder
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    RangeDecoder(const uint8_t* data, unsigned int size);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    uint32_t PeekFrequency();
+    void Consume(uint32_t cumulativeFrequency, uint32_t frequency);
+    uint32_t DecodeBits(unsigned int numBits);
+
+private:
+    void Normalize();
+    inline uint8_t ReadByte() { return m_offset < m_size ? m_data[m_offset++] : 0; };
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    uint32_t m_code;
+    uint32_t m_range;
+    uint32_t m_step; //Range per unit of frequency, from the last PeekFrequency().
+    const uint8_t* m_data;
+    unsigned int m_size;
+    unsigned int m_offset;
+};
+
+//-----------------------------------------------------------------------------------
+//Fixed probabilities built once from trained symbol counts. Decoding is a table lookup rather than a search, which
+//costs 4KB per model and keeps a whole snapshot in the low microseconds.
+class SymbolModel
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SymbolModel(const uint32_t* counts, unsigned int numSymbols);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    inline void Encode(RangeEncoder& encoder, unsigned int symbol) const { encoder.Encode(m_cumulative[symbol], m_cumulative[symbol + 1] - m_cumulative[symbol]); };
+    unsigned int Decode(RangeDecoder& decoder) const;
+    inline unsigned int GetNumSymbols() const { return m_numSymbols; };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int MAX_SYMBOLS = 64;
+    static const unsigned int TOTAL_FREQUENCY = 1 << RangeEncoder::PROBABILITY_BITS;
+
+private:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    unsigned int m_numSymbols;
+    uint16_t m_cumulative[MAX_SYMBOLS + 1];
+    uint8_t m_symbolLookup[TOTAL_FREQUENCY];
+};
@@ -0,0 +1,275 @@
+#include "Game/Net/SnapshotCodec.hpp"
+#include <math.h>
+
+const SnapshotFrame SnapshotFrame::EMPTY;
+const LinkRecord SnapshotCodec::DEFAULT_RECORD = { 0, 0, 0, 3, 10 * SnapshotCodec::HP_STEPS_PER_POINT }; //Facing south at full health.
+
+//-----------------------------------------------------------------------------------
+static inline unsigned int GetMagnitudeClass(uint32_t magnitude)
+{
+    unsigned int magnitudeClass = 0;
+    while (magnitude >> (magnitudeClass + 1))
+    {
+        ++magnitudeClass;
+    }
+    return magnitudeClass;
+}
+
+//-----------------------------------------------------------------------------------
+//The three ways through the symbols below: counting them for training, encoding and decoding. Sharing the one walk
+//keeps the trainer and the coder from ever disagreeing about what a symbol means.
+struct SymbolCounter
+{
+    inline void Symbol(uint32_t* counts, const SymbolModel*, unsigned int& symbol) { ++counts[symbol]; };
+    inline void Bits(uint32_t&, unsigned int) {};
+};
+
+//-----------------------------------------------------------------------------------
+struct SymbolEncoder
+{
+    inline void Symbol(uint32_t*, const SymbolModel* model, unsigned int& symbol) { model->Encode(m_encoder, symbol); };
+    inline void Bits(uint32_t& value, unsigned int numBits) { m_encoder.EncodeBits(value, numBits); };
+    RangeEncoder& m_encoder;
+};
+
+//-----------------------------------------------------------------------------------
+struct SymbolDecoder
+{
+    inline void Symbol(uint32_t*, const SymbolModel* model, unsigned int& symbol) { symbol = model->Decode(m_decoder); };
+    inline void Bits(uint32_t& value, unsigned int numBits) { value = m_decoder.DecodeBits(numBits); };
+    RangeDecoder& m_decoder;
+};
+
+//-----------------------------------------------------------------------------------
+//Codes value - baseline. Going in, value is only read; coming out of a decode, it's been written.
+template <typename Coder>
+static void CodeDelta(Coder& coder, uint32_t* counts, const SymbolModel* model, int32_t baseline, int32_t& value)
+{
+    int32_t delta = value - baseline;
+    uint32_t magnitude = (uint32_t)(delta < 0 ? -delta : delta);
+    unsigned int magnitudeClass = magnitude == 0 ? 0 : GetMagnitudeClass(magnitude);
+    unsigned int symbol = magnitude == 0 ? 0 : 1 + (2 * magnitudeClass) + (delta < 0 ? 1 : 0);
+    coder.Symbol(counts, model, symbol);
+    if (symbol == 0)
+    {
+        value = baseline;
+        return;
+    }
+
+    magnitudeClass = (symbol - 1) / 2;
+    uint32_t lowBits = 0;
+    if (magnitudeClass > 0)
+    {
+        lowBits = magnitude - (1u << magnitudeClass);
+        coder.Bits(lowBits, magnitudeClass);
+    }
+    magnitude = (1u << magnitudeClass) + lowBits;
+    value = baseline + (((symbol - 1) & 1) ? -(int32_t)magnitude : (int32_t)magnitude);
+}
+
+//-----------------------------------------------------------------------------------
+//Stops early (returning false) if a decoded slot runs off the end, which only happens to corrupt data.
+template <typename Coder>
+static bool CodeLinks(Coder& coder, SnapshotModelCounts* counts, const SymbolModel* const* models, const SnapshotFrame& baseline, SnapshotLink* links, unsigned int numLinks)
+{
+    int previousSlot = -1;
+    for (unsigned int i = 0; i < numLinks; ++i)
+    {
+        SnapshotLink& link = links[i];
+        LinkRecord& record = link.m_record;
+
+        unsigned int slotGap = link.m_slot - previousSlot - 1;
+        coder.Symbol(counts ? counts->m_slotGaps : nullptr, models[0], slotGap);
+        if (previousSlot + 1 + slotGap >= SnapshotFrame::MAX_SLOTS)
+        {
+            return false;
+        }
+        link.m_slot = (uint8_t)(previousSlot + 1 + slotGap);
+        previousSlot = link.m_slot;
+
+        //A slot whose link has changed since the baseline starts over from the default.
+        const LinkRecord* base = baseline.HasSlot(link.m_slot) ? &baseline.m_links[link.m_slot] : nullptr;
+        unsigned int isNewLink = (!base || base->m_networkId != record.m_networkId) ? 1 : 0;
+        coder.Symbol(counts ? counts->m_ids : nullptr, models[1], isNewLink);
+        if (isNewLink)
+        {
+            uint32_t networkId = record.m_networkId;
+            coder.Bits(networkId, 16);
+            record.m_networkId = (uint16_t)networkId;
+            base = &SnapshotCodec::DEFAULT_RECORD;
+        }
+        else
+        {
+            record.m_networkId = base->m_networkId;
+        }
+
+        int32_t x = record.m_x;
+        int32_t y = record.m_y;
+        CodeDelta(coder, counts ? counts->m_positionDeltas : nullptr, models[2], base->m_x, x);
+        CodeDelta(coder, counts ? counts->m_positionDeltas : nullptr, models[2], base->m_y, y);
+        record.m_x = (int16_t)x;
+        record.m_y = (int16_t)y;
+
+        unsigned int turns = (record.m_facing - base->m_facing) & 3;
+        coder.Symbol(counts ? counts->m_facings : nullptr, models[3], turns);
+        record.m_facing = (uint8_t)((base->m_facing + turns) & 3);
+
+        int32_t hp = record.m_hp;
+        CodeDelta(coder, counts ? counts->m_hpDeltas : nullptr, models[4], base->m_hp, hp);
+        record.m_hp = (uint8_t)hp;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+SnapshotCodec::SnapshotCodec(const SnapshotModelCounts& counts)
+    : m_slotGapModel(counts.m_slotGaps, SnapshotFrame::MAX_SLOTS)
+    , m_idModel(counts.m_ids, SnapshotModelCounts::NUM_ID_SYMBOLS)
+    , m_positionDeltaModel(counts.m_positionDeltas, SnapshotModelCounts::NUM_DELTA_SYMBOLS)
+    , m_facingModel(counts.m_facings, SnapshotModelCounts::NUM_FACING_SYMBOLS)
+    , m_hpDeltaModel(counts.m_hpDeltas, SnapshotModelCounts::NUM_DELTA_SYMBOLS)
+{
+}
+
+//-----------------------------------------------------------------------------------
+//Fails if it didn't fit in capacity. Zero bytes is a perfectly good result: a snapshot where nothing moved codes to
+//nothing but zeroes, and those get trimmed.
+bool SnapshotCodec::Encode(const SnapshotFrame& baseline, const SnapshotLink* links, unsigned int numLinks, uint8_t* outBuffer, unsigned int capacity, unsigned int& outSize) const
+{
+    outSize = 0;
+    if (numLinks > SnapshotFrame::MAX_SLOTS)
+    {
+        return false;
+    }
+    const SymbolModel* models[] = { &m_slotGapModel, &m_idModel, &m_positionDeltaModel, &m_facingModel, &m_hpDeltaModel };
+    RangeEncoder encoder(outBuffer, capacity);
+    SymbolEncoder coder = { encoder };
+    SnapshotLink scratch[SnapshotFrame::MAX_SLOTS];
+    for (unsigned int i = 0; i < numLinks; ++i)
+    {
+        scratch[i] = links[i];
+    }
+    CodeLinks(coder, nullptr, models, baseline, scratch, numLinks);
+    outSize = encoder.Finish();
+    return !encoder.HasOverflowed();
+}
+
+//-----------------------------------------------------------------------------------
+//Corrupt data can still decode to plausible links. Only the slots are checked, since those index the caller's arrays.
+bool SnapshotCodec::Decode(const SnapshotFrame& baseline, const uint8_t* data, unsigned int size, unsigned int numLinks, SnapshotLink* outLinks) const
+{
+    if (numLinks > SnapshotFrame::MAX_SLOTS)
+    {
+        return false;
+    }
+    const SymbolModel* models[] = { &m_slotGapModel, &m_idModel, &m_positionDeltaModel, &m_facingModel, &m_hpDeltaModel };
+    RangeDecoder decoder(data, size);
+    SymbolDecoder coder = { decoder };
+    for (unsigned int i = 0; i < numLinks; ++i)
+    {
+        outLinks[i].m_slot = 0;
+        outLinks[i].m_record = DEFAULT_RECORD;
+    }
+    return CodeLinks(coder, nullptr, models, baseline, outLinks, numLinks);
+}
+
+//-----------------------------------------------------------------------------------
+void SnapshotCodec::CountSymbols(const SnapshotFrame& baseline, const SnapshotLink* links, unsigned int numLinks, SnapshotModelCounts& counts)
+{
+    const SymbolModel* models[] = { nullptr, nullptr, nullptr, nullptr, nullptr };
+    SymbolCounter coder;
+    SnapshotLink scratch[SnapshotFrame::MAX_SLOTS];
+    for (unsigned int i = 0; i < numLinks && i < SnapshotFrame::MAX_SLOTS; ++i)
+    {
+        scratch[i] = links[i];
+    }
+    CodeLinks(coder, &counts, models, baseline, scratch, numLinks < SnapshotFrame::MAX_SLOTS ? numLinks : SnapshotFrame::MAX_SLOTS);
+}
+
+//-----------------------------------------------------------------------------------
+const SnapshotCodec& SnapshotCodec::GetTrained()
+{
+    static const SnapshotCodec s_trainedCodec(TRAINED_SNAPSHOT_MODEL);
+    return s_trainedCodec;
+}
+
+//-----------------------------------------------------------------------------------
+LinkRecord SnapshotCodec::Quantize(uint16_t networkId, float x, float y, uint8_t facing, float hp)
+{
+    float clampedHp = hp < 0.0f ? 0.0f : hp;
+    float hpSteps = floorf(clampedHp * HP_STEPS_PER_POINT + 0.5f);
+    LinkRecord record;
+    record.m_networkId = networkId;
+    record.m_x = (int16_t)floorf(x * POSITION_STEPS_PER_UNIT + 0.5f);
+    record.m_y = (int16_t)floorf(y * POSITION_STEPS_PER_UNIT + 0.5f);
+    record.m_facing = facing & 3;
+    record.m_hp = (uint8_t)(hpSteps < 255.0f ? hpSteps : 255.0f);
+    return record;
+}
+
+//-----------------------------------------------------------------------------------
+void SnapshotCodec::Dequantize(const LinkRecord& record, float& outX, float& outY, float& outHp)
+{
+    outX = (float)record.m_x / POSITION_STEPS_PER_UNIT;
+    outY = (float)record.m_y / POSITION_STEPS_PER_UNIT;
+    outHp = (float)record.m_hp / HP_STEPS_PER_POINT;
+}
+
+//-----------------------------------------------------------------------------------
+//Raw structs, so recordings only load on a machine like the one that made them. They're training input, not a format.
+void SnapshotCodec::WriteRecording(FILE* file, const SnapshotFrame& baseline, const SnapshotLink* links, unsigned int numLinks)
+{
+    uint8_t count = (uint8_t)(numLinks < SnapshotFrame::MAX_SLOTS ? numLinks : SnapshotFrame::MAX_SLOTS);
+    fwrite(&baseline, sizeof(baseline), 1, file);
+    fwrite(&count, sizeof(count), 1, file);
+    fwrite(links, sizeof(SnapshotLink), count, file);
+}
+
+//-----------------------------------------------------------------------------------
+bool SnapshotCodec::ReadRecording(FILE* file, SnapshotFrame& outBaseline, SnapshotLink* outLinks, unsigned int& outNumLinks)
+{
+    uint8_t count = 0;
+    if (fread(&outBaseline, sizeof(outBaseline), 1, file) != 1 || fread(&count, sizeof(count), 1, file) != 1 || count > SnapshotFrame::MAX_SLOTS)
+    {
+        return false;
+    }
+    outNumLinks = count;
+    if (fread(outLinks, sizeof(SnapshotLink), count, file) != count)
+    {
+        return false;
+    }
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (outLinks[i].m_slot >= SnapshotFrame::MAX_SLOTS || (i > 0 && outLinks[i].m_slot <= outLinks[i - 1].m_slot))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+static void WriteCountArray(FILE* file, const char* comment, const uint32_t* counts, unsigned int numCounts)
+{
+    fprintf(file, "    //%s\n    {", comment);
+    for (unsigned int i = 0; i < numCounts; ++i)
+    {
+        fprintf(file, "%s%u", i == 0 ? " " : (i % 8 == 0 ? ",\n      " : ", "), counts[i]);
+    }
+    fprintf(file, " },\n");
+}
+
+//-----------------------------------------------------------------------------------
+//Writes SnapshotModelData.cpp.
+void SnapshotCodec::WriteModelSource(FILE* file, const SnapshotModelCounts& counts)
+{
+    fprintf(file, "//Generated by SnapshotTrainer, retrain rather than editing by hand.\n");
+    fprintf(file, "#include \"Game/Net/SnapshotCodec.hpp\"\n\n");
+    fprintf(file, "const SnapshotModelCounts TRAINED_SNAPSHOT_MODEL =\n{\n");
+    WriteCountArray(file, "Slot gaps", counts.m_slotGaps, SnapshotFrame::MAX_SLOTS);
+    WriteCountArray(file, "Same link, new link", counts.m_ids, SnapshotModelCounts::NUM_ID_SYMBOLS);
+    WriteCountArray(file, "Position deltas", counts.m_positionDeltas, SnapshotModelCounts::NUM_DELTA_SYMBOLS);
+    WriteCountArray(file, "Facing quarter turns", counts.m_facings, SnapshotModelCounts::NUM_FACING_SYMBOLS);
+    WriteCountArray(file, "Hp deltas", counts.m_hpDeltas, SnapshotModelCounts::NUM_DELTA_SYMBOLS);
+    fprintf(file, "};\n");
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include "Game/Net/RangeCoder.hpp"
+
+//-----------------------------------------------------------------------------------
+//A link as a snapshot sends it, quantized to what the client can actually see.
+struct LinkRecord
+{
+    uint16_t m_networkId;
+    int16_t m_x; //In 1/POSITION_STEPS_PER_UNIT world units.
+    int16_t m_y;
+    uint8_t m_facing;
+    uint8_t m_hp; //In 1/HP_STEPS_PER_POINT hit points.
+};
+
+//-----------------------------------------------------------------------------------
+struct SnapshotLink
+{
+    uint8_t m_slot;
+    LinkRecord m_record;
+};
+
+//-----------------------------------------------------------------------------------
+//Every link one side knows the other has, by player slot. This is what deltas are taken against.
+struct SnapshotFrame
+{
+    static const unsigned int MAX_SLOTS = 32;
+
+    SnapshotFrame() : m_sequence(0), m_validSlots(0) {};
+    inline bool HasSlot(unsigned int slot) const { return (m_validSlots & (1u << slot)) != 0; };
+    inline void SetSlot(unsigned int slot, const LinkRecord& record) { m_links[slot] = record; m_validSlots |= 1u << slot; };
+
+    static const SnapshotFrame EMPTY; //The baseline when the receiver has nothing to build on.
+
+    uint16_t m_sequence;
+    uint32_t m_validSlots;
+    LinkRecord m_links[MAX_SLOTS];
+};
+
+//-----------------------------------------------------------------------------------
+//How often each symbol came up in the recordings the model was trained on. Deltas are coded as a sign and a
+//power-of-two magnitude class, with the bits below the class's top bit sent raw.
+struct SnapshotModelCounts
+{
+    static const unsigned int NUM_DELTA_SYMBOLS = 33; //Zero, then a negative and a positive symbol for each of 16 classes.
+    static const unsigned int NUM_ID_SYMBOLS = 2; //Same link as the baseline's slot, or a new one.
+    static const unsigned int NUM_FACING_SYMBOLS = 4; //Quarter turns from the baseline's facing.
+
+    uint32_t m_slotGaps[SnapshotFrame::MAX_SLOTS];
+    uint32_t m_ids[NUM_ID_SYMBOLS];
+    uint32_t m_positionDeltas[NUM_DELTA_SYMBOLS];
+    uint32_t m_facings[NUM_FACING_SYMBOLS];
+    uint32_t m_hpDeltas[NUM_DELTA_SYMBOLS];
+};
+
+//Trained offline by SnapshotTrainer and compiled in, so packets never carry a table of their own.
+extern const SnapshotModelCounts TRAINED_SNAPSHOT_MODEL;
+
+//-----------------------------------------------------------------------------------
+//Entropy codes a snapshot's links against a baseline frame the receiver already has, with fixed probabilities. Links
+//go in slot order. A link with no baseline is coded against DEFAULT_RECORD instead, which costs more but still works.
+class SnapshotCodec
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SnapshotCodec(const SnapshotModelCounts& counts);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    bool Encode(const SnapshotFrame& baseline, const SnapshotLink* links, unsigned int numLinks, uint8_t* outBuffer, unsigned int capacity, unsigned int& outSize) const;
+    bool Decode(const SnapshotFrame& baseline, const uint8_t* data, unsigned int size, unsigned int numLinks, SnapshotLink* outLinks) const;
+    static void CountSymbols(const SnapshotFrame& baseline, const SnapshotLink* links, unsigned int numLinks, SnapshotModelCounts& counts);
+    static const SnapshotCodec& GetTrained();
+
+    static LinkRecord Quantize(uint16_t networkId, float x, float y, uint8_t facing, float hp);
+    static void Dequantize(const LinkRecord& record, float& outX, float& outY, float& outHp);
+
+    //Recordings are what the trainer learns from: each entry is a baseline and the links coded against it.
+    static void WriteRecording(FILE* file, const SnapshotFrame& baseline, const SnapshotLink* links, unsigned int numLinks);
+    static bool ReadRecording(FILE* file, SnapshotFrame& outBaseline, SnapshotLink* outLinks, unsigned int& outNumLinks);
+    static void WriteModelSource(FILE* file, const SnapshotModelCounts& counts);
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const int POSITION_STEPS_PER_UNIT = 64; //About a pixel at the game's camera zoom.
+    static const int HP_STEPS_PER_POINT = 4;
+    static const LinkRecord DEFAULT_RECORD;
+    static const unsigned int MAX_CODED_LINK_BYTES = 16; //Worst case, every field changing by as much as it can.
+
+private:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    SymbolModel m_slotGapModel;
+    SymbolModel m_idModel;
+    SymbolModel m_positionDeltaModel;
+    SymbolModel m_facingModel;
+    SymbolModel m_hpDeltaModel;
+};
@@ -0,0 +1,133 @@
+#include "Game/Net/SnapshotHistory.hpp"
+
+//-----------------------------------------------------------------------------------
+static inline bool IsNewer(uint16_t sequence, uint16_t than)
+{
+    return (int16_t)(sequence - than) > 0;
+}
+
+//-----------------------------------------------------------------------------------
+SnapshotSendHistory::SnapshotSendHistory()
+{
+    Reset();
+}
+
+//-----------------------------------------------------------------------------------
+SnapshotFrame& SnapshotSendHistory::BeginFrame()
+{
+    SnapshotFrame& frame = m_frames[m_nextSequence & (HISTORY_SIZE - 1)];
+    frame = SnapshotFrame();
+    frame.m_sequence = m_nextSequence++;
+    return frame;
+}
+
+//-----------------------------------------------------------------------------------
+//Null when the client hasn't acked anything recent enough, and the frame has to be coded from scratch.
+const SnapshotFrame* SnapshotSendHistory::GetBaseline(uint16_t sequence) const
+{
+    if (!m_hasAck || (uint16_t)(sequence - m_ackedSequence) >= HISTORY_SIZE)
+    {
+        return nullptr;
+    }
+    const SnapshotFrame& frame = m_frames[m_ackedSequence & (HISTORY_SIZE - 1)];
+    return frame.m_sequence == m_ackedSequence ? &frame : nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+//Acks ride on unreliable client updates, so they can arrive late, twice or out of order. Only newer ones count, and
+//never one for a snapshot we haven't sent, which would mean a stale ack from before a Reset().
+void SnapshotSendHistory::Acknowledge(uint16_t sequence)
+{
+    if (!IsNewer(m_nextSequence, sequence) || (m_hasAck && !IsNewer(sequence, m_ackedSequence)))
+    {
+        return;
+    }
+    m_ackedSequence = sequence;
+    m_hasAck = true;
+}
+
+//-----------------------------------------------------------------------------------
+void SnapshotSendHistory::Reset()
+{
+    for (SnapshotFrame& frame : m_frames)
+    {
+        frame = SnapshotFrame();
+    }
+    m_nextSequence = 0;
+    m_ackedSequence = 0;
+    m_hasAck = false;
+}
+
+//-----------------------------------------------------------------------------------
+SnapshotReceiveHistory::SnapshotReceiveHistory()
+    : m_newestComplete(0)
+    , m_newestApplied(0)
+    , m_hasComplete(false)
+    , m_hasApplied(false)
+{
+    for (ReceivedSnapshot& snapshot : m_snapshots)
+    {
+        snapshot.m_isActive = false;
+        snapshot.m_isComplete = false;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+const SnapshotFrame* SnapshotReceiveHistory::FindBaseline(uint16_t sequence) const
+{
+    const ReceivedSnapshot& snapshot = m_snapshots[sequence & (HISTORY_SIZE - 1)];
+    return snapshot.m_isComplete && snapshot.m_frame.m_sequence == sequence ? &snapshot.m_frame : nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+//Stores a decoded piece and returns whether its links should be applied, which they shouldn't if a newer snapshot
+//has already been. Pieces of snapshots older than the newest complete one are dropped outright.
+bool SnapshotReceiveHistory::AddPiece(uint16_t sequence, uint8_t pieceIndex, uint8_t numPieces, const SnapshotLink* links, unsigned int numLinks)
+{
+    if (numPieces == 0 || numPieces > MAX_PIECES || pieceIndex >= numPieces || (m_hasComplete && !IsNewer(sequence, m_newestComplete)))
+    {
+        return false;
+    }
+
+    ReceivedSnapshot& snapshot = m_snapshots[sequence & (HISTORY_SIZE - 1)];
+    if (!snapshot.m_isActive || snapshot.m_frame.m_sequence != sequence)
+    {
+        snapshot.m_frame = SnapshotFrame();
+        snapshot.m_frame.m_sequence = sequence;
+        snapshot.m_pieceMask = 0;
+        snapshot.m_numPiecesReceived = 0;
+        snapshot.m_isActive = true;
+        snapshot.m_isComplete = false;
+    }
+    uint32_t pieceBit = 1u << pieceIndex;
+    if ((snapshot.m_pieceMask & pieceBit) == 0)
+    {
+        snapshot.m_pieceMask |= pieceBit;
+        ++snapshot.m_numPiecesReceived;
+        for (unsigned int i = 0; i < numLinks; ++i)
+        {
+            snapshot.m_frame.SetSlot(links[i].m_slot, links[i].m_record);
+        }
+        if (snapshot.m_numPiecesReceived == numPieces)
+        {
+            snapshot.m_isComplete = true;
+            m_newestComplete = sequence;
+            m_hasComplete = true;
+        }
+    }
+
+    if (m_hasApplied && IsNewer(m_newestApplied, sequence))
+    {
+        return false;
+    }
+    m_newestApplied = sequence;
+    m_hasApplied = true;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+bool SnapshotReceiveHistory::GetNewestComplete(uint16_t& outSequence) const
+{
+    outSequence = m_newestComplete;
+    return m_hasComplete;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <stdint.h>
+#include "Game/Net/SnapshotCodec.hpp"
+
+//-----------------------------------------------------------------------------------
+//The host's record of the snapshots it has sent one client, so the next can be coded against whichever the client
+//last acknowledged. Sequences wrap, and are compared by their signed difference.
+class SnapshotSendHistory
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SnapshotSendHistory();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    SnapshotFrame& BeginFrame();
+    const SnapshotFrame* GetBaseline(uint16_t sequence) const;
+    void Acknowledge(uint16_t sequence);
+    void Reset();
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int HISTORY_SIZE = 32; //Power of two. Acks older than this fall back to coding from scratch.
+
+private:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    SnapshotFrame m_frames[HISTORY_SIZE];
+    uint16_t m_nextSequence;
+    uint16_t m_ackedSequence;
+    bool m_hasAck;
+};
+
+//-----------------------------------------------------------------------------------
+//The client's side: rebuilds each snapshot from its pieces, and keeps the complete ones around as baselines for the
+//host to code against. Only a snapshot with every piece in is acknowledged, since the host assumes all of it arrived.
+class SnapshotReceiveHistory
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SnapshotReceiveHistory();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    const SnapshotFrame* FindBaseline(uint16_t sequence) const;
+    bool AddPiece(uint16_t sequence, uint8_t pieceIndex, uint8_t numPieces, const SnapshotLink* links, unsigned int numLinks);
+    bool GetNewestComplete(uint16_t& outSequence) const;
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int HISTORY_SIZE = SnapshotSendHistory::HISTORY_SIZE;
+    static const unsigned int MAX_PIECES = 32;
+
+private:
+    struct ReceivedSnapshot
+    {
+        SnapshotFrame m_frame;
+        uint32_t m_pieceMask;
+        uint8_t m_numPiecesReceived;
+        bool m_isActive;
+        bool m_isComplete;
+    };
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    ReceivedSnapshot m_snapshots[HISTORY_SIZE];
+    uint16_t m_newestComplete;
+    uint16_t m_newestApplied;
+    bool m_hasComplete;
+    bool m_hasApplied;
+};
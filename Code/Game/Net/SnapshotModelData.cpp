@@ -0,0 +1,27 @@
+//Generated by SnapshotTrainer, retrain rather than editing by hand.
+#include "Game/Net/SnapshotCodec.hpp"
+
+const SnapshotModelCounts TRAINED_SNAPSHOT_MODEL =
+{
+    //Slot gaps
+    { 800000, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0 },
+    //Same link, new link
+    { 797188, 2812 },
+    //Position deltas
+    { 1034490, 148, 147, 8222, 8099, 13583, 13363, 21788,
+      21565, 66018, 64543, 171209, 171730, 276, 313, 535,
+      509, 1026, 1080, 734, 622, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0,
+      0 },
+    //Facing quarter turns
+    { 706362, 30736, 31429, 31473 },
+    //Hp deltas
+    { 776031, 0, 0, 0, 0, 0, 23665, 0,
+      304, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0,
+      0 },
+};
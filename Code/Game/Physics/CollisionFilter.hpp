@@ -0,0 +1,68 @@
+#pragma once
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------
+enum CollisionLayer
+{
+    PLAYER_COLLISION = 0,
+    PROJECTILE_COLLISION,
+    PICKUP_COLLISION,
+    PROP_COLLISION,
+    NUM_COLLISION_LAYERS
+};
+
+//-----------------------------------------------------------------------------------
+enum CollisionResponse
+{
+    IGNORE_COLLISION = 0, //Never reaches the narrowphase.
+    OVERLAP_COLLISION, //Recorded as an overlap event, nobody moves.
+    PUSH_COLLISION, //Both sides are pushed apart.
+    DAMAGE_COLLISION, //The projectile in the pair hits the other side.
+    NUM_COLLISION_RESPONSES
+};
+
+typedef uint8_t CollisionMask;
+
+//-----------------------------------------------------------------------------------
+//What happens when a collider on the row's layer touches one on the column's layer. Must stay symmetric.
+constexpr CollisionResponse COLLISION_RESPONSE_TABLE[NUM_COLLISION_LAYERS][NUM_COLLISION_LAYERS] =
+{
+    //PLAYER             PROJECTILE          PICKUP              PROP
+    { PUSH_COLLISION,    DAMAGE_COLLISION,   OVERLAP_COLLISION,  PUSH_COLLISION   }, //PLAYER
+    { DAMAGE_COLLISION,  IGNORE_COLLISION,   IGNORE_COLLISION,   DAMAGE_COLLISION }, //PROJECTILE
+    { OVERLAP_COLLISION, IGNORE_COLLISION,   IGNORE_COLLISION,   IGNORE_COLLISION }, //PICKUP
+    { PUSH_COLLISION,    DAMAGE_COLLISION,   IGNORE_COLLISION,   IGNORE_COLLISION }, //PROP
+};
+
+//-----------------------------------------------------------------------------------
+constexpr CollisionMask GetCollisionLayerBit(CollisionLayer layer)
+{
+    return (CollisionMask)(1 << layer);
+}
+
+//-----------------------------------------------------------------------------------
+constexpr CollisionResponse GetCollisionResponse(CollisionLayer first, CollisionLayer second)
+{
+    return COLLISION_RESPONSE_TABLE[first][second];
+}
+
+//-----------------------------------------------------------------------------------
+//Every layer the table says this layer interacts with. Entities start out with this and can narrow it further.
+constexpr CollisionMask GetDefaultCollisionMask(CollisionLayer layer, unsigned int otherLayer = 0)
+{
+    return otherLayer == NUM_COLLISION_LAYERS ? 0 :
+        (CollisionMask)((COLLISION_RESPONSE_TABLE[layer][otherLayer] != IGNORE_COLLISION ? (1 << otherLayer) : 0)
+            | GetDefaultCollisionMask(layer, otherLayer + 1));
+}
+
+//-----------------------------------------------------------------------------------
+constexpr bool IsCollisionResponseTableSymmetric(unsigned int index = 0)
+{
+    return index == NUM_COLLISION_LAYERS * NUM_COLLISION_LAYERS ? true :
+        (COLLISION_RESPONSE_TABLE[index / NUM_COLLISION_LAYERS][index % NUM_COLLISION_LAYERS] == COLLISION_RESPONSE_TABLE[index % NUM_COLLISION_LAYERS][index / NUM_COLLISION_LAYERS])
+            && IsCollisionResponseTableSymmetric(index + 1);
+}
+
+static_assert(IsCollisionResponseTableSymmetric(), "Collision responses must not depend on which side of the pair is tested first.");
+static_assert(NUM_COLLISION_LAYERS <= sizeof(CollisionMask) * 8, "Too many collision layers for the mask type.");
+static_assert(GetCollisionResponse(PROJECTILE_COLLISION, PROJECTILE_COLLISION) == IGNORE_COLLISION, "Damage pairs need exactly one projectile to know who hit whom.");
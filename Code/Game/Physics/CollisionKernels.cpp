@@ -0,0 +1,440 @@
+#include "Game/Physics/CollisionKernels.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Time/Time.hpp"
+#include <stdlib.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//The SIMD kernels are x86 only. Anywhere else (ARM Linux servers, say) every instruction set but SCALAR is unsupported.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define HAS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__)
+#define AVX2_KERNEL __attribute__((target("avx2")))
+#else
+#define AVX2_KERNEL
+#endif
+
+//Padding shapes sit far enough away that nothing overlaps them, but close enough that squaring stays finite.
+static const float PADDING_COORDINATE = 1.0e18f;
+
+CollisionKernels::InstructionSet CollisionKernels::s_instructionSet = CollisionKernels::SCALAR;
+
+//-----------------------------------------------------------------------------------
+DiscBatch::DiscBatch()
+    : m_count(0)
+{
+}
+
+//-----------------------------------------------------------------------------------
+void DiscBatch::Clear()
+{
+    m_centerX.clear();
+    m_centerY.clear();
+    m_radius.clear();
+    m_count = 0;
+}
+
+//-----------------------------------------------------------------------------------
+void DiscBatch::Add(const Vector2& center, float radius)
+{
+    if (m_count == m_centerX.size())
+    {
+        size_t paddedSize = m_centerX.size() + BLOCK_SIZE;
+        m_centerX.resize(paddedSize, PADDING_COORDINATE);
+        m_centerY.resize(paddedSize, PADDING_COORDINATE);
+        m_radius.resize(paddedSize, 0.0f);
+    }
+    Set(m_count++, center, radius);
+}
+
+//-----------------------------------------------------------------------------------
+void DiscBatch::Set(unsigned int index, const Vector2& center, float radius)
+{
+    m_centerX[index] = center.x;
+    m_centerY[index] = center.y;
+    m_radius[index] = radius;
+}
+
+//-----------------------------------------------------------------------------------
+AABB2Batch::AABB2Batch()
+    : m_count(0)
+{
+}
+
+//-----------------------------------------------------------------------------------
+void AABB2Batch::Clear()
+{
+    m_minsX.clear();
+    m_minsY.clear();
+    m_maxsX.clear();
+    m_maxsY.clear();
+    m_count = 0;
+}
+
+//-----------------------------------------------------------------------------------
+void AABB2Batch::Add(const AABB2& box)
+{
+    if (m_count == m_minsX.size())
+    {
+        size_t paddedSize = m_minsX.size() + BLOCK_SIZE;
+        m_minsX.resize(paddedSize, PADDING_COORDINATE);
+        m_minsY.resize(paddedSize, PADDING_COORDINATE);
+        m_maxsX.resize(paddedSize, PADDING_COORDINATE);
+        m_maxsY.resize(paddedSize, PADDING_COORDINATE);
+    }
+    m_minsX[m_count] = box.mins.x;
+    m_minsY[m_count] = box.mins.y;
+    m_maxsX[m_count] = box.maxs.x;
+    m_maxsY[m_count] = box.maxs.y;
+    ++m_count;
+}
+
+//-----------------------------------------------------------------------------------
+//KERNELS/////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------
+static uint32_t DiscVsDiscsScalar(float centerX, float centerY, float radius, const float* batchX, const float* batchY, const float* batchRadius)
+{
+    uint32_t hitMask = 0;
+    for (unsigned int i = 0; i < DiscBatch::BLOCK_SIZE; ++i)
+    {
+        float dx = batchX[i] - centerX;
+        float dy = batchY[i] - centerY;
+        float radii = batchRadius[i] + radius;
+        if ((dx * dx) + (dy * dy) < (radii * radii))
+        {
+            hitMask |= (1u << i);
+        }
+    }
+    return hitMask;
+}
+
+//-----------------------------------------------------------------------------------
+static uint32_t DiscVsAABB2sScalar(float centerX, float centerY, float radius, const float* minsX, const float* minsY, const float* maxsX, const float* maxsY)
+{
+    uint32_t hitMask = 0;
+    float radiusSquared = radius * radius;
+    for (unsigned int i = 0; i < AABB2Batch::BLOCK_SIZE; ++i)
+    {
+        float closestX = centerX < minsX[i] ? minsX[i] : (centerX > maxsX[i] ? maxsX[i] : centerX);
+        float closestY = centerY < minsY[i] ? minsY[i] : (centerY > maxsY[i] ? maxsY[i] : centerY);
+        float dx = centerX - closestX;
+        float dy = centerY - closestY;
+        if ((dx * dx) + (dy * dy) < radiusSquared)
+        {
+            hitMask |= (1u << i);
+        }
+    }
+    return hitMask;
+}
+
+#if defined(HAS_X86_KERNELS)
+//-----------------------------------------------------------------------------------
+static uint32_t DiscVsDiscsSSE(float centerX, float centerY, float radius, const float* batchX, const float* batchY, const float* batchRadius)
+{
+    const __m128 cx = _mm_set1_ps(centerX);
+    const __m128 cy = _mm_set1_ps(centerY);
+    const __m128 r = _mm_set1_ps(radius);
+    uint32_t hitMask = 0;
+    for (unsigned int i = 0; i < DiscBatch::BLOCK_SIZE; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(batchX + i), cx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(batchY + i), cy);
+        __m128 radii = _mm_add_ps(_mm_loadu_ps(batchRadius + i), r);
+        __m128 distSquared = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 hits = _mm_cmplt_ps(distSquared, _mm_mul_ps(radii, radii));
+        hitMask |= ((uint32_t)_mm_movemask_ps(hits)) << i;
+    }
+    return hitMask;
+}
+
+//-----------------------------------------------------------------------------------
+static uint32_t DiscVsAABB2sSSE(float centerX, float centerY, float radius, const float* minsX, const float* minsY, const float* maxsX, const float* maxsY)
+{
+    const __m128 cx = _mm_set1_ps(centerX);
+    const __m128 cy = _mm_set1_ps(centerY);
+    const __m128 radiusSquared = _mm_set1_ps(radius * radius);
+    uint32_t hitMask = 0;
+    for (unsigned int i = 0; i < AABB2Batch::BLOCK_SIZE; i += 4)
+    {
+        __m128 closestX = _mm_min_ps(_mm_max_ps(cx, _mm_loadu_ps(minsX + i)), _mm_loadu_ps(maxsX + i));
+        __m128 closestY = _mm_min_ps(_mm_max_ps(cy, _mm_loadu_ps(minsY + i)), _mm_loadu_ps(maxsY + i));
+        __m128 dx = _mm_sub_ps(cx, closestX);
+        __m128 dy = _mm_sub_ps(cy, closestY);
+        __m128 distSquared = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 hits = _mm_cmplt_ps(distSquared, radiusSquared);
+        hitMask |= ((uint32_t)_mm_movemask_ps(hits)) << i;
+    }
+    return hitMask;
+}
+
+//-----------------------------------------------------------------------------------
+AVX2_KERNEL static uint32_t DiscVsDiscsAVX2(float centerX, float centerY, float radius, const float* batchX, const float* batchY, const float* batchRadius)
+{
+    const __m256 cx = _mm256_set1_ps(centerX);
+    const __m256 cy = _mm256_set1_ps(centerY);
+    const __m256 r = _mm256_set1_ps(radius);
+    uint32_t hitMask = 0;
+    for (unsigned int i = 0; i < DiscBatch::BLOCK_SIZE; i += 8)
+    {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(batchX + i), cx);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(batchY + i), cy);
+        __m256 radii = _mm256_add_ps(_mm256_loadu_ps(batchRadius + i), r);
+        __m256 distSquared = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 hits = _mm256_cmp_ps(distSquared, _mm256_mul_ps(radii, radii), _CMP_LT_OQ);
+        hitMask |= ((uint32_t)_mm256_movemask_ps(hits)) << i;
+    }
+    return hitMask;
+}
+
+//-----------------------------------------------------------------------------------
+AVX2_KERNEL static uint32_t DiscVsAABB2sAVX2(float centerX, float centerY, float radius, const float* minsX, const float* minsY, const float* maxsX, const float* maxsY)
+{
+    const __m256 cx = _mm256_set1_ps(centerX);
+    const __m256 cy = _mm256_set1_ps(centerY);
+    const __m256 radiusSquared = _mm256_set1_ps(radius * radius);
+    uint32_t hitMask = 0;
+    for (unsigned int i = 0; i < AABB2Batch::BLOCK_SIZE; i += 8)
+    {
+        __m256 closestX = _mm256_min_ps(_mm256_max_ps(cx, _mm256_loadu_ps(minsX + i)), _mm256_loadu_ps(maxsX + i));
+        __m256 closestY = _mm256_min_ps(_mm256_max_ps(cy, _mm256_loadu_ps(minsY + i)), _mm256_loadu_ps(maxsY + i));
+        __m256 dx = _mm256_sub_ps(cx, closestX);
+        __m256 dy = _mm256_sub_ps(cy, closestY);
+        __m256 distSquared = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 hits = _mm256_cmp_ps(distSquared, radiusSquared, _CMP_LT_OQ);
+        hitMask |= ((uint32_t)_mm256_movemask_ps(hits)) << i;
+    }
+    return hitMask;
+}
+#endif
+
+CollisionKernels::DiscVsDiscsKernel CollisionKernels::s_discVsDiscs = &DiscVsDiscsScalar;
+CollisionKernels::DiscVsAABB2sKernel CollisionKernels::s_discVsAABB2s = &DiscVsAABB2sScalar;
+
+//-----------------------------------------------------------------------------------
+//DISPATCH/////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------
+void CollisionKernels::Initialize()
+{
+    if (IsSupported(AVX2))
+    {
+        SetInstructionSet(AVX2);
+    }
+    else if (IsSupported(SSE))
+    {
+        SetInstructionSet(SSE);
+    }
+    else
+    {
+        SetInstructionSet(SCALAR);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+bool CollisionKernels::IsSupported(InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+    case SCALAR:
+        return true;
+#if defined(HAS_X86_KERNELS) && defined(_MSC_VER)
+    case SSE:
+    {
+        int cpuInfo[4];
+        __cpuid(cpuInfo, 1);
+        return (cpuInfo[3] & (1 << 26)) != 0;
+    }
+    case AVX2:
+    {
+        int cpuInfo[4];
+        __cpuid(cpuInfo, 0);
+        if (cpuInfo[0] < 7)
+        {
+            return false;
+        }
+        //The OS has to save the YMM registers across context switches, or AVX is unusable even if the CPU has it.
+        __cpuid(cpuInfo, 1);
+        bool osSavesRegisters = (cpuInfo[2] & (1 << 27)) != 0;
+        bool cpuHasAVX = (cpuInfo[2] & (1 << 28)) != 0;
+        if (!osSavesRegisters || !cpuHasAVX || (_xgetbv(0) & 0x6) != 0x6)
+        {
+            return false;
+        }
+        __cpuidex(cpuInfo, 7, 0);
+        return (cpuInfo[1] & (1 << 5)) != 0;
+    }
+#elif defined(HAS_X86_KERNELS)
+    case SSE:
+        return __builtin_cpu_supports("sse2") != 0;
+    case AVX2:
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    default:
+        return false;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void CollisionKernels::SetInstructionSet(InstructionSet instructionSet)
+{
+    if (!IsSupported(instructionSet))
+    {
+        ERROR_RECOVERABLE("Tried to use collision kernels for an instruction set this CPU doesn't support.");
+        return;
+    }
+    switch (instructionSet)
+    {
+#if defined(HAS_X86_KERNELS)
+    case AVX2:
+        s_discVsDiscs = &DiscVsDiscsAVX2;
+        s_discVsAABB2s = &DiscVsAABB2sAVX2;
+        break;
+    case SSE:
+        s_discVsDiscs = &DiscVsDiscsSSE;
+        s_discVsAABB2s = &DiscVsAABB2sSSE;
+        break;
+#endif
+    default:
+        s_discVsDiscs = &DiscVsDiscsScalar;
+        s_discVsAABB2s = &DiscVsAABB2sScalar;
+        break;
+    }
+    s_instructionSet = instructionSet;
+}
+
+//-----------------------------------------------------------------------------------
+const char* CollisionKernels::GetInstructionSetName(InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+    case SCALAR:
+        return "Scalar";
+    case SSE:
+        return "SSE";
+    case AVX2:
+        return "AVX2";
+    default:
+        return "Unknown";
+    }
+}
+
+//-----------------------------------------------------------------------------------
+uint32_t CollisionKernels::DiscVsDiscBlock(const Vector2& center, float radius, const DiscBatch& batch, unsigned int blockIndex)
+{
+    unsigned int offset = blockIndex * DiscBatch::BLOCK_SIZE;
+    return s_discVsDiscs(center.x, center.y, radius, &batch.m_centerX[offset], &batch.m_centerY[offset], &batch.m_radius[offset]);
+}
+
+//-----------------------------------------------------------------------------------
+uint32_t CollisionKernels::DiscVsAABB2Block(const Vector2& center, float radius, const AABB2Batch& batch, unsigned int blockIndex)
+{
+    unsigned int offset = blockIndex * AABB2Batch::BLOCK_SIZE;
+    return s_discVsAABB2s(center.x, center.y, radius, &batch.m_minsX[offset], &batch.m_minsY[offset], &batch.m_maxsX[offset], &batch.m_maxsY[offset]);
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int CollisionKernels::FindLowestSetBit(uint32_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return (unsigned int)index;
+#else
+    return (unsigned int)__builtin_ctz(mask);
+#endif
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(collisionbench)
+{
+    int numShapes = args.HasArgs(1) ? atoi(args.GetStringArgument(0).c_str()) : 1024;
+    if (numShapes <= 0)
+    {
+        Console::instance->PrintLine("collisionbench <numShapes>", RGBA::RED);
+        return;
+    }
+
+    DiscBatch discs;
+    AABB2Batch boxes;
+    std::vector<Vector2> centers;
+    std::vector<float> radii;
+    for (int i = 0; i < numShapes; ++i)
+    {
+        Vector2 center(MathUtils::GetRandomFloatFromZeroTo(30.0f), MathUtils::GetRandomFloatFromZeroTo(16.0f));
+        float radius = 0.1f + MathUtils::GetRandomFloatFromZeroTo(0.4f);
+        centers.push_back(center);
+        radii.push_back(radius);
+        discs.Add(center, radius);
+        boxes.Add(AABB2(center - Vector2(radius), center + Vector2(radius)));
+    }
+    double numTests = (double)numShapes * (double)numShapes;
+
+    //Baseline: the old one-pair-at-a-time path.
+    unsigned int baselineHits = 0;
+    double startSeconds = GetCurrentTimeSeconds();
+    for (int i = 0; i < numShapes; ++i)
+    {
+        for (int j = 0; j < numShapes; ++j)
+        {
+            baselineHits += MathUtils::DoDiscsOverlap(centers[i], radii[i], centers[j], radii[j]) ? 1 : 0;
+        }
+    }
+    double baselineSeconds = GetCurrentTimeSeconds() - startSeconds;
+    Console::instance->PrintLine(Stringf("%-8s discs: %8.2f Mtests/s (%u hits)", "Per-pair", (numTests / baselineSeconds) / 1.0e6, baselineHits));
+
+    CollisionKernels::InstructionSet previousInstructionSet = CollisionKernels::GetInstructionSet();
+    for (int set = 0; set < CollisionKernels::NUM_INSTRUCTION_SETS; ++set)
+    {
+        CollisionKernels::InstructionSet instructionSet = (CollisionKernels::InstructionSet)set;
+        if (!CollisionKernels::IsSupported(instructionSet))
+        {
+            continue;
+        }
+        CollisionKernels::SetInstructionSet(instructionSet);
+
+        unsigned int discHits = 0;
+        startSeconds = GetCurrentTimeSeconds();
+        for (int i = 0; i < numShapes; ++i)
+        {
+            for (unsigned int block = 0; block < discs.GetNumBlocks(); ++block)
+            {
+                uint32_t mask = CollisionKernels::DiscVsDiscBlock(centers[i], radii[i], discs, block);
+                for (; mask != 0; mask &= mask - 1)
+                {
+                    ++discHits;
+                }
+            }
+        }
+        double discSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+        unsigned int boxHits = 0;
+        startSeconds = GetCurrentTimeSeconds();
+        for (int i = 0; i < numShapes; ++i)
+        {
+            for (unsigned int block = 0; block < boxes.GetNumBlocks(); ++block)
+            {
+                uint32_t mask = CollisionKernels::DiscVsAABB2Block(centers[i], radii[i], boxes, block);
+                for (; mask != 0; mask &= mask - 1)
+                {
+                    ++boxHits;
+                }
+            }
+        }
+        double boxSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+        const char* name = CollisionKernels::GetInstructionSetName(instructionSet);
+        Console::instance->PrintLine(Stringf("%-8s discs: %8.2f Mtests/s (%u hits)", name, (numTests / discSeconds) / 1.0e6, discHits));
+        Console::instance->PrintLine(Stringf("%-8s boxes: %8.2f Mtests/s (%u hits)", name, (numTests / boxSeconds) / 1.0e6, boxHits));
+    }
+    CollisionKernels::SetInstructionSet(previousInstructionSet);
+}
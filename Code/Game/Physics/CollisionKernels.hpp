@@ -0,0 +1,80 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Renderer/AABB2.hpp"
+
+//-----------------------------------------------------------------------------------
+//Discs packed as a structure of arrays. Storage is padded out to whole blocks with discs that can never hit anything,
+//so the kernels can always read a full block without bounds checks.
+class DiscBatch
+{
+public:
+    DiscBatch();
+    void Clear();
+    void Add(const Vector2& center, float radius);
+    void Set(unsigned int index, const Vector2& center, float radius);
+    inline unsigned int GetCount() const { return m_count; };
+    inline unsigned int GetNumBlocks() const { return (unsigned int)(m_centerX.size() / BLOCK_SIZE); };
+
+    static const unsigned int BLOCK_SIZE = 32;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<float> m_centerX;
+    std::vector<float> m_centerY;
+    std::vector<float> m_radius;
+    unsigned int m_count;
+};
+
+//-----------------------------------------------------------------------------------
+class AABB2Batch
+{
+public:
+    AABB2Batch();
+    void Clear();
+    void Add(const AABB2& box);
+    inline unsigned int GetCount() const { return m_count; };
+    inline unsigned int GetNumBlocks() const { return (unsigned int)(m_minsX.size() / BLOCK_SIZE); };
+
+    static const unsigned int BLOCK_SIZE = 32;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<float> m_minsX;
+    std::vector<float> m_minsY;
+    std::vector<float> m_maxsX;
+    std::vector<float> m_maxsY;
+    unsigned int m_count;
+};
+
+//-----------------------------------------------------------------------------------
+//Tests one disc against a block of 32 packed shapes and returns a hit mask, bit N set meaning shape N of the block overlaps.
+//The best instruction set the CPU supports is picked once at startup, with a scalar fallback.
+class CollisionKernels
+{
+public:
+    enum InstructionSet
+    {
+        SCALAR = 0,
+        SSE,
+        AVX2,
+        NUM_INSTRUCTION_SETS
+    };
+
+    typedef uint32_t(*DiscVsDiscsKernel)(float centerX, float centerY, float radius, const float* batchX, const float* batchY, const float* batchRadius);
+    typedef uint32_t(*DiscVsAABB2sKernel)(float centerX, float centerY, float radius, const float* minsX, const float* minsY, const float* maxsX, const float* maxsY);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static void Initialize();
+    static bool IsSupported(InstructionSet instructionSet);
+    static void SetInstructionSet(InstructionSet instructionSet);
+    static const char* GetInstructionSetName(InstructionSet instructionSet);
+    static inline InstructionSet GetInstructionSet() { return s_instructionSet; };
+    static uint32_t DiscVsDiscBlock(const Vector2& center, float radius, const DiscBatch& batch, unsigned int blockIndex);
+    static uint32_t DiscVsAABB2Block(const Vector2& center, float radius, const AABB2Batch& batch, unsigned int blockIndex);
+    static unsigned int FindLowestSetBit(uint32_t mask);
+
+private:
+    static InstructionSet s_instructionSet;
+    static DiscVsDiscsKernel s_discVsDiscs;
+    static DiscVsAABB2sKernel s_discVsAABB2s;
+};
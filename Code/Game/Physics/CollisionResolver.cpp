@@ -0,0 +1,56 @@
+#include "Game/Physics/CollisionResolver.hpp"
+#include "Game/Entities/Entity.hpp"
+#include "Game/Entities/Arrow.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+//Fraction of the overlap removed each tick, so crowds settle instead of jittering.
+const float CollisionResolver::PUSH_STIFFNESS = 0.25f;
+
+//-----------------------------------------------------------------------------------
+void CollisionResolver::Resolve(Entity* first, Entity* second)
+{
+    switch (GetCollisionResponse(first->m_collisionLayer, second->m_collisionLayer))
+    {
+    case PUSH_COLLISION:
+        Push(first, second);
+        break;
+    case DAMAGE_COLLISION:
+        if (first->m_collisionLayer == PROJECTILE_COLLISION)
+        {
+            Damage(static_cast<Arrow*>(first), second);
+        }
+        else
+        {
+            Damage(static_cast<Arrow*>(second), first);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void CollisionResolver::Push(Entity* first, Entity* second)
+{
+    Vector2 difference = first->m_position - second->m_position;
+    float distanceBetweenPoints = difference.Normalize();
+    if (distanceBetweenPoints == 0.0f)
+    {
+        //Stacked exactly on top of each other, any direction will do.
+        difference = Vector2::UNIT_X;
+    }
+    float penetration = (first->m_collisionRadius + second->m_collisionRadius) - distanceBetweenPoints;
+    if (penetration <= 0.0f)
+    {
+        return;
+    }
+    difference *= penetration * PUSH_STIFFNESS * 0.5f;
+    first->m_position += difference;
+    second->m_position -= difference;
+}
+
+//-----------------------------------------------------------------------------------
+void CollisionResolver::Damage(Arrow* projectile, Entity* target)
+{
+    projectile->OnHit(target);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <vector>
+#include "Game/Physics/CollisionFilter.hpp"
+
+class Entity;
+class Arrow;
+
+//-----------------------------------------------------------------------------------
+struct CollisionOverlap
+{
+    Entity* m_first;
+    Entity* m_second;
+};
+
+//-----------------------------------------------------------------------------------
+//Applies the response table to a pair the broadphase already found touching. Each response has its own resolver,
+//picked with a switch instead of going through the entities' vtables. Overlap events are recorded by the broadphase;
+//everything here only touches the two entities in the pair, so disjoint pairs can be resolved in parallel.
+class CollisionResolver
+{
+public:
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static void Resolve(Entity* first, Entity* second);
+    static void Push(Entity* first, Entity* second);
+    static void Damage(Arrow* projectile, Entity* target);
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const float PUSH_STIFFNESS;
+};
@@ -0,0 +1,44 @@
+#include "Game/Physics/PairBatcher.hpp"
+#include "Game/Physics/CollisionKernels.hpp"
+
+//-----------------------------------------------------------------------------------
+void PairBatcher::Build(const std::vector<ColliderPair>& pairs, unsigned int numColliders)
+{
+    const uint64_t ALL_BATCHES_IN_USE = ~0ULL;
+    m_batchesInUse.assign(numColliders, 0);
+    m_pairBatches.resize(pairs.size());
+
+    unsigned int numBatches = 0;
+    unsigned int batchCounts[MAX_PARALLEL_BATCHES + 1] = { 0 };
+    for (unsigned int pairIndex = 0; pairIndex < pairs.size(); ++pairIndex)
+    {
+        const ColliderPair& pair = pairs[pairIndex];
+        uint64_t inUse = m_batchesInUse[pair.m_first] | m_batchesInUse[pair.m_second];
+        unsigned int batch = MAX_PARALLEL_BATCHES;
+        if (inUse != ALL_BATCHES_IN_USE)
+        {
+            uint64_t available = ~inUse;
+            uint32_t lowWord = (uint32_t)available;
+            batch = lowWord != 0 ? CollisionKernels::FindLowestSetBit(lowWord) : 32 + CollisionKernels::FindLowestSetBit((uint32_t)(available >> 32));
+            m_batchesInUse[pair.m_first] |= 1ULL << batch;
+            m_batchesInUse[pair.m_second] |= 1ULL << batch;
+        }
+        m_pairBatches[pairIndex] = (uint8_t)batch;
+        ++batchCounts[batch];
+        numBatches = (batch + 1 > numBatches) ? batch + 1 : numBatches;
+    }
+
+    //Counting sort by batch keeps discovery order inside each batch. The serial batch is always last, even if empty.
+    numBatches = (batchCounts[MAX_PARALLEL_BATCHES] > 0) ? MAX_PARALLEL_BATCHES + 1 : numBatches;
+    m_batchStarts.assign(numBatches + 1, 0);
+    for (unsigned int batch = 0; batch < numBatches; ++batch)
+    {
+        m_batchStarts[batch + 1] = m_batchStarts[batch] + batchCounts[batch];
+    }
+    m_writeCursors.assign(m_batchStarts.begin(), m_batchStarts.end() - 1);
+    m_pairOrder.resize(pairs.size());
+    for (unsigned int pairIndex = 0; pairIndex < pairs.size(); ++pairIndex)
+    {
+        m_pairOrder[m_writeCursors[m_pairBatches[pairIndex]]++] = pairIndex;
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+struct ColliderPair
+{
+    uint32_t m_first;
+    uint32_t m_second;
+};
+
+//-----------------------------------------------------------------------------------
+//Splits contact pairs into batches where no collider appears twice, so every pair in a batch can be resolved in parallel
+//without locks. Greedy edge coloring in the order pairs were found: the result only depends on the pair list, not on
+//how many threads end up resolving it. Pairs that run out of colors land in a final batch that must be resolved serially.
+class PairBatcher
+{
+public:
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Build(const std::vector<ColliderPair>& pairs, unsigned int numColliders);
+    inline unsigned int GetNumBatches() const { return (unsigned int)m_batchStarts.size() - 1; };
+    inline unsigned int GetBatchSize(unsigned int batchIndex) const { return m_batchStarts[batchIndex + 1] - m_batchStarts[batchIndex]; };
+    inline const unsigned int* GetBatch(unsigned int batchIndex) const { return m_pairOrder.data() + m_batchStarts[batchIndex]; };
+    inline bool IsSerialBatch(unsigned int batchIndex) const { return batchIndex == MAX_PARALLEL_BATCHES; };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int MAX_PARALLEL_BATCHES = 64;
+
+private:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<uint64_t> m_batchesInUse; //Per collider, bit N set if it's already in batch N.
+    std::vector<uint8_t> m_pairBatches;
+    std::vector<unsigned int> m_batchStarts;
+    std::vector<unsigned int> m_writeCursors;
+    std::vector<unsigned int> m_pairOrder; //Pair indices sorted by batch, in discovery order within each batch.
+};
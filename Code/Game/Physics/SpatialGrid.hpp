@@ -0,0 +1,99 @@
+#pragma once
+#include <vector>
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Renderer/AABB2.hpp"
+
+//-----------------------------------------------------------------------------------
+//Loose uniform grid: each item lives in the one cell containing its center, and queries grow by the largest half extent
+//inserted so far to catch items that hang over into neighboring cells. Anything outside the world bounds is clamped into
+//the edge cells. Meant to be cleared and refilled every tick; cell storage is kept between rebuilds.
+template <typename T>
+class SpatialGrid
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SpatialGrid(const AABB2& worldBounds, float cellSize)
+        : m_worldBounds(worldBounds)
+        , m_inverseCellSize(1.0f / cellSize)
+        , m_maxHalfExtents(0.0f, 0.0f)
+    {
+        Vector2 dimensions = worldBounds.maxs - worldBounds.mins;
+        m_numColumns = (int)(dimensions.x * m_inverseCellSize) + 1;
+        m_numRows = (int)(dimensions.y * m_inverseCellSize) + 1;
+        m_cells.resize(m_numColumns * m_numRows);
+    }
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Clear()
+    {
+        for (unsigned int cellIndex : m_occupiedCells)
+        {
+            m_cells[cellIndex].clear();
+        }
+        m_occupiedCells.clear();
+        m_maxHalfExtents = Vector2(0.0f, 0.0f);
+    }
+
+    //-----------------------------------------------------------------------------------
+    void Insert(T* item, const AABB2& bounds)
+    {
+        Vector2 halfExtents = (bounds.maxs - bounds.mins) * 0.5f;
+        m_maxHalfExtents.x = halfExtents.x > m_maxHalfExtents.x ? halfExtents.x : m_maxHalfExtents.x;
+        m_maxHalfExtents.y = halfExtents.y > m_maxHalfExtents.y ? halfExtents.y : m_maxHalfExtents.y;
+
+        Vector2 center = bounds.mins + halfExtents;
+        unsigned int cellIndex = (GetRow(center.y) * m_numColumns) + GetColumn(center.x);
+        if (m_cells[cellIndex].empty())
+        {
+            m_occupiedCells.push_back(cellIndex);
+        }
+        Entry entry;
+        entry.m_item = item;
+        entry.m_bounds = bounds;
+        m_cells[cellIndex].push_back(entry);
+    }
+
+    //-----------------------------------------------------------------------------------
+    //Clears outResults and fills it with every item whose inserted bounds overlap the area.
+    void Query(const AABB2& area, std::vector<T*>& outResults) const
+    {
+        outResults.clear();
+        int minColumn = GetColumn(area.mins.x - m_maxHalfExtents.x);
+        int maxColumn = GetColumn(area.maxs.x + m_maxHalfExtents.x);
+        int minRow = GetRow(area.mins.y - m_maxHalfExtents.y);
+        int maxRow = GetRow(area.maxs.y + m_maxHalfExtents.y);
+        for (int row = minRow; row <= maxRow; ++row)
+        {
+            for (int column = minColumn; column <= maxColumn; ++column)
+            {
+                for (const Entry& entry : m_cells[(row * m_numColumns) + column])
+                {
+                    if (area.IsIntersecting(entry.m_bounds))
+                    {
+                        outResults.push_back(entry.m_item);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    struct Entry
+    {
+        T* m_item;
+        AABB2 m_bounds;
+    };
+
+    inline int GetColumn(float x) const { return ClampCell((int)((x - m_worldBounds.mins.x) * m_inverseCellSize), m_numColumns); };
+    inline int GetRow(float y) const { return ClampCell((int)((y - m_worldBounds.mins.y) * m_inverseCellSize), m_numRows); };
+    static inline int ClampCell(int cell, int numCells) { return cell < 0 ? 0 : (cell >= numCells ? numCells - 1 : cell); };
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    AABB2 m_worldBounds;
+    float m_inverseCellSize;
+    int m_numColumns;
+    int m_numRows;
+    Vector2 m_maxHalfExtents;
+    std::vector<std::vector<Entry>> m_cells;
+    std::vector<unsigned int> m_occupiedCells;
+};
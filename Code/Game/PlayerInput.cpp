@@ -0,0 +1,92 @@
+#include "Game/PlayerInput.hpp"
+#include "Engine/Input/InputMap.hpp"
+#include "Engine/Input/InputValues.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <math.h>
+
+//Analog values count as held past this point, so sticks and keys produce the same buttons.
+static const float PRESSED_THRESHOLD = 0.5f;
+
+//-----------------------------------------------------------------------------------
+PlayerInput PlayerInput::Sample(const MovementAxes& movementAxes, const InputValue* attackValue, const InputValue* respawnValue)
+{
+    uint8_t buttons = 0;
+    buttons |= (movementAxes.m_up->m_positiveValue->m_currentValue > PRESSED_THRESHOLD) ? UP : 0;
+    buttons |= (movementAxes.m_up->m_negativeValue->m_currentValue > PRESSED_THRESHOLD) ? DOWN : 0;
+    buttons |= (movementAxes.m_right->m_negativeValue->m_currentValue > PRESSED_THRESHOLD) ? LEFT : 0;
+    buttons |= (movementAxes.m_right->m_positiveValue->m_currentValue > PRESSED_THRESHOLD) ? RIGHT : 0;
+    buttons |= (attackValue->m_currentValue > PRESSED_THRESHOLD) ? ATTACK : 0;
+    buttons |= (respawnValue->m_currentValue > PRESSED_THRESHOLD) ? RESPAWN : 0;
+    return PlayerInput(buttons);
+}
+
+//-----------------------------------------------------------------------------------
+void PlayerInput::ApplyToMovementAxes(const MovementAxes& movementAxes) const
+{
+    movementAxes.m_right->SetValue(IsHeld(RIGHT) ? 1.0f : 0.0f, IsHeld(LEFT) ? 1.0f : 0.0f);
+    movementAxes.m_up->SetValue(IsHeld(UP) ? 1.0f : 0.0f, IsHeld(DOWN) ? 1.0f : 0.0f);
+}
+
+//-----------------------------------------------------------------------------------
+static inline bool IsPartlyPressed(float value)
+{
+    return value > 0.0f && value < 1.0f;
+}
+
+//-----------------------------------------------------------------------------------
+static int8_t QuantizeAxis(float positiveValue, float negativeValue)
+{
+    float value = positiveValue - negativeValue;
+    value = value > 1.0f ? 1.0f : (value < -1.0f ? -1.0f : value);
+    return (int8_t)floorf(value * MovementInput::ANALOG_STEPS + 0.5f);
+}
+
+//-----------------------------------------------------------------------------------
+MovementInput MovementInput::Sample(const MovementAxes& movementAxes)
+{
+    float up = movementAxes.m_up->m_positiveValue->m_currentValue;
+    float down = movementAxes.m_up->m_negativeValue->m_currentValue;
+    float right = movementAxes.m_right->m_positiveValue->m_currentValue;
+    float left = movementAxes.m_right->m_negativeValue->m_currentValue;
+
+    MovementInput input;
+    input.m_buttons |= (up > PRESSED_THRESHOLD) ? PlayerInput::UP : 0;
+    input.m_buttons |= (down > PRESSED_THRESHOLD) ? PlayerInput::DOWN : 0;
+    input.m_buttons |= (left > PRESSED_THRESHOLD) ? PlayerInput::LEFT : 0;
+    input.m_buttons |= (right > PRESSED_THRESHOLD) ? PlayerInput::RIGHT : 0;
+    input.m_isAnalog = IsPartlyPressed(up) || IsPartlyPressed(down) || IsPartlyPressed(left) || IsPartlyPressed(right);
+    if (input.m_isAnalog)
+    {
+        input.m_right = QuantizeAxis(right, left);
+        input.m_up = QuantizeAxis(up, down);
+    }
+    return input;
+}
+
+//-----------------------------------------------------------------------------------
+void MovementInput::ApplyToMovementAxes(const MovementAxes& movementAxes) const
+{
+    if (!m_isAnalog)
+    {
+        PlayerInput(m_buttons).ApplyToMovementAxes(movementAxes);
+        return;
+    }
+    float right = (float)m_right / ANALOG_STEPS;
+    float up = (float)m_up / ANALOG_STEPS;
+    movementAxes.m_right->SetValue(right > 0.0f ? right : 0.0f, right < 0.0f ? -right : 0.0f);
+    movementAxes.m_up->SetValue(up > 0.0f ? up : 0.0f, up < 0.0f ? -up : 0.0f);
+}
+
+//-----------------------------------------------------------------------------------
+void MovementAxes::Resolve(InputMap& mapping)
+{
+    m_right = mapping.FindInputAxis("Right");
+    m_up = mapping.FindInputAxis("Up");
+    ASSERT_OR_DIE(m_right && m_up, "Input mapping is missing its Right/Up movement axes.");
+}
+
+//-----------------------------------------------------------------------------------
+Vector2 MovementAxes::GetVector2() const
+{
+    return Vector2(m_right->GetValue(), m_up->GetValue());
+}
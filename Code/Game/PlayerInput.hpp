@@ -0,0 +1,78 @@
+#pragma once
+#include <stdint.h>
+#include "Engine/Math/Vector2.hpp"
+
+class InputMap;
+class InputAxis;
+class InputValue;
+
+//-----------------------------------------------------------------------------------
+//The two movement axes of a mapping, looked up by name once so per-tick code doesn't search the map every time.
+struct MovementAxes
+{
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    MovementAxes() : m_right(nullptr), m_up(nullptr) {};
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Resolve(InputMap& mapping);
+    Vector2 GetVector2() const;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    InputAxis* m_right;
+    InputAxis* m_up;
+};
+
+//-----------------------------------------------------------------------------------
+//Everything a player can do on one tick, packed into a byte so histories are cheap to store, compare and send.
+struct PlayerInput
+{
+    enum Button
+    {
+        UP = 1 << 0,
+        DOWN = 1 << 1,
+        LEFT = 1 << 2,
+        RIGHT = 1 << 3,
+        ATTACK = 1 << 4,
+        RESPAWN = 1 << 5,
+        MOVEMENT_BUTTONS = UP | DOWN | LEFT | RIGHT
+    };
+
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    PlayerInput() : m_buttons(0) {};
+    explicit PlayerInput(uint8_t buttons) : m_buttons(buttons) {};
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static PlayerInput Sample(const MovementAxes& movementAxes, const InputValue* attackValue, const InputValue* respawnValue);
+    void ApplyToMovementAxes(const MovementAxes& movementAxes) const;
+    inline bool IsHeld(Button button) const { return (m_buttons & button) != 0; };
+    inline bool WasJustPressed(Button button, const PlayerInput& previousInput) const { return IsHeld(button) && !previousInput.IsHeld(button); };
+    inline bool operator==(const PlayerInput& other) const { return m_buttons == other.m_buttons; };
+    inline bool operator!=(const PlayerInput& other) const { return m_buttons != other.m_buttons; };
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    uint8_t m_buttons;
+};
+
+//-----------------------------------------------------------------------------------
+//What an authoritative client sends the host: the movement buttons, plus the actual deflection per axis whenever an
+//axis is somewhere between released and fully pressed, as a stick would be. Keys alone never set m_isAnalog.
+struct MovementInput
+{
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    MovementInput() : m_buttons(0), m_right(0), m_up(0), m_isAnalog(false) {};
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static MovementInput Sample(const MovementAxes& movementAxes);
+    void ApplyToMovementAxes(const MovementAxes& movementAxes) const;
+    inline bool operator==(const MovementInput& other) const { return m_buttons == other.m_buttons && m_isAnalog == other.m_isAnalog && (!m_isAnalog || (m_right == other.m_right && m_up == other.m_up)); };
+    inline bool operator!=(const MovementInput& other) const { return !(*this == other); };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const int ANALOG_STEPS = 127; //Per direction, so an axis fits a signed byte.
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    uint8_t m_buttons; //PlayerInput::MOVEMENT_BUTTONS only, attacks and respawns have reliable messages of their own.
+    int8_t m_right; //Positive minus negative, in 1/ANALOG_STEPS. Only meaningful when m_isAnalog.
+    int8_t m_up;
+    bool m_isAnalog;
+};
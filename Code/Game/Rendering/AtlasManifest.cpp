@@ -0,0 +1,115 @@
+#define _CRT_SECURE_NO_WARNINGS //Plain stdio keeps these usable from the offline tools.
+#include "Game/Rendering/AtlasManifest.hpp"
+#include <ctype.h>
+#include <stdio.h>
+
+//-----------------------------------------------------------------------------------
+//Malformed lines fail the whole load, a half-read manifest would point sprites at the wrong texels.
+bool AtlasManifest::LoadFromFile(const std::string& filePath)
+{
+    m_pages.clear();
+    m_regions.clear();
+    FILE* file = fopen(filePath.c_str(), "r");
+    if (!file)
+    {
+        return false;
+    }
+    bool isValid = true;
+    char line[1024];
+    while (isValid && fgets(line, sizeof(line), file))
+    {
+        char keyword[16];
+        char path[512];
+        unsigned int index = 0;
+        AtlasRegion region;
+        if (sscanf(line, "%15s", keyword) != 1 || keyword[0] == '#')
+        {
+            continue;
+        }
+        std::string type(keyword);
+        if (type == "page")
+        {
+            int width = 0;
+            int height = 0;
+            isValid = sscanf(line, "page %u %511s %i %i", &index, path, &width, &height) == 4 && index == m_pages.size();
+            if (isValid)
+            {
+                AddPage(path, width, height);
+            }
+        }
+        else if (type == "region")
+        {
+            isValid = sscanf(line, "region %511s %u %i %i %i %i", path, &region.m_page, &region.m_x, &region.m_y, &region.m_width, &region.m_height) == 6
+                && region.m_page < m_pages.size();
+            if (isValid)
+            {
+                AddRegion(path, region);
+            }
+        }
+        else
+        {
+            isValid = false;
+        }
+    }
+    fclose(file);
+    if (!isValid)
+    {
+        m_pages.clear();
+        m_regions.clear();
+    }
+    return isValid;
+}
+
+//-----------------------------------------------------------------------------------
+bool AtlasManifest::SaveToFile(const std::string& filePath) const
+{
+    FILE* file = fopen(filePath.c_str(), "w");
+    if (!file)
+    {
+        return false;
+    }
+    for (unsigned int i = 0; i < m_pages.size(); ++i)
+    {
+        fprintf(file, "page %u %s %i %i\n", i, m_pages[i].m_imagePath.c_str(), m_pages[i].m_width, m_pages[i].m_height);
+    }
+    for (auto& pair : m_regions)
+    {
+        const AtlasRegion& region = pair.second;
+        fprintf(file, "region %s %u %i %i %i %i\n", pair.first.c_str(), region.m_page, region.m_x, region.m_y, region.m_width, region.m_height);
+    }
+    return fclose(file) == 0;
+}
+
+//-----------------------------------------------------------------------------------
+void AtlasManifest::AddPage(const std::string& imagePath, int width, int height)
+{
+    AtlasPage page;
+    page.m_imagePath = imagePath;
+    page.m_width = width;
+    page.m_height = height;
+    m_pages.push_back(page);
+}
+
+//-----------------------------------------------------------------------------------
+void AtlasManifest::AddRegion(const std::string& sourceImagePath, const AtlasRegion& region)
+{
+    m_regions[NormalizePath(sourceImagePath)] = region;
+}
+
+//-----------------------------------------------------------------------------------
+const AtlasRegion* AtlasManifest::FindRegion(const std::string& sourceImagePath) const
+{
+    auto found = m_regions.find(NormalizePath(sourceImagePath));
+    return found != m_regions.end() ? &found->second : nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+std::string AtlasManifest::NormalizePath(const std::string& path)
+{
+    std::string normalized(path);
+    for (char& character : normalized)
+    {
+        character = character == '\\' ? '/' : (char)tolower((unsigned char)character);
+    }
+    return normalized;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+struct AtlasRegion
+{
+    unsigned int m_page;
+    int m_x;
+    int m_y;
+    int m_width;
+    int m_height;
+};
+
+//-----------------------------------------------------------------------------------
+struct AtlasPage
+{
+    std::string m_imagePath;
+    int m_width;
+    int m_height;
+};
+
+//-----------------------------------------------------------------------------------
+//Where every baked image ended up. Plain text, one entry per line:
+//  page <index> <imagePath> <width> <height>
+//  region <sourceImagePath> <page> <x> <y> <width> <height>
+//Region paths are stored with forward slashes and matched case-insensitively, so "Data\Images\arrow.png" finds its region.
+class AtlasManifest
+{
+public:
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    bool LoadFromFile(const std::string& filePath);
+    bool SaveToFile(const std::string& filePath) const;
+    void AddPage(const std::string& imagePath, int width, int height);
+    void AddRegion(const std::string& sourceImagePath, const AtlasRegion& region);
+    const AtlasRegion* FindRegion(const std::string& sourceImagePath) const;
+    inline const AtlasPage& GetPage(unsigned int pageIndex) const { return m_pages[pageIndex]; };
+    inline unsigned int GetNumPages() const { return m_pages.size(); };
+    inline unsigned int GetNumRegions() const { return m_regions.size(); };
+    static std::string NormalizePath(const std::string& path);
+
+private:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<AtlasPage> m_pages;
+    std::map<std::string, AtlasRegion> m_regions;
+};
@@ -0,0 +1,157 @@
+#include "Game/Rendering/AtlasPacker.hpp"
+#include <algorithm>
+
+//-----------------------------------------------------------------------------------
+AtlasPacker::AtlasPacker(int pageWidth, int pageHeight, int padding)
+    : m_pageWidth(pageWidth)
+    , m_pageHeight(pageHeight)
+    , m_padding(padding)
+    , m_numPages(0)
+{
+}
+
+//-----------------------------------------------------------------------------------
+//Only the widths and heights of the sizes are read. Placements come back in the same order, positioned inside their
+//padding. Returns false if something can't fit even on an empty page.
+bool AtlasPacker::Pack(const std::vector<AtlasPlacement>& sizes, std::vector<AtlasPlacement>& outPlacements)
+{
+    outPlacements.assign(sizes.begin(), sizes.end());
+    m_numPages = 0;
+    if (sizes.empty())
+    {
+        return true;
+    }
+
+    //Tallest first keeps the skyline flat; ties broken by width, then by index so the layout is deterministic.
+    std::vector<unsigned int> order(sizes.size());
+    for (unsigned int i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&sizes](unsigned int a, unsigned int b)
+    {
+        if (sizes[a].m_height != sizes[b].m_height)
+        {
+            return sizes[a].m_height > sizes[b].m_height;
+        }
+        if (sizes[a].m_width != sizes[b].m_width)
+        {
+            return sizes[a].m_width > sizes[b].m_width;
+        }
+        return a < b;
+    });
+
+    m_skyline.assign(1, SkylineSegment{ 0, 0, m_pageWidth });
+    m_numPages = 1;
+    for (unsigned int index : order)
+    {
+        int paddedWidth = sizes[index].m_width + (2 * m_padding);
+        int paddedHeight = sizes[index].m_height + (2 * m_padding);
+        if (paddedWidth > m_pageWidth || paddedHeight > m_pageHeight)
+        {
+            return false;
+        }
+        int x = 0;
+        int y = 0;
+        unsigned int segmentIndex = 0;
+        if (!FindPosition(paddedWidth, paddedHeight, x, y, segmentIndex))
+        {
+            m_skyline.assign(1, SkylineSegment{ 0, 0, m_pageWidth });
+            ++m_numPages;
+            FindPosition(paddedWidth, paddedHeight, x, y, segmentIndex);
+        }
+        AddToSkyline(segmentIndex, x, y, paddedWidth, paddedHeight);
+        AtlasPlacement& placement = outPlacements[index];
+        placement.m_page = m_numPages - 1;
+        placement.m_x = x + m_padding;
+        placement.m_y = y + m_padding;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+float AtlasPacker::CalculateOccupancy(const std::vector<AtlasPlacement>& placements) const
+{
+    if (m_numPages == 0)
+    {
+        return 0.0f;
+    }
+    double usedArea = 0.0;
+    for (const AtlasPlacement& placement : placements)
+    {
+        usedArea += (double)placement.m_width * (double)placement.m_height;
+    }
+    return (float)(usedArea / ((double)m_pageWidth * (double)m_pageHeight * (double)m_numPages));
+}
+
+//-----------------------------------------------------------------------------------
+//Lowest resting spot wins, then leftmost.
+bool AtlasPacker::FindPosition(int width, int height, int& outX, int& outY, unsigned int& outSegmentIndex) const
+{
+    bool hasFound = false;
+    for (unsigned int i = 0; i < m_skyline.size(); ++i)
+    {
+        int x = m_skyline[i].m_x;
+        if (x + width > m_pageWidth)
+        {
+            break;
+        }
+        int y = 0;
+        int widthLeft = width;
+        for (unsigned int j = i; widthLeft > 0; ++j)
+        {
+            y = std::max(y, m_skyline[j].m_y);
+            widthLeft -= m_skyline[j].m_width;
+        }
+        if (y + height > m_pageHeight)
+        {
+            continue;
+        }
+        if (!hasFound || y < outY)
+        {
+            hasFound = true;
+            outX = x;
+            outY = y;
+            outSegmentIndex = i;
+        }
+    }
+    return hasFound;
+}
+
+//-----------------------------------------------------------------------------------
+void AtlasPacker::AddToSkyline(unsigned int segmentIndex, int x, int y, int width, int height)
+{
+    m_skyline.insert(m_skyline.begin() + segmentIndex, SkylineSegment{ x, y + height, width });
+
+    //Trim or drop whatever the new segment now shadows.
+    for (unsigned int i = segmentIndex + 1; i < m_skyline.size();)
+    {
+        SkylineSegment& segment = m_skyline[i];
+        int overlap = (x + width) - segment.m_x;
+        if (overlap <= 0)
+        {
+            break;
+        }
+        if (overlap < segment.m_width)
+        {
+            segment.m_x += overlap;
+            segment.m_width -= overlap;
+            break;
+        }
+        m_skyline.erase(m_skyline.begin() + i);
+    }
+
+    //Merge neighbors at the same height so the search stays short.
+    for (unsigned int i = 0; i + 1 < m_skyline.size();)
+    {
+        if (m_skyline[i].m_y == m_skyline[i + 1].m_y)
+        {
+            m_skyline[i].m_width += m_skyline[i + 1].m_width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+struct AtlasPlacement
+{
+    unsigned int m_page;
+    int m_x;
+    int m_y;
+    int m_width;
+    int m_height;
+};
+
+//-----------------------------------------------------------------------------------
+//Skyline bottom-left packer for atlas pages. Each rect gets padding on every side, so the baker can extrude edge
+//texels into it and bilinear sampling never bleeds a neighbor in.
+class AtlasPacker
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    AtlasPacker(int pageWidth, int pageHeight, int padding);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    bool Pack(const std::vector<AtlasPlacement>& sizes, std::vector<AtlasPlacement>& outPlacements);
+    inline unsigned int GetNumPages() const { return m_numPages; };
+    inline int GetPageWidth() const { return m_pageWidth; };
+    inline int GetPageHeight() const { return m_pageHeight; };
+    float CalculateOccupancy(const std::vector<AtlasPlacement>& placements) const;
+
+private:
+    struct SkylineSegment
+    {
+        int m_x;
+        int m_y;
+        int m_width;
+    };
+
+    bool FindPosition(int width, int height, int& outX, int& outY, unsigned int& outSegmentIndex) const;
+    void AddToSkyline(unsigned int segmentIndex, int x, int y, int width, int height);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    int m_pageWidth;
+    int m_pageHeight;
+    int m_padding;
+    unsigned int m_numPages;
+    std::vector<SkylineSegment> m_skyline;
+};
@@ -0,0 +1,219 @@
+#include "Game/Rendering/DecalLayer.hpp"
+#include <math.h>
+#include <string.h>
+
+static const float DEGREES_TO_RADIANS = 3.14159265f / 180.0f;
+
+//-----------------------------------------------------------------------------------
+DecalLayer::DecalLayer(const float worldMins[2], const float worldMaxs[2], float tileSize, float pixelsPerUnit)
+    : m_pixelsPerUnit(pixelsPerUnit)
+    , m_tilePixels((int)ceilf(tileSize * pixelsPerUnit))
+{
+    //Snapped to whole texels, so tile edges land on pixel boundaries and neighbors meet without seams.
+    m_tileSize = (float)m_tilePixels / pixelsPerUnit;
+    m_worldMins[0] = worldMins[0];
+    m_worldMins[1] = worldMins[1];
+    m_numColumns = (unsigned int)ceilf((worldMaxs[0] - worldMins[0]) / m_tileSize);
+    m_numRows = (unsigned int)ceilf((worldMaxs[1] - worldMins[1]) / m_tileSize);
+    m_numColumns = m_numColumns > 0 ? m_numColumns : 1;
+    m_numRows = m_numRows > 0 ? m_numRows : 1;
+    m_tiles.resize(m_numColumns * m_numRows);
+}
+
+//-----------------------------------------------------------------------------------
+//Same corner math as SpriteLayerRenderer::BuildQuad, so a baked sprite lands exactly where it was being drawn.
+void DecalLayer::Bake(const SpriteInstance& sprite, const Image& texture)
+{
+    float radians = sprite.m_rotationDegrees * DEGREES_TO_RADIANS;
+    float cosine = cosf(radians);
+    float sine = sinf(radians);
+    float left = -sprite.m_pivot[0] * sprite.m_scale[0];
+    float bottom = -sprite.m_pivot[1] * sprite.m_scale[1];
+    float right = left + (sprite.m_virtualSize[0] * sprite.m_scale[0]);
+    float top = bottom + (sprite.m_virtualSize[1] * sprite.m_scale[1]);
+    const float corners[4][2] = { { left, bottom }, { right, bottom }, { right, top }, { left, top } };
+
+    //minX, minY, maxX, maxY of the rotated quad.
+    float worldBounds[4] = { 1e30f, 1e30f, -1e30f, -1e30f };
+    for (int i = 0; i < 4; ++i)
+    {
+        float worldX = sprite.m_position[0] + (corners[i][0] * cosine) - (corners[i][1] * sine);
+        float worldY = sprite.m_position[1] + (corners[i][0] * sine) + (corners[i][1] * cosine);
+        worldBounds[0] = worldX < worldBounds[0] ? worldX : worldBounds[0];
+        worldBounds[1] = worldY < worldBounds[1] ? worldY : worldBounds[1];
+        worldBounds[2] = worldX > worldBounds[2] ? worldX : worldBounds[2];
+        worldBounds[3] = worldY > worldBounds[3] ? worldY : worldBounds[3];
+    }
+
+    int firstColumn = (int)floorf((worldBounds[0] - m_worldMins[0]) / m_tileSize);
+    int firstRow = (int)floorf((worldBounds[1] - m_worldMins[1]) / m_tileSize);
+    int lastColumn = (int)floorf((worldBounds[2] - m_worldMins[0]) / m_tileSize);
+    int lastRow = (int)floorf((worldBounds[3] - m_worldMins[1]) / m_tileSize);
+    firstColumn = firstColumn < 0 ? 0 : firstColumn;
+    firstRow = firstRow < 0 ? 0 : firstRow;
+    lastColumn = lastColumn >= (int)m_numColumns ? (int)m_numColumns - 1 : lastColumn;
+    lastRow = lastRow >= (int)m_numRows ? (int)m_numRows - 1 : lastRow;
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        for (int column = firstColumn; column <= lastColumn; ++column)
+        {
+            BakeIntoTile((unsigned int)column, (unsigned int)row, sprite, texture, worldBounds);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Only tiles that changed since the last upload get sent, and each one only once however many decals hit it.
+void DecalLayer::Upload(SpriteRenderBackend& backend)
+{
+    for (Tile& tile : m_tiles)
+    {
+        if (!tile.m_isDirty)
+        {
+            continue;
+        }
+        if (tile.m_texture == 0)
+        {
+            tile.m_texture = backend.CreateTexture(tile.m_texels);
+        }
+        else
+        {
+            backend.UpdateTexture(tile.m_texture, tile.m_texels);
+        }
+        tile.m_isDirty = false;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Gives every uploaded tile a sprite on the layer the first time it's seen, and hides tiles that were cleared. The
+//renderer's culling takes care of tiles that are off screen.
+void DecalLayer::UpdateTileSprites(SpriteLayerRenderer& renderer, int layer)
+{
+    const SpriteLayerRenderer& readOnlyRenderer = renderer;
+    for (unsigned int tileIndex = 0; tileIndex < m_tiles.size(); ++tileIndex)
+    {
+        Tile& tile = m_tiles[tileIndex];
+        if (tile.m_texture == 0)
+        {
+            continue;
+        }
+        if (tile.m_spriteIndex == NO_SPRITE)
+        {
+            SpriteInstance tileSprite;
+            memset(&tileSprite, 0, sizeof(tileSprite));
+            tileSprite.m_texture = tile.m_texture;
+            tileSprite.m_uvMaxs[0] = tileSprite.m_uvMaxs[1] = 1.0f;
+            tileSprite.m_virtualSize[0] = tileSprite.m_virtualSize[1] = m_tileSize;
+            tileSprite.m_position[0] = m_worldMins[0] + ((float)(tileIndex % m_numColumns) * m_tileSize);
+            tileSprite.m_position[1] = m_worldMins[1] + ((float)(tileIndex / m_numColumns) * m_tileSize);
+            tileSprite.m_scale[0] = tileSprite.m_scale[1] = 1.0f;
+            memset(tileSprite.m_tint, 0xFF, sizeof(tileSprite.m_tint));
+            tileSprite.m_isEnabled = !tile.m_isEmpty;
+            tile.m_spriteIndex = renderer.AddSprite(layer, tileSprite);
+        }
+        else if (readOnlyRenderer.GetSprite(layer, tile.m_spriteIndex).m_isEnabled == tile.m_isEmpty)
+        {
+            renderer.GetSprite(layer, tile.m_spriteIndex).m_isEnabled = !tile.m_isEmpty;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void DecalLayer::Clear()
+{
+    for (Tile& tile : m_tiles)
+    {
+        if (!tile.m_isEmpty)
+        {
+            memset(tile.m_texels.m_texels.data(), 0, tile.m_texels.m_texels.size());
+            tile.m_isEmpty = true;
+            tile.m_isDirty = true;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int DecalLayer::GetNumAllocatedTiles() const
+{
+    unsigned int numAllocated = 0;
+    for (const Tile& tile : m_tiles)
+    {
+        numAllocated += tile.m_texels.m_width > 0 ? 1 : 0;
+    }
+    return numAllocated;
+}
+
+//-----------------------------------------------------------------------------------
+//Walks the tile texels under the decal's bounds and maps each texel center back into the sprite, so rotated decals
+//come out with no gaps. Blending is straight-alpha "over", since tiles are drawn like any other sprite texture.
+void DecalLayer::BakeIntoTile(unsigned int column, unsigned int row, const SpriteInstance& sprite, const Image& texture, const float worldBounds[4])
+{
+    Tile& tile = m_tiles[(row * m_numColumns) + column];
+    if (tile.m_texels.m_width == 0)
+    {
+        tile.m_texels.Resize(m_tilePixels, m_tilePixels);
+        memset(tile.m_texels.m_texels.data(), 0, tile.m_texels.m_texels.size());
+    }
+    float tileLeft = m_worldMins[0] + ((float)column * m_tileSize);
+    float tileTop = m_worldMins[1] + ((float)(row + 1) * m_tileSize);
+    int minX = (int)floorf((worldBounds[0] - tileLeft) * m_pixelsPerUnit);
+    int maxX = (int)ceilf((worldBounds[2] - tileLeft) * m_pixelsPerUnit);
+    int minY = (int)floorf((tileTop - worldBounds[3]) * m_pixelsPerUnit);
+    int maxY = (int)ceilf((tileTop - worldBounds[1]) * m_pixelsPerUnit);
+    minX = minX < 0 ? 0 : minX;
+    minY = minY < 0 ? 0 : minY;
+    maxX = maxX > m_tilePixels ? m_tilePixels : maxX;
+    maxY = maxY > m_tilePixels ? m_tilePixels : maxY;
+
+    float radians = sprite.m_rotationDegrees * DEGREES_TO_RADIANS;
+    float cosine = cosf(radians);
+    float sine = sinf(radians);
+    float inverseWidth = 1.0f / (sprite.m_virtualSize[0] * sprite.m_scale[0]);
+    float inverseHeight = 1.0f / (sprite.m_virtualSize[1] * sprite.m_scale[1]);
+    float pivotX = sprite.m_pivot[0] * sprite.m_scale[0];
+    float pivotY = sprite.m_pivot[1] * sprite.m_scale[1];
+    bool hasBaked = false;
+    for (int y = minY; y < maxY; ++y)
+    {
+        float offsetY = (tileTop - (((float)y + 0.5f) / m_pixelsPerUnit)) - sprite.m_position[1];
+        uint8_t* dest = tile.m_texels.GetTexel(minX, y);
+        for (int x = minX; x < maxX; ++x, dest += 4)
+        {
+            float offsetX = (tileLeft + (((float)x + 0.5f) / m_pixelsPerUnit)) - sprite.m_position[0];
+            float fractionX = (((offsetX * cosine) + (offsetY * sine)) + pivotX) * inverseWidth;
+            float fractionY = (((offsetY * cosine) - (offsetX * sine)) + pivotY) * inverseHeight;
+            if (fractionX < 0.0f || fractionX >= 1.0f || fractionY < 0.0f || fractionY >= 1.0f)
+            {
+                continue;
+            }
+            float u = sprite.m_uvMins[0] + (fractionX * (sprite.m_uvMaxs[0] - sprite.m_uvMins[0]));
+            float v = sprite.m_uvMaxs[1] - (fractionY * (sprite.m_uvMaxs[1] - sprite.m_uvMins[1]));
+            int texelX = (int)(u * (float)texture.m_width);
+            int texelY = (int)(v * (float)texture.m_height);
+            texelX = texelX < 0 ? 0 : (texelX >= texture.m_width ? texture.m_width - 1 : texelX);
+            texelY = texelY < 0 ? 0 : (texelY >= texture.m_height ? texture.m_height - 1 : texelY);
+            const uint8_t* texel = texture.GetTexel(texelX, texelY);
+
+            float sourceAlpha = ((float)texel[3] * (float)sprite.m_tint[3]) / (255.0f * 255.0f);
+            if (sourceAlpha <= 0.0f)
+            {
+                continue;
+            }
+            float destAlpha = (float)dest[3] / 255.0f;
+            float outAlpha = sourceAlpha + (destAlpha * (1.0f - sourceAlpha));
+            for (int channel = 0; channel < 3; ++channel)
+            {
+                float source = ((float)texel[channel] * (float)sprite.m_tint[channel]) / 255.0f;
+                float blended = ((source * sourceAlpha) + ((float)dest[channel] * destAlpha * (1.0f - sourceAlpha))) / outAlpha;
+                dest[channel] = (uint8_t)(blended + 0.5f);
+            }
+            dest[3] = (uint8_t)((outAlpha * 255.0f) + 0.5f);
+            hasBaked = true;
+        }
+    }
+    if (hasBaked)
+    {
+        tile.m_isDirty = true;
+        tile.m_isEmpty = false;
+    }
+}
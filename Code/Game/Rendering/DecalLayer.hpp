@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include "Game/Rendering/Image.hpp"
+#include "Game/Rendering/SpriteLayerRenderer.hpp"
+
+//-----------------------------------------------------------------------------------
+//World-space accumulation texture for ground clutter that never moves again, split into tiles over the map bounds.
+//Blood pools and bodies get baked in once and stop being sprites, so however many pile up the layer only ever draws
+//one quad per visible tile. Tiles are allocated the first time something lands on them.
+class DecalLayer
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    DecalLayer(const float worldMins[2], const float worldMaxs[2], float tileSize, float pixelsPerUnit);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Bake(const SpriteInstance& sprite, const Image& texture);
+    void Upload(SpriteRenderBackend& backend);
+    void UpdateTileSprites(SpriteLayerRenderer& renderer, int layer);
+    void Clear();
+    unsigned int GetNumAllocatedTiles() const;
+    inline unsigned int GetNumTiles() const { return (unsigned int)m_tiles.size(); };
+
+private:
+    struct Tile
+    {
+        Tile() : m_texture(0), m_spriteIndex(NO_SPRITE), m_isDirty(false), m_isEmpty(true) {};
+
+        Image m_texels; //Straight alpha, like any other sprite texture. Empty until something is baked here.
+        SpriteTextureHandle m_texture;
+        unsigned int m_spriteIndex;
+        bool m_isDirty;
+        bool m_isEmpty; //Cleared tiles keep their texels and texture for the next match, they just stop drawing.
+    };
+
+    void BakeIntoTile(unsigned int column, unsigned int row, const SpriteInstance& sprite, const Image& texture, const float worldBounds[4]);
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int NO_SPRITE = 0xFFFFFFFF;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<Tile> m_tiles;
+    float m_worldMins[2];
+    float m_tileSize;
+    float m_pixelsPerUnit;
+    int m_tilePixels;
+    unsigned int m_numColumns;
+    unsigned int m_numRows;
+};
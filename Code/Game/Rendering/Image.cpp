@@ -0,0 +1,629 @@
+#define _CRT_SECURE_NO_WARNINGS //Plain stdio keeps these usable from the offline tools.
+#include "Game/Rendering/Image.hpp"
+#include <stdio.h>
+#include <string.h>
+
+//-----------------------------------------------------------------------------------
+//INFLATE/////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------------
+
+namespace
+{
+    //-----------------------------------------------------------------------------------
+    struct BitReader
+    {
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_position;
+        uint32_t m_bitBuffer;
+        int m_numBits;
+        bool m_isOverrun;
+
+        BitReader(const uint8_t* data, size_t size) : m_data(data), m_size(size), m_position(0), m_bitBuffer(0), m_numBits(0), m_isOverrun(false) {};
+
+        uint32_t ReadBits(int count)
+        {
+            while (m_numBits < count)
+            {
+                if (m_position >= m_size)
+                {
+                    m_isOverrun = true;
+                    return 0;
+                }
+                m_bitBuffer |= (uint32_t)m_data[m_position++] << m_numBits;
+                m_numBits += 8;
+            }
+            uint32_t bits = m_bitBuffer & ((1u << count) - 1);
+            m_bitBuffer >>= count;
+            m_numBits -= count;
+            return bits;
+        }
+
+        void AlignToByte()
+        {
+            m_bitBuffer = 0;
+            m_numBits = 0;
+        }
+    };
+
+    //-----------------------------------------------------------------------------------
+    //Canonical Huffman table: how many codes there are of each length, and the symbols in code order.
+    struct HuffmanTable
+    {
+        uint16_t m_counts[16];
+        uint16_t m_symbols[288];
+
+        void Build(const uint8_t* lengths, unsigned int numSymbols)
+        {
+            uint16_t offsets[16];
+            memset(m_counts, 0, sizeof(m_counts));
+            for (unsigned int i = 0; i < numSymbols; ++i)
+            {
+                ++m_counts[lengths[i]];
+            }
+            m_counts[0] = 0;
+            offsets[1] = 0;
+            for (unsigned int length = 1; length < 15; ++length)
+            {
+                offsets[length + 1] = offsets[length] + m_counts[length];
+            }
+            for (unsigned int i = 0; i < numSymbols; ++i)
+            {
+                if (lengths[i] != 0)
+                {
+                    m_symbols[offsets[lengths[i]]++] = (uint16_t)i;
+                }
+            }
+        }
+
+        int Decode(BitReader& reader) const
+        {
+            int code = 0;
+            int first = 0;
+            int index = 0;
+            for (unsigned int length = 1; length < 16; ++length)
+            {
+                code |= (int)reader.ReadBits(1);
+                int count = m_counts[length];
+                if (code - first < count)
+                {
+                    return m_symbols[index + (code - first)];
+                }
+                index += count;
+                first = (first + count) << 1;
+                code <<= 1;
+            }
+            return -1;
+        }
+    };
+
+    static const uint16_t LENGTH_BASES[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static const uint8_t LENGTH_EXTRA_BITS[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static const uint16_t DISTANCE_BASES[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    static const uint8_t DISTANCE_EXTRA_BITS[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+    static const uint8_t CODE_LENGTH_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    //-----------------------------------------------------------------------------------
+    bool InflateBlock(BitReader& reader, const HuffmanTable& literals, const HuffmanTable& distances, std::vector<uint8_t>& output)
+    {
+        while (!reader.m_isOverrun)
+        {
+            int symbol = literals.Decode(reader);
+            if (symbol < 0)
+            {
+                return false;
+            }
+            if (symbol < 256)
+            {
+                output.push_back((uint8_t)symbol);
+                continue;
+            }
+            if (symbol == 256)
+            {
+                return true;
+            }
+            symbol -= 257;
+            if (symbol >= 29)
+            {
+                return false;
+            }
+            size_t length = LENGTH_BASES[symbol] + reader.ReadBits(LENGTH_EXTRA_BITS[symbol]);
+            int distanceSymbol = distances.Decode(reader);
+            if (distanceSymbol < 0 || distanceSymbol >= 30)
+            {
+                return false;
+            }
+            size_t distance = DISTANCE_BASES[distanceSymbol] + reader.ReadBits(DISTANCE_EXTRA_BITS[distanceSymbol]);
+            if (distance > output.size())
+            {
+                return false;
+            }
+            size_t start = output.size() - distance;
+            for (size_t i = 0; i < length; ++i)
+            {
+                output.push_back(output[start + i]);
+            }
+        }
+        return false;
+    }
+
+    //-----------------------------------------------------------------------------------
+    bool ReadDynamicTables(BitReader& reader, HuffmanTable& outLiterals, HuffmanTable& outDistances)
+    {
+        unsigned int numLiteralCodes = reader.ReadBits(5) + 257;
+        unsigned int numDistanceCodes = reader.ReadBits(5) + 1;
+        unsigned int numCodeLengthCodes = reader.ReadBits(4) + 4;
+        uint8_t codeLengthLengths[19] = {};
+        for (unsigned int i = 0; i < numCodeLengthCodes; ++i)
+        {
+            codeLengthLengths[CODE_LENGTH_ORDER[i]] = (uint8_t)reader.ReadBits(3);
+        }
+        HuffmanTable codeLengths;
+        codeLengths.Build(codeLengthLengths, 19);
+
+        uint8_t lengths[288 + 32] = {};
+        unsigned int numLengths = numLiteralCodes + numDistanceCodes;
+        unsigned int index = 0;
+        while (index < numLengths)
+        {
+            int symbol = codeLengths.Decode(reader);
+            if (symbol < 0 || reader.m_isOverrun)
+            {
+                return false;
+            }
+            if (symbol < 16)
+            {
+                lengths[index++] = (uint8_t)symbol;
+                continue;
+            }
+            uint8_t repeatedLength = 0;
+            unsigned int repeatCount = 0;
+            if (symbol == 16)
+            {
+                if (index == 0)
+                {
+                    return false;
+                }
+                repeatedLength = lengths[index - 1];
+                repeatCount = 3 + reader.ReadBits(2);
+            }
+            else if (symbol == 17)
+            {
+                repeatCount = 3 + reader.ReadBits(3);
+            }
+            else
+            {
+                repeatCount = 11 + reader.ReadBits(7);
+            }
+            if (index + repeatCount > numLengths)
+            {
+                return false;
+            }
+            while (repeatCount-- > 0)
+            {
+                lengths[index++] = repeatedLength;
+            }
+        }
+        outLiterals.Build(lengths, numLiteralCodes);
+        outDistances.Build(lengths + numLiteralCodes, numDistanceCodes);
+        return true;
+    }
+
+    //-----------------------------------------------------------------------------------
+    //zlib stream in, raw bytes out. The Adler-32 trailer isn't checked, PNG already CRCs every chunk.
+    bool Inflate(const std::vector<uint8_t>& compressed, std::vector<uint8_t>& output)
+    {
+        if (compressed.size() < 2 || (compressed[0] & 0x0F) != 8 || ((compressed[0] << 8) | compressed[1]) % 31 != 0)
+        {
+            return false;
+        }
+        BitReader reader(compressed.data() + 2, compressed.size() - 2);
+        bool isFinalBlock = false;
+        while (!isFinalBlock)
+        {
+            isFinalBlock = reader.ReadBits(1) != 0;
+            uint32_t blockType = reader.ReadBits(2);
+            if (blockType == 0)
+            {
+                reader.AlignToByte();
+                if (reader.m_position + 4 > reader.m_size)
+                {
+                    return false;
+                }
+                const uint8_t* header = reader.m_data + reader.m_position;
+                size_t length = header[0] | (header[1] << 8);
+                reader.m_position += 4;
+                if (reader.m_position + length > reader.m_size)
+                {
+                    return false;
+                }
+                output.insert(output.end(), reader.m_data + reader.m_position, reader.m_data + reader.m_position + length);
+                reader.m_position += length;
+            }
+            else if (blockType == 1)
+            {
+                uint8_t lengths[288 + 32];
+                memset(lengths, 8, 144);
+                memset(lengths + 144, 9, 112);
+                memset(lengths + 256, 7, 24);
+                memset(lengths + 280, 8, 8);
+                memset(lengths + 288, 5, 32);
+                HuffmanTable literals;
+                HuffmanTable distances;
+                literals.Build(lengths, 288);
+                distances.Build(lengths + 288, 32);
+                if (!InflateBlock(reader, literals, distances, output))
+                {
+                    return false;
+                }
+            }
+            else if (blockType == 2)
+            {
+                HuffmanTable literals;
+                HuffmanTable distances;
+                if (!ReadDynamicTables(reader, literals, distances) || !InflateBlock(reader, literals, distances, output))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //-----------------------------------------------------------------------------------
+    uint32_t CalculateCRC32(const uint8_t* data, size_t size, uint32_t crc = 0)
+    {
+        static uint32_t s_table[256] = {};
+        if (s_table[1] == 0)
+        {
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+                }
+                s_table[i] = value;
+            }
+        }
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i)
+        {
+            crc = s_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    //-----------------------------------------------------------------------------------
+    inline uint32_t ReadBigEndian32(const uint8_t* data)
+    {
+        return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | (uint32_t)data[3];
+    }
+
+    //-----------------------------------------------------------------------------------
+    inline void AppendBigEndian32(std::vector<uint8_t>& output, uint32_t value)
+    {
+        output.push_back((uint8_t)(value >> 24));
+        output.push_back((uint8_t)(value >> 16));
+        output.push_back((uint8_t)(value >> 8));
+        output.push_back((uint8_t)value);
+    }
+
+    //-----------------------------------------------------------------------------------
+    inline uint8_t PaethPredictor(int left, int up, int upLeft)
+    {
+        int estimate = left + up - upLeft;
+        int leftDistance = estimate > left ? estimate - left : left - estimate;
+        int upDistance = estimate > up ? estimate - up : up - estimate;
+        int upLeftDistance = estimate > upLeft ? estimate - upLeft : upLeft - estimate;
+        if (leftDistance <= upDistance && leftDistance <= upLeftDistance)
+        {
+            return (uint8_t)left;
+        }
+        return (uint8_t)(upDistance <= upLeftDistance ? up : upLeft);
+    }
+
+    //-----------------------------------------------------------------------------------
+    bool ReadFile(const std::string& filePath, std::vector<uint8_t>& outBytes)
+    {
+        FILE* file = fopen(filePath.c_str(), "rb");
+        if (!file)
+        {
+            return false;
+        }
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        outBytes.resize(size > 0 ? (size_t)size : 0);
+        size_t numRead = outBytes.empty() ? 0 : fread(outBytes.data(), 1, outBytes.size(), file);
+        fclose(file);
+        return numRead == outBytes.size();
+    }
+
+    //-----------------------------------------------------------------------------------
+    bool WriteFile(const std::string& filePath, const std::vector<uint8_t>& bytes)
+    {
+        FILE* file = fopen(filePath.c_str(), "wb");
+        if (!file)
+        {
+            return false;
+        }
+        size_t numWritten = fwrite(bytes.data(), 1, bytes.size(), file);
+        fclose(file);
+        return numWritten == bytes.size();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//IMAGE/////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------
+Image::Image()
+    : m_width(0)
+    , m_height(0)
+{
+}
+
+//-----------------------------------------------------------------------------------
+Image::Image(int width, int height)
+    : m_width(0)
+    , m_height(0)
+{
+    Resize(width, height);
+}
+
+//-----------------------------------------------------------------------------------
+void Image::Resize(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+    m_texels.assign((size_t)width * (size_t)height * 4, 0);
+}
+
+//-----------------------------------------------------------------------------------
+void Image::Blit(const Image& source, int destX, int destY)
+{
+    for (int row = 0; row < source.m_height; ++row)
+    {
+        memcpy(GetTexel(destX, destY + row), source.GetTexel(0, row), (size_t)source.m_width * 4);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Copies the outermost texels of a rect outward, so filtering at the rect's edge samples its own colors instead of a neighbor's.
+void Image::ExtrudeEdges(int x, int y, int width, int height, int extrusion)
+{
+    for (int row = y; row < y + height; ++row)
+    {
+        for (int step = 1; step <= extrusion; ++step)
+        {
+            memcpy(GetTexel(x - step, row), GetTexel(x, row), 4);
+            memcpy(GetTexel(x + width - 1 + step, row), GetTexel(x + width - 1, row), 4);
+        }
+    }
+    for (int step = 1; step <= extrusion; ++step)
+    {
+        memcpy(GetTexel(x - extrusion, y - step), GetTexel(x - extrusion, y), (size_t)(width + (2 * extrusion)) * 4);
+        memcpy(GetTexel(x - extrusion, y + height - 1 + step), GetTexel(x - extrusion, y + height - 1), (size_t)(width + (2 * extrusion)) * 4);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+bool Image::LoadPNG(const std::string& filePath, std::string& outError)
+{
+    static const uint8_t PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    std::vector<uint8_t> bytes;
+    if (!ReadFile(filePath, bytes))
+    {
+        outError = "couldn't read file";
+        return false;
+    }
+    if (bytes.size() < 8 || memcmp(bytes.data(), PNG_SIGNATURE, 8) != 0)
+    {
+        outError = "not a PNG";
+        return false;
+    }
+
+    //Gather the header, palette and all the image data.
+    int width = 0;
+    int height = 0;
+    uint8_t bitDepth = 0;
+    uint8_t colorType = 0;
+    uint8_t interlaceMethod = 0;
+    uint8_t palette[256 * 4];
+    memset(palette, 0xFF, sizeof(palette));
+    std::vector<uint8_t> compressed;
+    size_t position = 8;
+    while (position + 12 <= bytes.size())
+    {
+        uint32_t length = ReadBigEndian32(&bytes[position]);
+        const uint8_t* type = &bytes[position + 4];
+        const uint8_t* data = &bytes[position + 8];
+        if (position + 12 + length > bytes.size())
+        {
+            outError = "truncated chunk";
+            return false;
+        }
+        if (memcmp(type, "IHDR", 4) == 0 && length >= 13)
+        {
+            width = (int)ReadBigEndian32(data);
+            height = (int)ReadBigEndian32(data + 4);
+            bitDepth = data[8];
+            colorType = data[9];
+            interlaceMethod = data[12];
+        }
+        else if (memcmp(type, "PLTE", 4) == 0)
+        {
+            for (uint32_t i = 0; i < length / 3 && i < 256; ++i)
+            {
+                palette[(i * 4) + 0] = data[(i * 3) + 0];
+                palette[(i * 4) + 1] = data[(i * 3) + 1];
+                palette[(i * 4) + 2] = data[(i * 3) + 2];
+            }
+        }
+        else if (memcmp(type, "tRNS", 4) == 0 && colorType == 3)
+        {
+            for (uint32_t i = 0; i < length && i < 256; ++i)
+            {
+                palette[(i * 4) + 3] = data[i];
+            }
+        }
+        else if (memcmp(type, "IDAT", 4) == 0)
+        {
+            compressed.insert(compressed.end(), data, data + length);
+        }
+        else if (memcmp(type, "IEND", 4) == 0)
+        {
+            break;
+        }
+        position += 12 + length;
+    }
+
+    static const int CHANNELS_PER_COLOR_TYPE[7] = { 1, 0, 3, 1, 2, 0, 4 };
+    if (width <= 0 || height <= 0 || bitDepth != 8 || colorType > 6 || CHANNELS_PER_COLOR_TYPE[colorType] == 0 || interlaceMethod != 0)
+    {
+        outError = "unsupported PNG format (only 8-bit, non-interlaced)";
+        return false;
+    }
+    std::vector<uint8_t> filtered;
+    int bytesPerPixel = CHANNELS_PER_COLOR_TYPE[colorType];
+    size_t stride = (size_t)width * bytesPerPixel;
+    if (!Inflate(compressed, filtered) || filtered.size() < (stride + 1) * height)
+    {
+        outError = "corrupt image data";
+        return false;
+    }
+
+    //Undo the per-row filters in place, then expand to RGBA.
+    Resize(width, height);
+    std::vector<uint8_t> previousRow(stride, 0);
+    std::vector<uint8_t> row(stride);
+    for (int y = 0; y < height; ++y)
+    {
+        const uint8_t* source = &filtered[y * (stride + 1)];
+        uint8_t filterType = source[0];
+        ++source;
+        for (size_t i = 0; i < stride; ++i)
+        {
+            int left = i >= (size_t)bytesPerPixel ? row[i - bytesPerPixel] : 0;
+            int up = previousRow[i];
+            int upLeft = i >= (size_t)bytesPerPixel ? previousRow[i - bytesPerPixel] : 0;
+            switch (filterType)
+            {
+            case 0: row[i] = source[i]; break;
+            case 1: row[i] = (uint8_t)(source[i] + left); break;
+            case 2: row[i] = (uint8_t)(source[i] + up); break;
+            case 3: row[i] = (uint8_t)(source[i] + ((left + up) >> 1)); break;
+            case 4: row[i] = (uint8_t)(source[i] + PaethPredictor(left, up, upLeft)); break;
+            default:
+                outError = "bad row filter";
+                return false;
+            }
+        }
+        for (int x = 0; x < width; ++x)
+        {
+            uint8_t* texel = GetTexel(x, y);
+            const uint8_t* pixel = &row[x * bytesPerPixel];
+            switch (colorType)
+            {
+            case 0: texel[0] = texel[1] = texel[2] = pixel[0]; texel[3] = 0xFF; break;
+            case 2: texel[0] = pixel[0]; texel[1] = pixel[1]; texel[2] = pixel[2]; texel[3] = 0xFF; break;
+            case 3: memcpy(texel, &palette[pixel[0] * 4], 4); break;
+            case 4: texel[0] = texel[1] = texel[2] = pixel[0]; texel[3] = pixel[1]; break;
+            case 6: memcpy(texel, pixel, 4); break;
+            default: break;
+            }
+        }
+        previousRow.swap(row);
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+//Stored (uncompressed) deflate blocks: atlas pages get compressed again by whatever packages the build anyway.
+bool Image::SavePNG(const std::string& filePath) const
+{
+    static const uint8_t PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    static const size_t MAX_STORED_BLOCK_SIZE = 65535;
+
+    std::vector<uint8_t> raw;
+    size_t stride = (size_t)m_width * 4;
+    raw.reserve((stride + 1) * m_height);
+    for (int y = 0; y < m_height; ++y)
+    {
+        raw.push_back(0);
+        raw.insert(raw.end(), m_texels.begin() + (y * stride), m_texels.begin() + ((y + 1) * stride));
+    }
+
+    std::vector<uint8_t> zlib;
+    zlib.push_back(0x78);
+    zlib.push_back(0x01);
+    size_t offset = 0;
+    do
+    {
+        size_t blockSize = raw.size() - offset < MAX_STORED_BLOCK_SIZE ? raw.size() - offset : MAX_STORED_BLOCK_SIZE;
+        bool isFinalBlock = offset + blockSize == raw.size();
+        zlib.push_back(isFinalBlock ? 1 : 0);
+        zlib.push_back((uint8_t)blockSize);
+        zlib.push_back((uint8_t)(blockSize >> 8));
+        zlib.push_back((uint8_t)~blockSize);
+        zlib.push_back((uint8_t)(~blockSize >> 8));
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+        offset += blockSize;
+    } while (offset < raw.size());
+    uint32_t adlerLow = 1;
+    uint32_t adlerHigh = 0;
+    for (uint8_t byte : raw)
+    {
+        adlerLow = (adlerLow + byte) % 65521;
+        adlerHigh = (adlerHigh + adlerLow) % 65521;
+    }
+    AppendBigEndian32(zlib, (adlerHigh << 16) | adlerLow);
+
+    std::vector<uint8_t> file(PNG_SIGNATURE, PNG_SIGNATURE + 8);
+    auto appendChunk = [&file](const char* type, const std::vector<uint8_t>& data)
+    {
+        AppendBigEndian32(file, (uint32_t)data.size());
+        size_t typeStart = file.size();
+        file.insert(file.end(), type, type + 4);
+        file.insert(file.end(), data.begin(), data.end());
+        AppendBigEndian32(file, CalculateCRC32(&file[typeStart], file.size() - typeStart));
+    };
+    std::vector<uint8_t> header;
+    AppendBigEndian32(header, (uint32_t)m_width);
+    AppendBigEndian32(header, (uint32_t)m_height);
+    const uint8_t HEADER_TAIL[5] = { 8, 6, 0, 0, 0 }; //8-bit RGBA, deflate, adaptive filtering, no interlace.
+    header.insert(header.end(), HEADER_TAIL, HEADER_TAIL + 5);
+    appendChunk("IHDR", header);
+    appendChunk("IDAT", zlib);
+    appendChunk("IEND", std::vector<uint8_t>());
+    return WriteFile(filePath, file);
+}
+
+//-----------------------------------------------------------------------------------
+//Uncompressed 32-bit TGA with a top-left origin, for quick dumps that any viewer opens.
+bool Image::SaveTGA(const std::string& filePath) const
+{
+    std::vector<uint8_t> file(18, 0);
+    file[2] = 2; //Uncompressed true-color.
+    file[12] = (uint8_t)m_width;
+    file[13] = (uint8_t)(m_width >> 8);
+    file[14] = (uint8_t)m_height;
+    file[15] = (uint8_t)(m_height >> 8);
+    file[16] = 32;
+    file[17] = 0x28; //8 alpha bits, top-left origin.
+    file.reserve(18 + m_texels.size());
+    for (size_t i = 0; i < m_texels.size(); i += 4)
+    {
+        file.push_back(m_texels[i + 2]);
+        file.push_back(m_texels[i + 1]);
+        file.push_back(m_texels[i + 0]);
+        file.push_back(m_texels[i + 3]);
+    }
+    return WriteFile(filePath, file);
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+//CPU-side RGBA8 image, rows top to bottom. Only depends on the standard library so offline tools and headless builds
+//can load and save pixels without a renderer.
+class Image
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    Image();
+    Image(int width, int height);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Resize(int width, int height);
+    void Blit(const Image& source, int destX, int destY);
+    void ExtrudeEdges(int x, int y, int width, int height, int extrusion);
+    inline uint8_t* GetTexel(int x, int y) { return &m_texels[((y * m_width) + x) * 4]; };
+    inline const uint8_t* GetTexel(int x, int y) const { return &m_texels[((y * m_width) + x) * 4]; };
+
+    //Supports 8-bit grayscale, RGB, palette and RGBA PNGs without interlacing, which covers everything in Data/Images.
+    bool LoadPNG(const std::string& filePath, std::string& outError);
+    bool SavePNG(const std::string& filePath) const;
+    bool SaveTGA(const std::string& filePath) const;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    int m_width;
+    int m_height;
+    std::vector<uint8_t> m_texels;
+};
@@ -0,0 +1,133 @@
+#include "Game/Rendering/OneShotParticlePool.hpp"
+#include "Engine/Renderer/2D/Sprite.hpp"
+#include "Engine/Renderer/2D/SpriteResource.hpp"
+#include "Engine/Renderer/2D/ParticleSystemDefinition.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <utility>
+
+//-----------------------------------------------------------------------------------
+OneShotParticlePool::OneShotParticlePool(int orderingLayer, unsigned int capacity, const std::string& placeholderSpriteName)
+    : m_ages(capacity, 0.0f)
+    , m_lifetimes(capacity, 0.0f)
+    , m_tints(capacity, RGBA::WHITE)
+    , m_isFading(capacity, 0)
+    , m_sprites(capacity, nullptr)
+    , m_numLive(0)
+{
+    ASSERT_OR_DIE(capacity > 0, "A particle pool needs at least one slot to recycle.");
+    for (unsigned int i = 0; i < capacity; ++i)
+    {
+        m_sprites[i] = new Sprite(placeholderSpriteName, orderingLayer);
+        m_sprites[i]->Disable();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+OneShotParticlePool::~OneShotParticlePool()
+{
+    for (Sprite* sprite : m_sprites)
+    {
+        delete sprite;
+    }
+    m_sprites.clear();
+}
+
+//-----------------------------------------------------------------------------------
+//Spawns every emitter's initial burst. One-shot systems don't emit over time, so m_particlesPerSecond is ignored.
+void OneShotParticlePool::Play(const ParticleSystemDefinition& definition, const Vector2& position, float rotationDegrees, const RGBA& tint)
+{
+    for (const ParticleEmitterDefinition* emitter : definition.m_emitterDefinitions)
+    {
+        for (int i = 0; i < emitter->m_initialNumParticlesSpawn; ++i)
+        {
+            unsigned int index = AllocateParticle();
+            m_ages[index] = 0.0f;
+            m_lifetimes[index] = emitter->m_lifetimePerParticle;
+            m_tints[index] = tint;
+            m_isFading[index] = emitter->m_fadeoutEnabled ? 1 : 0;
+
+            Sprite* sprite = m_sprites[index];
+            sprite->m_spriteResource = emitter->m_spriteResource;
+            sprite->m_material = emitter->m_material;
+            sprite->m_position = position;
+            sprite->m_rotationDegrees = rotationDegrees;
+            sprite->m_tintColor = tint;
+            sprite->Enable();
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void OneShotParticlePool::Update(float deltaSeconds)
+{
+    //Walk backwards so a swap-removed particle is always one we've already visited.
+    for (unsigned int i = m_numLive; i-- > 0;)
+    {
+        m_ages[i] += deltaSeconds;
+        if (m_ages[i] >= m_lifetimes[i])
+        {
+            KillParticle(i);
+        }
+        else if (m_isFading[i])
+        {
+            RGBA fadedTint = m_tints[i];
+            fadedTint.alpha = (unsigned char)((float)fadedTint.alpha * (1.0f - (m_ages[i] / m_lifetimes[i])));
+            m_sprites[i]->m_tintColor = fadedTint;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void OneShotParticlePool::Clear()
+{
+    for (unsigned int i = 0; i < m_numLive; ++i)
+    {
+        m_sprites[i]->Disable();
+    }
+    m_numLive = 0;
+}
+
+//-----------------------------------------------------------------------------------
+//When every slot is in use, the particle closest to expiring gets recycled instead.
+unsigned int OneShotParticlePool::AllocateParticle()
+{
+    if (m_numLive < m_sprites.size())
+    {
+        return m_numLive++;
+    }
+    unsigned int oldestIndex = 0;
+    float shortestRemaining = m_lifetimes[0] - m_ages[0];
+    for (unsigned int i = 1; i < m_numLive; ++i)
+    {
+        float remaining = m_lifetimes[i] - m_ages[i];
+        if (remaining < shortestRemaining)
+        {
+            shortestRemaining = remaining;
+            oldestIndex = i;
+        }
+    }
+    return oldestIndex;
+}
+
+//-----------------------------------------------------------------------------------
+void OneShotParticlePool::KillParticle(unsigned int index)
+{
+    m_sprites[index]->Disable();
+    --m_numLive;
+    SwapParticles(index, m_numLive);
+}
+
+//-----------------------------------------------------------------------------------
+//The Sprite goes along with the rest of the state, so a live particle's sprite never has to be re-pointed.
+void OneShotParticlePool::SwapParticles(unsigned int first, unsigned int second)
+{
+    if (first == second)
+    {
+        return;
+    }
+    std::swap(m_ages[first], m_ages[second]);
+    std::swap(m_lifetimes[first], m_lifetimes[second]);
+    std::swap(m_tints[first], m_tints[second]);
+    std::swap(m_isFading[first], m_isFading[second]);
+    std::swap(m_sprites[first], m_sprites[second]);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Renderer/RGBA.hpp"
+
+class Sprite;
+class ParticleSystemDefinition;
+
+//-----------------------------------------------------------------------------------
+//Fixed set of particles on one layer for one-shot effects. Every slot and its Sprite are made up front, and tint,
+//position and rotation are per instance, so playing an effect never allocates or writes to the shared definition.
+//Live particles are kept packed at the front of the arrays, so Update only walks what's alive.
+class OneShotParticlePool
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    //The slots' Sprites are created from placeholderSpriteName, then retargeted to each emitter's resource on Play.
+    OneShotParticlePool(int orderingLayer, unsigned int capacity, const std::string& placeholderSpriteName);
+    ~OneShotParticlePool();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Play(const ParticleSystemDefinition& definition, const Vector2& position, float rotationDegrees, const RGBA& tint);
+    void Update(float deltaSeconds);
+    void Clear();
+    inline unsigned int GetNumLiveParticles() const { return m_numLive; };
+    inline unsigned int GetCapacity() const { return (unsigned int)m_sprites.size(); };
+
+private:
+    OneShotParticlePool(const OneShotParticlePool&) = delete;
+    OneShotParticlePool& operator=(const OneShotParticlePool&) = delete;
+    unsigned int AllocateParticle();
+    void KillParticle(unsigned int index);
+    void SwapParticles(unsigned int first, unsigned int second);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<float> m_ages;
+    std::vector<float> m_lifetimes;
+    std::vector<RGBA> m_tints;
+    std::vector<uint8_t> m_isFading;
+    std::vector<Sprite*> m_sprites;
+    unsigned int m_numLive;
+};
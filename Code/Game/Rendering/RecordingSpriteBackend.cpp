@@ -0,0 +1,74 @@
+#include "Game/Rendering/RecordingSpriteBackend.hpp"
+#include <string.h>
+
+//-----------------------------------------------------------------------------------
+RecordingSpriteBackend::RecordingSpriteBackend()
+    : m_numTextures(0)
+    , m_boundTexture(0)
+    , m_boundMaterial(0)
+{
+    memset(&m_frameStats, 0, sizeof(m_frameStats));
+}
+
+//-----------------------------------------------------------------------------------
+SpriteTextureHandle RecordingSpriteBackend::CreateTexture(const Image&)
+{
+    return (SpriteTextureHandle)++m_numTextures;
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingSpriteBackend::UpdateTexture(SpriteTextureHandle, const Image&)
+{
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingSpriteBackend::BeginFrame(int, int, const uint8_t*)
+{
+    memset(&m_frameStats, 0, sizeof(m_frameStats));
+    m_boundTexture = 0;
+    m_boundMaterial = 0;
+    m_draws.clear();
+    m_vertices.clear();
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingSpriteBackend::BeginLayer()
+{
+    ++m_frameStats.m_numLayers;
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingSpriteBackend::DrawQuads(SpriteMaterialHandle material, SpriteTextureHandle texture, const SpriteVertex* vertices, unsigned int numQuads)
+{
+    ++m_frameStats.m_numDrawCalls;
+    m_frameStats.m_numQuads += numQuads;
+    if (material != m_boundMaterial)
+    {
+        ++m_frameStats.m_numMaterialChanges;
+        m_boundMaterial = material;
+    }
+    if (texture != m_boundTexture)
+    {
+        ++m_frameStats.m_numTextureBinds;
+        m_boundTexture = texture;
+    }
+    RecordedSpriteDraw draw;
+    draw.m_layer = m_frameStats.m_numLayers - 1;
+    draw.m_material = material;
+    draw.m_texture = texture;
+    draw.m_firstVertex = (unsigned int)m_vertices.size();
+    draw.m_numQuads = numQuads;
+    m_draws.push_back(draw);
+    m_vertices.insert(m_vertices.end(), vertices, vertices + (numQuads * 4));
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingSpriteBackend::EndLayer(const LayerEffectFunction*, unsigned int numEffects, float)
+{
+    m_frameStats.m_numEffectPasses += numEffects;
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingSpriteBackend::EndFrame()
+{
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+#include "Game/Rendering/SpriteRenderBackend.hpp"
+
+//-----------------------------------------------------------------------------------
+struct RecordedSpriteDraw
+{
+    unsigned int m_layer;
+    SpriteMaterialHandle m_material;
+    SpriteTextureHandle m_texture;
+    unsigned int m_firstVertex;
+    unsigned int m_numQuads;
+};
+
+//-----------------------------------------------------------------------------------
+//Draws nothing. Keeps the last frame's draws and vertices and counts binds and state changes, so draw submission can
+//be measured and compared without paying for rasterization.
+class RecordingSpriteBackend : public SpriteRenderBackend
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    RecordingSpriteBackend();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    virtual SpriteTextureHandle CreateTexture(const Image& image) override;
+    virtual void UpdateTexture(SpriteTextureHandle texture, const Image& image) override;
+    virtual void BeginFrame(int width, int height, const uint8_t clearColor[4]) override;
+    virtual void BeginLayer() override;
+    virtual void DrawQuads(SpriteMaterialHandle material, SpriteTextureHandle texture, const SpriteVertex* vertices, unsigned int numQuads) override;
+    virtual void EndLayer(const LayerEffectFunction* effects, unsigned int numEffects, float timeSeconds) override;
+    virtual void EndFrame() override;
+    inline const std::vector<RecordedSpriteDraw>& GetDraws() const { return m_draws; };
+    inline const std::vector<SpriteVertex>& GetVertices() const { return m_vertices; };
+    inline unsigned int GetNumStateChanges() const { return m_frameStats.m_numTextureBinds + m_frameStats.m_numMaterialChanges; };
+
+private:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    unsigned int m_numTextures;
+    SpriteTextureHandle m_boundTexture;
+    SpriteMaterialHandle m_boundMaterial;
+    std::vector<RecordedSpriteDraw> m_draws;
+    std::vector<SpriteVertex> m_vertices;
+};
@@ -0,0 +1,132 @@
+#include "Game/Rendering/SpriteBenchmark.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <stdlib.h>
+
+//-----------------------------------------------------------------------------------
+static void AddBenchImages(SpriteBenchmarkConfig& config)
+{
+    config.m_imagePaths.push_back("Data\\Images\\SymmetryCityMap.png");
+    config.m_imagePaths.push_back("Data\\Images\\standingDown.png");
+    config.m_imagePaths.push_back("Data\\Images\\standingUp.png");
+    config.m_imagePaths.push_back("Data\\Images\\swordSwing.png");
+    config.m_imagePaths.push_back("Data\\Images\\arrow.png");
+    config.m_imagePaths.push_back("Data\\Images\\fullHeart.png");
+}
+
+//-----------------------------------------------------------------------------------
+//renderbench <numSprites> <numLayers> [effect] [file.tga]
+CONSOLE_COMMAND(renderbench)
+{
+    SpriteBenchmarkConfig config;
+    config.m_numSprites = args.HasArgs(1) ? (unsigned int)atoi(args.GetStringArgument(0).c_str()) : config.m_numSprites;
+    config.m_numLayers = args.HasArgs(2) ? (unsigned int)atoi(args.GetStringArgument(1).c_str()) : config.m_numLayers;
+    config.m_useLayerEffect = args.HasArgs(3) && atoi(args.GetStringArgument(2).c_str()) != 0;
+    config.m_outputPath = args.HasArgs(4) ? args.GetStringArgument(3) : "";
+    if (config.m_numLayers == 0)
+    {
+        Console::instance->PrintLine("renderbench <numSprites> <numLayers> [effect 0/1] [file.tga]", RGBA::RED);
+        return;
+    }
+    AddBenchImages(config);
+
+    SpriteBenchmarkResult result;
+    SpriteBenchmark::Run(config, result);
+    const SpriteFrameStats& stats = result.m_lastFrameStats;
+    Console::instance->PrintLine(Stringf("%u sprites on %u layers: %.3f ms/frame, %.1f Mpixels/s", config.m_numSprites, config.m_numLayers,
+        result.m_secondsPerFrame * 1000.0, result.m_pixelsPerSecond / 1.0e6), RGBA::WHITE);
+    Console::instance->PrintLine(Stringf("Per frame: %u draws, %u binds, %u quads, %u effect passes, %llu pixels shaded, %llu composited",
+        stats.m_numDrawCalls, stats.m_numTextureBinds, stats.m_numQuads, stats.m_numEffectPasses, (unsigned long long)stats.m_numPixelsShaded, (unsigned long long)stats.m_numPixelsComposited), RGBA::WHITE);
+    if (!config.m_outputPath.empty())
+    {
+        Console::instance->PrintLine(result.m_hasWrittenFrame ? Stringf("Wrote %s", config.m_outputPath.c_str()) : Stringf("Couldn't write %s", config.m_outputPath.c_str()),
+            result.m_hasWrittenFrame ? RGBA::WHITE : RGBA::RED);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//batchbench <numSprites> <numLayers>
+CONSOLE_COMMAND(batchbench)
+{
+    SpriteBenchmarkConfig config;
+    config.m_numSprites = args.HasArgs(1) ? (unsigned int)atoi(args.GetStringArgument(0).c_str()) : config.m_numSprites;
+    config.m_numLayers = args.HasArgs(2) ? (unsigned int)atoi(args.GetStringArgument(1).c_str()) : config.m_numLayers;
+    if (config.m_numLayers == 0)
+    {
+        Console::instance->PrintLine("batchbench <numSprites> <numLayers>", RGBA::RED);
+        return;
+    }
+    AddBenchImages(config);
+
+    SpriteBenchmarkResult unbatched;
+    SpriteBenchmarkResult batched;
+    bool isMatching = SpriteBenchmark::CompareBatching(config, unbatched, batched);
+    const SpriteBenchmarkResult* results[2] = { &unbatched, &batched };
+    for (int i = 0; i < 2; ++i)
+    {
+        config.m_isBatchingEnabled = (i == 1);
+        SpriteBenchmarkResult timing;
+        SpriteBenchmark::Record(config, timing);
+        const SpriteFrameStats& stats = results[i]->m_lastFrameStats;
+        Console::instance->PrintLine(Stringf("%-9s %5u draws, %5u texture binds, %3u material changes, %.3f ms/frame to submit", i == 1 ? "Batched" : "Unbatched",
+            stats.m_numDrawCalls, stats.m_numTextureBinds, stats.m_numMaterialChanges, timing.m_secondsPerFrame * 1000.0), RGBA::WHITE);
+    }
+    if (!isMatching)
+    {
+        Console::instance->PrintLine("Batched frame doesn't match the unbatched one", RGBA::RED);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//cullbench <numSprites> <worldScale>
+CONSOLE_COMMAND(cullbench)
+{
+    SpriteBenchmarkConfig config;
+    config.m_numSprites = args.HasArgs(1) ? (unsigned int)atoi(args.GetStringArgument(0).c_str()) : config.m_numSprites;
+    config.m_worldScale = args.HasArgs(2) ? (float)atof(args.GetStringArgument(1).c_str()) : 4.0f;
+    if (config.m_worldScale <= 0.0f)
+    {
+        Console::instance->PrintLine("cullbench <numSprites> <worldScale>", RGBA::RED);
+        return;
+    }
+    AddBenchImages(config);
+
+    SpriteBenchmarkResult unculled;
+    SpriteBenchmarkResult culled;
+    bool isMatching = SpriteBenchmark::CompareCulling(config, unculled, culled);
+    const SpriteBenchmarkResult* results[2] = { &unculled, &culled };
+    for (int i = 0; i < 2; ++i)
+    {
+        const SpriteFrameStats& stats = results[i]->m_lastFrameStats;
+        Console::instance->PrintLine(Stringf("%-8s %5u quads, %5u culled, %.3f ms/frame", i == 1 ? "Culled" : "Unculled", stats.m_numQuads, results[i]->m_numCulledSprites,
+            results[i]->m_secondsPerFrame * 1000.0), RGBA::WHITE);
+    }
+    if (!isMatching)
+    {
+        Console::instance->PrintLine("Culled frame doesn't match the unculled one", RGBA::RED);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//decalbench <numDecals>
+CONSOLE_COMMAND(decalbench)
+{
+    SpriteBenchmarkConfig config;
+    config.m_numSprites = args.HasArgs(1) ? (unsigned int)atoi(args.GetStringArgument(0).c_str()) : config.m_numSprites;
+    AddBenchImages(config);
+
+    SpriteBenchmarkResult live;
+    SpriteBenchmarkResult baked;
+    bool isMatching = SpriteBenchmark::CompareDecals(config, live, baked);
+    const SpriteBenchmarkResult* results[2] = { &live, &baked };
+    for (int i = 0; i < 2; ++i)
+    {
+        const SpriteFrameStats& stats = results[i]->m_lastFrameStats;
+        Console::instance->PrintLine(Stringf("%-10s %5u quads, %9llu pixels shaded, %.3f ms/frame", i == 1 ? "Baked" : "As sprites",
+            stats.m_numQuads, (unsigned long long)stats.m_numPixelsShaded, results[i]->m_secondsPerFrame * 1000.0), RGBA::WHITE);
+    }
+    if (!isMatching)
+    {
+        Console::instance->PrintLine("Baked frame doesn't match the live one", RGBA::RED);
+    }
+}
@@ -0,0 +1,310 @@
+#include "Game/Rendering/SoftwareSpriteBackend.hpp"
+#include <math.h>
+#include <string.h>
+#include <chrono>
+
+//-----------------------------------------------------------------------------------
+static inline uint32_t MultiplyUnorm8(uint32_t a, uint32_t b)
+{
+    uint32_t product = (a * b) + 128;
+    return (product + (product >> 8)) >> 8;
+}
+
+//-----------------------------------------------------------------------------------
+static inline double GetSeconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//-----------------------------------------------------------------------------------
+SoftwareSpriteBackend::SoftwareSpriteBackend()
+    : m_boundTexture(0)
+    , m_boundMaterial(0)
+    , m_dirtyMinX(1)
+    , m_dirtyMinY(1)
+    , m_dirtyMaxX(0)
+    , m_dirtyMaxY(0)
+{
+    memset(&m_frameStats, 0, sizeof(m_frameStats));
+}
+
+//-----------------------------------------------------------------------------------
+//Handles start at 1 so 0 can mean "nothing bound".
+SpriteTextureHandle SoftwareSpriteBackend::CreateTexture(const Image& image)
+{
+    m_textures.push_back(image);
+    return (SpriteTextureHandle)m_textures.size();
+}
+
+//-----------------------------------------------------------------------------------
+void SoftwareSpriteBackend::UpdateTexture(SpriteTextureHandle texture, const Image& image)
+{
+    m_textures[texture - 1].m_texels = image.m_texels;
+}
+
+//-----------------------------------------------------------------------------------
+void SoftwareSpriteBackend::BeginFrame(int width, int height, const uint8_t clearColor[4])
+{
+    memset(&m_frameStats, 0, sizeof(m_frameStats));
+    if (m_frame.m_width != width || m_frame.m_height != height)
+    {
+        m_frame.Resize(width, height);
+        m_layer.Resize(width, height);
+    }
+    for (size_t i = 0; i < m_frame.m_texels.size(); i += 4)
+    {
+        memcpy(&m_frame.m_texels[i], clearColor, 4);
+    }
+    m_boundTexture = 0;
+    m_boundMaterial = 0;
+}
+
+//-----------------------------------------------------------------------------------
+void SoftwareSpriteBackend::BeginLayer()
+{
+    ++m_frameStats.m_numLayers;
+    m_dirtyMinX = m_layer.m_width;
+    m_dirtyMinY = m_layer.m_height;
+    m_dirtyMaxX = -1;
+    m_dirtyMaxY = -1;
+}
+
+//-----------------------------------------------------------------------------------
+//Quads are four vertices in winding order, split along the 0-2 diagonal.
+void SoftwareSpriteBackend::DrawQuads(SpriteMaterialHandle material, SpriteTextureHandle texture, const SpriteVertex* vertices, unsigned int numQuads)
+{
+    double startSeconds = GetSeconds();
+    ++m_frameStats.m_numDrawCalls;
+    m_frameStats.m_numQuads += numQuads;
+    if (material != m_boundMaterial)
+    {
+        ++m_frameStats.m_numMaterialChanges;
+        m_boundMaterial = material;
+    }
+    if (texture != m_boundTexture)
+    {
+        ++m_frameStats.m_numTextureBinds;
+        m_boundTexture = texture;
+    }
+    if (texture == 0 || texture > m_textures.size())
+    {
+        return;
+    }
+    const Image& textureImage = m_textures[texture - 1];
+    for (unsigned int quadIndex = 0; quadIndex < numQuads; ++quadIndex)
+    {
+        const SpriteVertex* quad = &vertices[quadIndex * 4];
+        RasterizeTriangle(textureImage, quad[0], quad[1], quad[2]);
+        RasterizeTriangle(textureImage, quad[0], quad[2], quad[3]);
+    }
+    m_frameStats.m_rasterSeconds += GetSeconds() - startSeconds;
+}
+
+//-----------------------------------------------------------------------------------
+void SoftwareSpriteBackend::EndLayer(const LayerEffectFunction* effects, unsigned int numEffects, float timeSeconds)
+{
+    double startSeconds = GetSeconds();
+    if (m_dirtyMinX > m_dirtyMaxX && numEffects == 0)
+    {
+        return;
+    }
+
+    //Effects are full-screen passes like the post materials, and may pull texels outside what was drawn.
+    if (numEffects > 0)
+    {
+        for (unsigned int i = 0; i < numEffects; ++i)
+        {
+            effects[i](m_layer, timeSeconds);
+        }
+        m_frameStats.m_numEffectPasses += numEffects;
+        ExpandDirtyRect(0, 0, m_layer.m_width - 1, m_layer.m_height - 1);
+    }
+
+    //Composite the premultiplied layer over the frame and clear it behind us for the next layer.
+    size_t rowBytes = (size_t)(m_dirtyMaxX - m_dirtyMinX + 1) * 4;
+    for (int y = m_dirtyMinY; y <= m_dirtyMaxY; ++y)
+    {
+        uint8_t* source = m_layer.GetTexel(m_dirtyMinX, y);
+        uint8_t* dest = m_frame.GetTexel(m_dirtyMinX, y);
+        for (int x = m_dirtyMinX; x <= m_dirtyMaxX; ++x, source += 4, dest += 4)
+        {
+            uint32_t inverseAlpha = 255 - source[3];
+            dest[0] = (uint8_t)(source[0] + MultiplyUnorm8(dest[0], inverseAlpha));
+            dest[1] = (uint8_t)(source[1] + MultiplyUnorm8(dest[1], inverseAlpha));
+            dest[2] = (uint8_t)(source[2] + MultiplyUnorm8(dest[2], inverseAlpha));
+        }
+        memset(m_layer.GetTexel(m_dirtyMinX, y), 0, rowBytes);
+    }
+    m_frameStats.m_numPixelsComposited += (uint64_t)(m_dirtyMaxX - m_dirtyMinX + 1) * (uint64_t)(m_dirtyMaxY - m_dirtyMinY + 1);
+    m_frameStats.m_rasterSeconds += GetSeconds() - startSeconds;
+}
+
+//-----------------------------------------------------------------------------------
+void SoftwareSpriteBackend::EndFrame()
+{
+    m_boundTexture = 0;
+    m_boundMaterial = 0;
+}
+
+//-----------------------------------------------------------------------------------
+//Edge functions over the triangle's bounds, sampling at pixel centers. A top-left rule keeps the shared diagonal from
+//being drawn twice.
+void SoftwareSpriteBackend::RasterizeTriangle(const Image& texture, const SpriteVertex& a, const SpriteVertex& b, const SpriteVertex& c)
+{
+    float area = ((b.m_x - a.m_x) * (c.m_y - a.m_y)) - ((b.m_y - a.m_y) * (c.m_x - a.m_x));
+    if (area == 0.0f)
+    {
+        return;
+    }
+    const SpriteVertex* v0 = &a;
+    const SpriteVertex* v1 = area > 0.0f ? &b : &c;
+    const SpriteVertex* v2 = area > 0.0f ? &c : &b;
+    float inverseArea = 1.0f / fabsf(area);
+
+    int minX = (int)floorf(fminf(v0->m_x, fminf(v1->m_x, v2->m_x)));
+    int minY = (int)floorf(fminf(v0->m_y, fminf(v1->m_y, v2->m_y)));
+    int maxX = (int)ceilf(fmaxf(v0->m_x, fmaxf(v1->m_x, v2->m_x)));
+    int maxY = (int)ceilf(fmaxf(v0->m_y, fmaxf(v1->m_y, v2->m_y)));
+    minX = minX < 0 ? 0 : minX;
+    minY = minY < 0 ? 0 : minY;
+    maxX = maxX >= m_layer.m_width ? m_layer.m_width - 1 : maxX;
+    maxY = maxY >= m_layer.m_height ? m_layer.m_height - 1 : maxY;
+    if (minX > maxX || minY > maxY)
+    {
+        return;
+    }
+
+    //Edge i is opposite vertex i. Each is linear, so step it across the row instead of re-evaluating.
+    const SpriteVertex* vertices[3] = { v0, v1, v2 };
+    float stepX[3];
+    float stepY[3];
+    float rowStart[3];
+    float bias[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        const SpriteVertex* from = vertices[(i + 1) % 3];
+        const SpriteVertex* to = vertices[(i + 2) % 3];
+        stepX[i] = from->m_y - to->m_y;
+        stepY[i] = to->m_x - from->m_x;
+        rowStart[i] = ((minX + 0.5f - from->m_x) * stepX[i]) + ((minY + 0.5f - from->m_y) * stepY[i]);
+        bool isTopLeft = (stepX[i] > 0.0f) || (stepX[i] == 0.0f && stepY[i] < 0.0f);
+        bias[i] = isTopLeft ? 0.0f : -1.0e-6f;
+    }
+
+    //Texture coordinates are affine in screen space too, so they step the same way, already scaled to texels.
+    float textureWidth = (float)texture.m_width;
+    float textureHeight = (float)texture.m_height;
+    float texelStepX[2];
+    float texelStepY[2];
+    float texelRowStart[2];
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        float scale = (axis == 0 ? textureWidth : textureHeight) * inverseArea;
+        float coordinates[3] = { axis == 0 ? v0->m_u : v0->m_v, axis == 0 ? v1->m_u : v1->m_v, axis == 0 ? v2->m_u : v2->m_v };
+        texelStepX[axis] = ((coordinates[0] * stepX[0]) + (coordinates[1] * stepX[1]) + (coordinates[2] * stepX[2])) * scale;
+        texelStepY[axis] = ((coordinates[0] * stepY[0]) + (coordinates[1] * stepY[1]) + (coordinates[2] * stepY[2])) * scale;
+        texelRowStart[axis] = ((coordinates[0] * rowStart[0]) + (coordinates[1] * rowStart[1]) + (coordinates[2] * rowStart[2])) * scale;
+    }
+
+    //The tint comes from the first vertex; sprites never vary it across a quad.
+    const uint8_t* tint = v0->m_tint;
+    int touchedMinX = maxX + 1;
+    int touchedMaxX = minX - 1;
+    int touchedMinY = maxY + 1;
+    int touchedMaxY = minY - 1;
+    uint64_t numShaded = 0;
+    for (int y = minY; y <= maxY; ++y)
+    {
+        float w0 = rowStart[0];
+        float w1 = rowStart[1];
+        float w2 = rowStart[2];
+        float texelU = texelRowStart[0];
+        float texelV = texelRowStart[1];
+        uint8_t* dest = m_layer.GetTexel(minX, y);
+        for (int x = minX; x <= maxX; ++x, dest += 4, w0 += stepX[0], w1 += stepX[1], w2 += stepX[2], texelU += texelStepX[0], texelV += texelStepX[1])
+        {
+            if (w0 + bias[0] < 0.0f || w1 + bias[1] < 0.0f || w2 + bias[2] < 0.0f)
+            {
+                continue;
+            }
+            int texelX = (int)texelU;
+            int texelY = (int)texelV;
+            texelX = texelX < 0 ? 0 : (texelX >= texture.m_width ? texture.m_width - 1 : texelX);
+            texelY = texelY < 0 ? 0 : (texelY >= texture.m_height ? texture.m_height - 1 : texelY);
+            const uint8_t* texel = texture.GetTexel(texelX, texelY);
+            ++numShaded;
+
+            uint32_t alpha = MultiplyUnorm8(texel[3], tint[3]);
+            if (alpha == 0)
+            {
+                continue;
+            }
+            uint32_t inverseAlpha = 255 - alpha;
+            dest[0] = (uint8_t)(MultiplyUnorm8(MultiplyUnorm8(texel[0], tint[0]), alpha) + MultiplyUnorm8(dest[0], inverseAlpha));
+            dest[1] = (uint8_t)(MultiplyUnorm8(MultiplyUnorm8(texel[1], tint[1]), alpha) + MultiplyUnorm8(dest[1], inverseAlpha));
+            dest[2] = (uint8_t)(MultiplyUnorm8(MultiplyUnorm8(texel[2], tint[2]), alpha) + MultiplyUnorm8(dest[2], inverseAlpha));
+            dest[3] = (uint8_t)(alpha + MultiplyUnorm8(dest[3], inverseAlpha));
+            touchedMinX = x < touchedMinX ? x : touchedMinX;
+            touchedMaxX = x > touchedMaxX ? x : touchedMaxX;
+            touchedMinY = y < touchedMinY ? y : touchedMinY;
+            touchedMaxY = y;
+        }
+        rowStart[0] += stepY[0];
+        rowStart[1] += stepY[1];
+        rowStart[2] += stepY[2];
+        texelRowStart[0] += texelStepY[0];
+        texelRowStart[1] += texelStepY[1];
+    }
+    m_frameStats.m_numPixelsShaded += numShaded;
+    ExpandDirtyRect(touchedMinX, touchedMinY, touchedMaxX, touchedMaxY);
+}
+
+//-----------------------------------------------------------------------------------
+void SoftwareSpriteBackend::ExpandDirtyRect(int minX, int minY, int maxX, int maxY)
+{
+    if (minX > maxX || minY > maxY)
+    {
+        return;
+    }
+    m_dirtyMinX = minX < m_dirtyMinX ? minX : m_dirtyMinX;
+    m_dirtyMinY = minY < m_dirtyMinY ? minY : m_dirtyMinY;
+    m_dirtyMaxX = maxX > m_dirtyMaxX ? maxX : m_dirtyMaxX;
+    m_dirtyMaxY = maxY > m_dirtyMaxY ? maxY : m_dirtyMaxY;
+}
+
+//-----------------------------------------------------------------------------------
+//Same math as the shader: a wobble along x, then a mix between grayscale and a red vignette that shrinks over time.
+//UVs are flipped to match GL's bottom-left origin.
+void SoftwareSpriteBackend::ApplyDeathEffect(Image& layerTexels, float timeSeconds)
+{
+    Image source = layerTexels;
+    for (int y = 0; y < layerTexels.m_height; ++y)
+    {
+        float v = 1.0f - (((float)y + 0.5f) / (float)layerTexels.m_height);
+        float shiftAmount = 0.05f * -cosf((timeSeconds * 4.0f) + (v * 20.0f));
+        for (int x = 0; x < layerTexels.m_width; ++x)
+        {
+            float u = ((float)x + 0.5f) / (float)layerTexels.m_width;
+            int sampleX = (int)((u + shiftAmount) * (float)layerTexels.m_width);
+            sampleX = sampleX < 0 ? 0 : (sampleX >= layerTexels.m_width ? layerTexels.m_width - 1 : sampleX);
+            const uint8_t* texel = source.GetTexel(sampleX, y);
+            float red = texel[0] / 255.0f;
+            float alpha = texel[3] / 255.0f;
+            float grey = (texel[0] + texel[1] + texel[2]) / (3.0f * 255.0f);
+            float offsetU = u - 0.5f;
+            float offsetV = v - 0.5f;
+            float distance = sqrtf((offsetU * offsetU) + (offsetV * offsetV));
+            float inverseRed = 1.0f - ((1.0f / (distance + 0.1f)) - timeSeconds - 1.0f);
+            float outRed = grey + ((red * inverseRed) - grey) * inverseRed;
+            float outGreenBlue = grey - (grey * inverseRed);
+            outRed = outRed < 0.0f ? 0.0f : (outRed > alpha ? alpha : outRed);
+            outGreenBlue = outGreenBlue < 0.0f ? 0.0f : (outGreenBlue > alpha ? alpha : outGreenBlue);
+
+            uint8_t* dest = layerTexels.GetTexel(x, y);
+            dest[0] = (uint8_t)(outRed * 255.0f);
+            dest[1] = (uint8_t)(outGreenBlue * 255.0f);
+            dest[2] = dest[1];
+            dest[3] = texel[3];
+        }
+    }
+}
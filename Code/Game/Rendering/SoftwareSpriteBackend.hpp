@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include "Game/Rendering/SpriteRenderBackend.hpp"
+#include "Game/Rendering/Image.hpp"
+
+//-----------------------------------------------------------------------------------
+//Reference rasterizer for machines without a GPU. Nearest-texel sampling, tint multiply and premultiplied alpha
+//blending, which is what the default sprite material does; other materials are counted but drawn the same way. Only each layer's touched rect gets cleared and composited.
+class SoftwareSpriteBackend : public SpriteRenderBackend
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SoftwareSpriteBackend();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    virtual SpriteTextureHandle CreateTexture(const Image& image) override;
+    virtual void UpdateTexture(SpriteTextureHandle texture, const Image& image) override;
+    virtual void BeginFrame(int width, int height, const uint8_t clearColor[4]) override;
+    virtual void BeginLayer() override;
+    virtual void DrawQuads(SpriteMaterialHandle material, SpriteTextureHandle texture, const SpriteVertex* vertices, unsigned int numQuads) override;
+    virtual void EndLayer(const LayerEffectFunction* effects, unsigned int numEffects, float timeSeconds) override;
+    virtual void EndFrame() override;
+    inline const Image& GetFrame() const { return m_frame; };
+
+    //Port of Data/Shaders/Post/deathEffect.frag.
+    static void ApplyDeathEffect(Image& layerTexels, float timeSeconds);
+
+private:
+    void RasterizeTriangle(const Image& texture, const SpriteVertex& a, const SpriteVertex& b, const SpriteVertex& c);
+    void ExpandDirtyRect(int minX, int minY, int maxX, int maxY);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<Image> m_textures;
+    Image m_frame;
+    Image m_layer;
+    SpriteTextureHandle m_boundTexture;
+    SpriteMaterialHandle m_boundMaterial;
+    int m_dirtyMinX; //Inclusive bounds of what this layer has touched; empty when min > max.
+    int m_dirtyMinY;
+    int m_dirtyMaxX;
+    int m_dirtyMaxY;
+};
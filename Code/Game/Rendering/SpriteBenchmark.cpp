@@ -0,0 +1,369 @@
+#include "Game/Rendering/SpriteBenchmark.hpp"
+#include "Game/Rendering/SoftwareSpriteBackend.hpp"
+#include "Game/Rendering/RecordingSpriteBackend.hpp"
+#include "Game/Rendering/SpriteLayerRenderer.hpp"
+#include "Game/Rendering/Image.hpp"
+#include "Game/Rendering/DecalLayer.hpp"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+//Same view the game uses: 8 units tall, and 16 pixel sprites one unit across.
+const float SpriteBenchmark::VIRTUAL_HEIGHT = 8.0f;
+const float SpriteBenchmark::PIXELS_PER_UNIT = 16.0f;
+static const float BENCH_SECONDS_PER_FRAME = 1.0f / 60.0f;
+static const int CHECKERBOARD_SIZE = 16;
+static const float DECAL_TILE_SIZE = 4.0f;
+static const int DECAL_MISMATCH_THRESHOLD = 16; //Per channel. Baking rounds a little differently to the rasterizer.
+static const double MAX_DECAL_MISMATCH_FRACTION = 0.001; //Texel centers that land exactly on a sprite edge can go either way.
+
+//-----------------------------------------------------------------------------------
+//Fixed seed, so every run and every machine draws the same frames.
+static float GetBenchRandomFloat(uint32_t& state)
+{
+    state = (state * 1664525u) + 1013904223u;
+    return (float)(state >> 8) / 16777216.0f;
+}
+
+//-----------------------------------------------------------------------------------
+//Every quad the frame drew, per layer, in a canonical order. Two frames that put the same sprites in the same layers
+//match no matter how their draws were grouped.
+static std::vector<std::string> GetCanonicalQuads(const RecordingSpriteBackend& backend)
+{
+    std::vector<std::string> quads;
+    for (const RecordedSpriteDraw& draw : backend.GetDraws())
+    {
+        for (unsigned int i = 0; i < draw.m_numQuads; ++i)
+        {
+            std::string quad((const char*)&draw.m_layer, sizeof(draw.m_layer));
+            quad.append((const char*)&draw.m_material, sizeof(draw.m_material));
+            quad.append((const char*)&draw.m_texture, sizeof(draw.m_texture));
+            quad.append((const char*)&backend.GetVertices()[draw.m_firstVertex + (i * 4)], sizeof(SpriteVertex) * 4);
+            quads.push_back(quad);
+        }
+    }
+    std::sort(quads.begin(), quads.end());
+    return quads;
+}
+
+//-----------------------------------------------------------------------------------
+SpriteBenchmarkConfig::SpriteBenchmarkConfig()
+    : m_numSprites(1000)
+    , m_numLayers(4)
+    , m_numFrames(60)
+    , m_pixelWidth(160 * 5)
+    , m_pixelHeight(144 * 5)
+    , m_useLayerEffect(false)
+    , m_isBatchingEnabled(true)
+    , m_isCullingEnabled(true)
+    , m_worldScale(1.0f)
+{
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteBenchmark::Run(const SpriteBenchmarkConfig& config, SpriteBenchmarkResult& outResult)
+{
+    SoftwareSpriteBackend backend;
+    SpriteLayerRenderer renderer(backend, VIRTUAL_HEIGHT, config.m_pixelWidth, config.m_pixelHeight);
+    std::vector<float> velocities;
+    BuildScene(config, backend, renderer, velocities);
+    RenderFrames(config, backend, renderer, velocities, outResult);
+    outResult.m_hasWrittenFrame = !config.m_outputPath.empty() && config.m_numFrames > 0 && backend.GetFrame().SaveTGA(config.m_outputPath);
+}
+
+//-----------------------------------------------------------------------------------
+//Same scene on the recording backend: the frame time is then just the cost of building and submitting draws.
+void SpriteBenchmark::Record(const SpriteBenchmarkConfig& config, SpriteBenchmarkResult& outResult)
+{
+    RecordingSpriteBackend backend;
+    SpriteLayerRenderer renderer(backend, VIRTUAL_HEIGHT, config.m_pixelWidth, config.m_pixelHeight);
+    std::vector<float> velocities;
+    BuildScene(config, backend, renderer, velocities);
+    RenderFrames(config, backend, renderer, velocities, outResult);
+    outResult.m_hasWrittenFrame = false;
+}
+
+//-----------------------------------------------------------------------------------
+//Records one frame with and without batching. False if batching changed what was drawn, or failed to cut draws.
+bool SpriteBenchmark::CompareBatching(const SpriteBenchmarkConfig& config, SpriteBenchmarkResult& outUnbatched, SpriteBenchmarkResult& outBatched)
+{
+    RecordingSpriteBackend backends[2];
+    SpriteBenchmarkResult* results[2] = { &outUnbatched, &outBatched };
+    SpriteBenchmarkConfig frameConfig = config;
+    frameConfig.m_numFrames = 1;
+    for (int i = 0; i < 2; ++i)
+    {
+        SpriteLayerRenderer renderer(backends[i], VIRTUAL_HEIGHT, config.m_pixelWidth, config.m_pixelHeight);
+        frameConfig.m_isBatchingEnabled = (i == 1);
+        std::vector<float> velocities;
+        BuildScene(frameConfig, backends[i], renderer, velocities);
+        RenderFrames(frameConfig, backends[i], renderer, velocities, *results[i]);
+        results[i]->m_hasWrittenFrame = false;
+    }
+    bool isSameFrame = GetCanonicalQuads(backends[0]) == GetCanonicalQuads(backends[1]);
+    return isSameFrame && outBatched.m_lastFrameStats.m_numDrawCalls <= outUnbatched.m_lastFrameStats.m_numDrawCalls;
+}
+
+//-----------------------------------------------------------------------------------
+//Rasterizes the same frames with and without culling. Culled sprites are never on screen, so the frames have to match
+//exactly. False if they don't, or if culling submitted more quads.
+bool SpriteBenchmark::CompareCulling(const SpriteBenchmarkConfig& config, SpriteBenchmarkResult& outUnculled, SpriteBenchmarkResult& outCulled)
+{
+    SoftwareSpriteBackend backends[2];
+    SpriteBenchmarkResult* results[2] = { &outUnculled, &outCulled };
+    SpriteBenchmarkConfig passConfig = config;
+    for (int i = 0; i < 2; ++i)
+    {
+        SpriteLayerRenderer renderer(backends[i], VIRTUAL_HEIGHT, config.m_pixelWidth, config.m_pixelHeight);
+        passConfig.m_isCullingEnabled = (i == 1);
+        std::vector<float> velocities;
+        BuildScene(passConfig, backends[i], renderer, velocities);
+        RenderFrames(passConfig, backends[i], renderer, velocities, *results[i]);
+        results[i]->m_hasWrittenFrame = false;
+    }
+    bool isSameFrame = config.m_numFrames == 0 || backends[0].GetFrame().m_texels == backends[1].GetFrame().m_texels;
+    return isSameFrame && outCulled.m_lastFrameStats.m_numQuads <= outUnculled.m_lastFrameStats.m_numQuads;
+}
+
+//-----------------------------------------------------------------------------------
+//Draws the same pile of static ground decals as sprites and then baked into a DecalLayer. False if the baked frame
+//looks different, or didn't save any quads.
+bool SpriteBenchmark::CompareDecals(const SpriteBenchmarkConfig& config, SpriteBenchmarkResult& outLive, SpriteBenchmarkResult& outBaked)
+{
+    static const uint8_t CLEAR_COLOR[4] = { 0xFF, 0xFF, 0xFF, 0xFF };
+    SoftwareSpriteBackend backends[2];
+    SpriteBenchmarkResult* results[2] = { &outLive, &outBaked };
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        SpriteBenchmarkResult& result = *results[pass];
+        SpriteLayerRenderer renderer(backends[pass], VIRTUAL_HEIGHT, config.m_pixelWidth, config.m_pixelHeight);
+        std::vector<SpriteTextureHandle> textures;
+        std::vector<Image> images;
+        LoadTextures(config, backends[pass], textures, images);
+        AddBackground(renderer, textures[0]);
+
+        float halfWidth = renderer.GetVirtualWidth() * 0.5f;
+        float halfHeight = renderer.GetVirtualHeight() * 0.5f;
+        const float worldMins[2] = { -halfWidth, -halfHeight };
+        const float worldMaxs[2] = { halfWidth, halfHeight };
+        //Baked at the frame's resolution rather than the sprites', so rotated decals are only resampled once.
+        DecalLayer decals(worldMins, worldMaxs, DECAL_TILE_SIZE, (float)config.m_pixelHeight / VIRTUAL_HEIGHT);
+        std::vector<std::pair<SpriteInstance, unsigned int>> decalsToBake;
+        uint32_t randomState = 0xB100D;
+        unsigned int firstDecalImage = textures.size() > 1 ? 1 : 0;
+        for (unsigned int i = 0; i < config.m_numSprites; ++i)
+        {
+            unsigned int imageIndex = firstDecalImage + ((unsigned int)(GetBenchRandomFloat(randomState) * (float)textures.size()) % (textures.size() - firstDecalImage));
+            SpriteInstance decal;
+            memset(&decal, 0, sizeof(decal));
+            decal.m_texture = textures[imageIndex];
+            decal.m_uvMaxs[0] = decal.m_uvMaxs[1] = 1.0f;
+            decal.m_virtualSize[0] = (float)images[imageIndex].m_width / PIXELS_PER_UNIT;
+            decal.m_virtualSize[1] = (float)images[imageIndex].m_height / PIXELS_PER_UNIT;
+            decal.m_pivot[0] = decal.m_virtualSize[0] * 0.5f;
+            decal.m_pivot[1] = decal.m_virtualSize[1] * 0.5f;
+            decal.m_position[0] = (GetBenchRandomFloat(randomState) * 2.0f - 1.0f) * halfWidth;
+            decal.m_position[1] = (GetBenchRandomFloat(randomState) * 2.0f - 1.0f) * halfHeight;
+            decal.m_scale[0] = decal.m_scale[1] = 1.0f;
+            decal.m_rotationDegrees = GetBenchRandomFloat(randomState) * 360.0f;
+            decal.m_tint[0] = (uint8_t)(128 + (GetBenchRandomFloat(randomState) * 127.0f));
+            decal.m_tint[1] = (uint8_t)(128 + (GetBenchRandomFloat(randomState) * 127.0f));
+            decal.m_tint[2] = (uint8_t)(128 + (GetBenchRandomFloat(randomState) * 127.0f));
+            decal.m_tint[3] = 0xFF;
+            decal.m_isEnabled = true;
+            if (pass == 0)
+            {
+                renderer.AddSprite(1, decal);
+            }
+            else
+            {
+                decalsToBake.push_back(std::make_pair(decal, imageIndex));
+            }
+        }
+
+        //Baked in the order the batched layer would have drawn them, so overlaps stack the same way.
+        std::stable_sort(decalsToBake.begin(), decalsToBake.end(), [](const std::pair<SpriteInstance, unsigned int>& first, const std::pair<SpriteInstance, unsigned int>& second)
+        {
+            return first.first.m_texture < second.first.m_texture;
+        });
+        for (const std::pair<SpriteInstance, unsigned int>& decal : decalsToBake)
+        {
+            decals.Bake(decal.first, images[decal.second]);
+        }
+        decals.Upload(backends[pass]);
+        decals.UpdateTileSprites(renderer, 1);
+
+        double rasterSeconds = 0.0;
+        uint64_t numPixels = 0;
+        auto startTime = std::chrono::steady_clock::now();
+        for (unsigned int frame = 0; frame < config.m_numFrames; ++frame)
+        {
+            renderer.Render(CLEAR_COLOR, (float)frame * BENCH_SECONDS_PER_FRAME);
+            rasterSeconds += backends[pass].GetFrameStats().m_rasterSeconds;
+            numPixels += backends[pass].GetFrameStats().m_numPixelsShaded + backends[pass].GetFrameStats().m_numPixelsComposited;
+        }
+        double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        result.m_secondsPerFrame = config.m_numFrames > 0 ? totalSeconds / (double)config.m_numFrames : 0.0;
+        result.m_pixelsPerSecond = rasterSeconds > 0.0 ? (double)numPixels / rasterSeconds : 0.0;
+        result.m_lastFrameStats = backends[pass].GetFrameStats();
+        result.m_numCulledSprites = renderer.GetNumCulledSprites();
+        result.m_hasWrittenFrame = false;
+    }
+    if (config.m_numFrames == 0)
+    {
+        return true;
+    }
+
+    const Image& liveFrame = backends[0].GetFrame();
+    const Image& bakedFrame = backends[1].GetFrame();
+    uint64_t numMismatched = 0;
+    for (size_t i = 0; i < liveFrame.m_texels.size(); i += 4)
+    {
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            if (abs((int)liveFrame.m_texels[i + channel] - (int)bakedFrame.m_texels[i + channel]) > DECAL_MISMATCH_THRESHOLD)
+            {
+                ++numMismatched;
+                break;
+            }
+        }
+    }
+    double mismatchFraction = (double)numMismatched / (double)(liveFrame.m_texels.size() / 4);
+    return mismatchFraction <= MAX_DECAL_MISMATCH_FRACTION && outBaked.m_lastFrameStats.m_numQuads <= outLive.m_lastFrameStats.m_numQuads;
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteBenchmark::LoadTextures(const SpriteBenchmarkConfig& config, SpriteRenderBackend& backend, std::vector<SpriteTextureHandle>& outTextures, std::vector<Image>& outImages)
+{
+    for (const std::string& imagePath : config.m_imagePaths)
+    {
+        Image image;
+        std::string error;
+        if (image.LoadPNG(imagePath, error))
+        {
+            outTextures.push_back(backend.CreateTexture(image));
+            outImages.push_back(image);
+        }
+    }
+    if (outTextures.empty())
+    {
+        Image checkerboard(CHECKERBOARD_SIZE, CHECKERBOARD_SIZE);
+        for (int y = 0; y < CHECKERBOARD_SIZE; ++y)
+        {
+            for (int x = 0; x < CHECKERBOARD_SIZE; ++x)
+            {
+                uint8_t* texel = checkerboard.GetTexel(x, y);
+                texel[0] = texel[1] = texel[2] = ((x / 4) + (y / 4)) % 2 == 0 ? 0xFF : 0x40;
+                texel[3] = (x + y) % 5 == 0 ? 0x00 : 0xFF;
+            }
+        }
+        outTextures.push_back(backend.CreateTexture(checkerboard));
+        outImages.push_back(checkerboard);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//The first image is stretched into a full-screen background on layer 0.
+void SpriteBenchmark::AddBackground(SpriteLayerRenderer& renderer, SpriteTextureHandle texture)
+{
+    SpriteInstance background;
+    memset(&background, 0, sizeof(background));
+    background.m_texture = texture;
+    background.m_uvMaxs[0] = background.m_uvMaxs[1] = 1.0f;
+    background.m_virtualSize[0] = renderer.GetVirtualWidth();
+    background.m_virtualSize[1] = renderer.GetVirtualHeight();
+    background.m_pivot[0] = background.m_virtualSize[0] * 0.5f;
+    background.m_pivot[1] = background.m_virtualSize[1] * 0.5f;
+    background.m_scale[0] = background.m_scale[1] = 1.0f;
+    memset(background.m_tint, 0xFF, sizeof(background.m_tint));
+    background.m_isEnabled = true;
+    renderer.AddSprite(0, background);
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteBenchmark::BuildScene(const SpriteBenchmarkConfig& config, SpriteRenderBackend& backend, SpriteLayerRenderer& renderer, std::vector<float>& outVelocities)
+{
+    renderer.SetBatchingEnabled(config.m_isBatchingEnabled);
+    renderer.SetCullingEnabled(config.m_isCullingEnabled);
+    std::vector<SpriteTextureHandle> textures;
+    std::vector<Image> images;
+    LoadTextures(config, backend, textures, images);
+    AddBackground(renderer, textures[0]);
+
+    //The rest of the images are dealt out as sprites across the layers above the background.
+    uint32_t randomState = 0x5EED;
+    float halfWidth = renderer.GetVirtualWidth() * config.m_worldScale * 0.5f;
+    float halfHeight = renderer.GetVirtualHeight() * config.m_worldScale * 0.5f;
+    unsigned int numLayers = config.m_numLayers > 0 ? config.m_numLayers : 1;
+    unsigned int firstSpriteImage = textures.size() > 1 ? 1 : 0;
+    outVelocities.resize(config.m_numSprites * 2);
+    for (unsigned int i = 0; i < config.m_numSprites; ++i)
+    {
+        unsigned int imageIndex = firstSpriteImage + ((unsigned int)(GetBenchRandomFloat(randomState) * (float)textures.size()) % (textures.size() - firstSpriteImage));
+        SpriteInstance sprite;
+        sprite.m_material = 0;
+        sprite.m_texture = textures[imageIndex];
+        sprite.m_uvMins[0] = sprite.m_uvMins[1] = 0.0f;
+        sprite.m_uvMaxs[0] = sprite.m_uvMaxs[1] = 1.0f;
+        sprite.m_virtualSize[0] = (float)images[imageIndex].m_width / PIXELS_PER_UNIT;
+        sprite.m_virtualSize[1] = (float)images[imageIndex].m_height / PIXELS_PER_UNIT;
+        sprite.m_pivot[0] = sprite.m_virtualSize[0] * 0.5f;
+        sprite.m_pivot[1] = sprite.m_virtualSize[1] * 0.5f;
+        sprite.m_position[0] = (GetBenchRandomFloat(randomState) * 2.0f - 1.0f) * halfWidth;
+        sprite.m_position[1] = (GetBenchRandomFloat(randomState) * 2.0f - 1.0f) * halfHeight;
+        sprite.m_scale[0] = sprite.m_scale[1] = 1.0f;
+        sprite.m_rotationDegrees = GetBenchRandomFloat(randomState) < 0.25f ? GetBenchRandomFloat(randomState) * 360.0f : 0.0f;
+        sprite.m_tint[0] = (uint8_t)(128 + (GetBenchRandomFloat(randomState) * 127.0f));
+        sprite.m_tint[1] = (uint8_t)(128 + (GetBenchRandomFloat(randomState) * 127.0f));
+        sprite.m_tint[2] = (uint8_t)(128 + (GetBenchRandomFloat(randomState) * 127.0f));
+        sprite.m_tint[3] = 0xFF;
+        sprite.m_isEnabled = true;
+        renderer.AddSprite(1 + (int)(i % numLayers), sprite);
+        outVelocities[(i * 2) + 0] = (GetBenchRandomFloat(randomState) * 2.0f) - 1.0f;
+        outVelocities[(i * 2) + 1] = (GetBenchRandomFloat(randomState) * 2.0f) - 1.0f;
+    }
+    if (config.m_useLayerEffect)
+    {
+        renderer.AddEffectToLayer(&SoftwareSpriteBackend::ApplyDeathEffect, (int)numLayers);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteBenchmark::RenderFrames(const SpriteBenchmarkConfig& config, SpriteRenderBackend& backend, SpriteLayerRenderer& renderer, std::vector<float>& velocities,
+    SpriteBenchmarkResult& outResult)
+{
+    static const uint8_t CLEAR_COLOR[4] = { 0xFF, 0xFF, 0xFF, 0xFF };
+    memset(&outResult.m_lastFrameStats, 0, sizeof(outResult.m_lastFrameStats));
+    unsigned int numLayers = config.m_numLayers > 0 ? config.m_numLayers : 1;
+    float halfWidth = renderer.GetVirtualWidth() * config.m_worldScale * 0.5f;
+    float halfHeight = renderer.GetVirtualHeight() * config.m_worldScale * 0.5f;
+    double rasterSeconds = 0.0;
+    uint64_t numPixels = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    for (unsigned int frame = 0; frame < config.m_numFrames; ++frame)
+    {
+        for (unsigned int i = 0; i < config.m_numSprites; ++i)
+        {
+            SpriteInstance& sprite = renderer.GetSprite(1 + (int)(i % numLayers), i / numLayers);
+            for (int axis = 0; axis < 2; ++axis)
+            {
+                float limit = axis == 0 ? halfWidth : halfHeight;
+                float& velocity = velocities[(i * 2) + axis];
+                sprite.m_position[axis] += velocity * BENCH_SECONDS_PER_FRAME;
+                velocity = (sprite.m_position[axis] < -limit || sprite.m_position[axis] > limit) ? -velocity : velocity;
+            }
+        }
+        renderer.Render(CLEAR_COLOR, (float)frame * BENCH_SECONDS_PER_FRAME);
+        const SpriteFrameStats& stats = backend.GetFrameStats();
+        rasterSeconds += stats.m_rasterSeconds;
+        numPixels += stats.m_numPixelsShaded + stats.m_numPixelsComposited;
+    }
+    double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    outResult.m_secondsPerFrame = config.m_numFrames > 0 ? totalSeconds / (double)config.m_numFrames : 0.0;
+    outResult.m_pixelsPerSecond = rasterSeconds > 0.0 ? (double)numPixels / rasterSeconds : 0.0;
+    outResult.m_lastFrameStats = backend.GetFrameStats();
+    outResult.m_numCulledSprites = renderer.GetNumCulledSprites();
+}
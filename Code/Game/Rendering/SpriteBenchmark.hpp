@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Game/Rendering/SpriteRenderBackend.hpp"
+
+class SpriteLayerRenderer;
+class Image;
+
+//-----------------------------------------------------------------------------------
+struct SpriteBenchmarkConfig
+{
+    SpriteBenchmarkConfig();
+
+    std::vector<std::string> m_imagePaths; //The first is the background. With none loaded, a generated checkerboard is used.
+    unsigned int m_numSprites;
+    unsigned int m_numLayers;
+    unsigned int m_numFrames;
+    int m_pixelWidth;
+    int m_pixelHeight;
+    bool m_useLayerEffect; //Death effect on the top layer, like a dead player's foreground.
+    bool m_isBatchingEnabled;
+    bool m_isCullingEnabled;
+    float m_worldScale; //How many screens across and up the sprites wander over. The camera stays on the middle one.
+    std::string m_outputPath; //Last frame goes here as a TGA. Empty to skip.
+};
+
+//-----------------------------------------------------------------------------------
+struct SpriteBenchmarkResult
+{
+    unsigned int m_numCulledSprites; //Last frame.
+    double m_secondsPerFrame;
+    double m_pixelsPerSecond; //Shaded and composited pixels over the time spent rasterizing them.
+    SpriteFrameStats m_lastFrameStats;
+    bool m_hasWrittenFrame;
+};
+
+//-----------------------------------------------------------------------------------
+//Renders a seeded scene of moving sprites, so sprite counts and layer setups can be compared on any machine. Shared by
+//the renderbench, batchbench, cullbench and decalbench console commands and Tools/Main_SpriteBench.cpp.
+class SpriteBenchmark
+{
+public:
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static void Run(const SpriteBenchmarkConfig& config, SpriteBenchmarkResult& outResult);
+    static void Record(const SpriteBenchmarkConfig& config, SpriteBenchmarkResult& outResult);
+    static bool CompareBatching(const SpriteBenchmarkConfig& config, SpriteBenchmarkResult& outUnbatched, SpriteBenchmarkResult& outBatched);
+    static bool CompareCulling(const SpriteBenchmarkConfig& config, SpriteBenchmarkResult& outUnculled, SpriteBenchmarkResult& outCulled);
+    static bool CompareDecals(const SpriteBenchmarkConfig& config, SpriteBenchmarkResult& outLive, SpriteBenchmarkResult& outBaked);
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const float VIRTUAL_HEIGHT;
+    static const float PIXELS_PER_UNIT;
+
+private:
+    static void LoadTextures(const SpriteBenchmarkConfig& config, SpriteRenderBackend& backend, std::vector<SpriteTextureHandle>& outTextures, std::vector<Image>& outImages);
+    static void AddBackground(SpriteLayerRenderer& renderer, SpriteTextureHandle texture);
+    static void BuildScene(const SpriteBenchmarkConfig& config, SpriteRenderBackend& backend, SpriteLayerRenderer& renderer, std::vector<float>& outVelocities);
+    static void RenderFrames(const SpriteBenchmarkConfig& config, SpriteRenderBackend& backend, SpriteLayerRenderer& renderer, std::vector<float>& velocities,
+        SpriteBenchmarkResult& outResult);
+};
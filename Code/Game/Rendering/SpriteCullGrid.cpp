@@ -0,0 +1,136 @@
+#include "Game/Rendering/SpriteCullGrid.hpp"
+#include "Game/Rendering/SpriteLayerRenderer.hpp"
+#include <math.h>
+#include <algorithm>
+
+//Cells span about two average sprites, so a typical sprite only ever reaches into its direct neighbors.
+static const float CELL_SIZE_IN_DIAMETERS = 2.0f;
+static const float MIN_CELL_SIZE = 0.5f;
+
+//-----------------------------------------------------------------------------------
+SpriteCullGrid::SpriteCullGrid()
+    : m_inverseCellSize(1.0f)
+    , m_maxRadius(0.0f)
+    , m_numColumns(1)
+    , m_numRows(1)
+{
+    m_origin[0] = 0.0f;
+    m_origin[1] = 0.0f;
+    m_cellStarts.assign(2, 0);
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteCullGrid::Rebuild(const std::vector<SpriteInstance>& sprites)
+{
+    //Circle around the position that contains the quad at any rotation: the farthest corner from the pivot.
+    m_circles.resize(sprites.size() * 3);
+    float mins[2] = { 1e30f, 1e30f };
+    float maxs[2] = { -1e30f, -1e30f };
+    float diameterSum = 0.0f;
+    unsigned int numIncluded = 0;
+    m_maxRadius = 0.0f;
+    for (unsigned int i = 0; i < sprites.size(); ++i)
+    {
+        const SpriteInstance& sprite = sprites[i];
+        float* circle = &m_circles[i * 3];
+        if (!sprite.m_isEnabled)
+        {
+            circle[2] = -1.0f;
+            continue;
+        }
+        float left = sprite.m_pivot[0] * sprite.m_scale[0];
+        float bottom = sprite.m_pivot[1] * sprite.m_scale[1];
+        float right = (sprite.m_virtualSize[0] * sprite.m_scale[0]) - left;
+        float top = (sprite.m_virtualSize[1] * sprite.m_scale[1]) - bottom;
+        float farX = fabsf(left) > fabsf(right) ? fabsf(left) : fabsf(right);
+        float farY = fabsf(bottom) > fabsf(top) ? fabsf(bottom) : fabsf(top);
+        circle[0] = sprite.m_position[0];
+        circle[1] = sprite.m_position[1];
+        circle[2] = sqrtf((farX * farX) + (farY * farY));
+        m_maxRadius = circle[2] > m_maxRadius ? circle[2] : m_maxRadius;
+        diameterSum += circle[2] * 2.0f;
+        mins[0] = circle[0] < mins[0] ? circle[0] : mins[0];
+        mins[1] = circle[1] < mins[1] ? circle[1] : mins[1];
+        maxs[0] = circle[0] > maxs[0] ? circle[0] : maxs[0];
+        maxs[1] = circle[1] > maxs[1] ? circle[1] : maxs[1];
+        ++numIncluded;
+    }
+    if (numIncluded == 0)
+    {
+        m_numColumns = m_numRows = 1;
+        m_cellStarts.assign(2, 0);
+        m_entries.clear();
+        return;
+    }
+
+    float cellSize = (diameterSum / (float)numIncluded) * CELL_SIZE_IN_DIAMETERS;
+    cellSize = cellSize > MIN_CELL_SIZE ? cellSize : MIN_CELL_SIZE;
+    float largestSpan = (maxs[0] - mins[0]) > (maxs[1] - mins[1]) ? (maxs[0] - mins[0]) : (maxs[1] - mins[1]);
+    cellSize = largestSpan / cellSize > (float)MAX_CELLS_PER_AXIS ? largestSpan / (float)MAX_CELLS_PER_AXIS : cellSize;
+    m_inverseCellSize = 1.0f / cellSize;
+    m_origin[0] = mins[0];
+    m_origin[1] = mins[1];
+    m_numColumns = (int)((maxs[0] - mins[0]) * m_inverseCellSize) + 1;
+    m_numRows = (int)((maxs[1] - mins[1]) * m_inverseCellSize) + 1;
+    m_numColumns = m_numColumns < MAX_CELLS_PER_AXIS ? m_numColumns : MAX_CELLS_PER_AXIS;
+    m_numRows = m_numRows < MAX_CELLS_PER_AXIS ? m_numRows : MAX_CELLS_PER_AXIS;
+
+    //Counting sort by cell: count, prefix sum, then scatter.
+    unsigned int numCells = (unsigned int)(m_numColumns * m_numRows);
+    m_cellStarts.assign(numCells + 1, 0);
+    m_spriteCells.resize(sprites.size());
+    for (unsigned int i = 0; i < sprites.size(); ++i)
+    {
+        const float* circle = &m_circles[i * 3];
+        if (circle[2] >= 0.0f)
+        {
+            m_spriteCells[i] = (unsigned int)((GetRow(circle[1]) * m_numColumns) + GetColumn(circle[0]));
+            ++m_cellStarts[m_spriteCells[i] + 1];
+        }
+    }
+    for (unsigned int cell = 0; cell < numCells; ++cell)
+    {
+        m_cellStarts[cell + 1] += m_cellStarts[cell];
+    }
+    m_entries.resize(numIncluded);
+    for (unsigned int i = 0; i < sprites.size(); ++i)
+    {
+        if (m_circles[(i * 3) + 2] >= 0.0f)
+        {
+            m_entries[m_cellStarts[m_spriteCells[i]]++] = i;
+        }
+    }
+    //The scatter walked every start forward to the next cell's; shift them back.
+    for (unsigned int cell = numCells; cell > 0; --cell)
+    {
+        m_cellStarts[cell] = m_cellStarts[cell - 1];
+    }
+    m_cellStarts[0] = 0;
+}
+
+//-----------------------------------------------------------------------------------
+//Clears outIndices and fills it, in ascending order, with every sprite whose circle touches the box. Indices come back
+//sorted so the layer draws in the same order with or without culling.
+void SpriteCullGrid::Query(const float mins[2], const float maxs[2], std::vector<unsigned int>& outIndices) const
+{
+    outIndices.clear();
+    int minColumn = GetColumn(mins[0] - m_maxRadius);
+    int maxColumn = GetColumn(maxs[0] + m_maxRadius);
+    int minRow = GetRow(mins[1] - m_maxRadius);
+    int maxRow = GetRow(maxs[1] + m_maxRadius);
+    for (int row = minRow; row <= maxRow; ++row)
+    {
+        unsigned int firstCell = (unsigned int)((row * m_numColumns) + minColumn);
+        unsigned int lastCell = (unsigned int)((row * m_numColumns) + maxColumn);
+        for (unsigned int entry = m_cellStarts[firstCell]; entry < m_cellStarts[lastCell + 1]; ++entry)
+        {
+            unsigned int index = m_entries[entry];
+            const float* circle = &m_circles[index * 3];
+            if (circle[0] + circle[2] >= mins[0] && circle[0] - circle[2] <= maxs[0] && circle[1] + circle[2] >= mins[1] && circle[1] - circle[2] <= maxs[1])
+            {
+                outIndices.push_back(index);
+            }
+        }
+    }
+    std::sort(outIndices.begin(), outIndices.end());
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+
+struct SpriteInstance;
+
+//-----------------------------------------------------------------------------------
+//Loose grid over one layer's sprites, the engine-free counterpart of Physics/SpatialGrid. Each enabled sprite sits in
+//the one cell holding its position, bounded by a circle that covers any rotation, and queries grow by the largest
+//radius seen. Cells are sized from the sprites themselves and stored flat, so a rebuild is two passes and no
+//allocation once the layer has settled.
+class SpriteCullGrid
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SpriteCullGrid();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Rebuild(const std::vector<SpriteInstance>& sprites);
+    void Query(const float mins[2], const float maxs[2], std::vector<unsigned int>& outIndices) const;
+    inline unsigned int GetNumSprites() const { return (unsigned int)m_entries.size(); };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const int MAX_CELLS_PER_AXIS = 256;
+
+private:
+    inline int GetColumn(float x) const { return ClampCell((int)((x - m_origin[0]) * m_inverseCellSize), m_numColumns); };
+    inline int GetRow(float y) const { return ClampCell((int)((y - m_origin[1]) * m_inverseCellSize), m_numRows); };
+    static inline int ClampCell(int cell, int numCells) { return cell < 0 ? 0 : (cell >= numCells ? numCells - 1 : cell); };
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    float m_origin[2];
+    float m_inverseCellSize;
+    float m_maxRadius;
+    int m_numColumns;
+    int m_numRows;
+    std::vector<unsigned int> m_cellStarts; //Prefix sums into m_entries, one past the last cell included.
+    std::vector<unsigned int> m_entries; //Sprite indices, grouped by cell.
+    std::vector<float> m_circles; //x, y, radius per sprite index. Radius is negative for sprites left out.
+    std::vector<unsigned int> m_spriteCells; //Scratch for Rebuild.
+};
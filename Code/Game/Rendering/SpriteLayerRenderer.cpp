@@ -0,0 +1,168 @@
+#include "Game/Rendering/SpriteLayerRenderer.hpp"
+#include <math.h>
+#include <algorithm>
+
+static const float DEGREES_TO_RADIANS = 3.14159265f / 180.0f;
+
+//-----------------------------------------------------------------------------------
+SpriteLayerRenderer::SpriteLayerRenderer(SpriteRenderBackend& backend, float virtualHeight, int pixelWidth, int pixelHeight)
+    : m_backend(backend)
+    , m_virtualWidth(virtualHeight * ((float)pixelWidth / (float)pixelHeight))
+    , m_virtualHeight(virtualHeight)
+    , m_pixelWidth(pixelWidth)
+    , m_pixelHeight(pixelHeight)
+    , m_pixelsPerUnit((float)pixelHeight / virtualHeight)
+    , m_isBatchingEnabled(true)
+    , m_isCullingEnabled(true)
+    , m_numCulledSprites(0)
+{
+    m_cameraPosition[0] = 0.0f;
+    m_cameraPosition[1] = 0.0f;
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int SpriteLayerRenderer::AddSprite(int layer, const SpriteInstance& sprite)
+{
+    std::vector<SpriteInstance>& sprites = m_layers[layer].m_sprites;
+    sprites.push_back(sprite);
+    m_layers[layer].m_isGridDirty = true;
+    return (unsigned int)sprites.size() - 1;
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteLayerRenderer::AddEffectToLayer(LayerEffectFunction effect, int layer)
+{
+    m_layers[layer].m_effects.push_back(effect);
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteLayerRenderer::RemoveEffectFromLayer(LayerEffectFunction effect, int layer)
+{
+    std::vector<LayerEffectFunction>& effects = m_layers[layer].m_effects;
+    effects.erase(std::remove(effects.begin(), effects.end(), effect), effects.end());
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteLayerRenderer::SetCameraPosition(float x, float y)
+{
+    m_cameraPosition[0] = x;
+    m_cameraPosition[1] = y;
+}
+
+//-----------------------------------------------------------------------------------
+//Draw order inside a layer was never defined, so batching only has to keep layers apart. The sort is stable anyway,
+//so sprites that share a texture keep the order they were added in.
+void SpriteLayerRenderer::Render(const uint8_t clearColor[4], float timeSeconds)
+{
+    m_backend.BeginFrame(m_pixelWidth, m_pixelHeight, clearColor);
+    m_numCulledSprites = 0;
+    for (auto& pair : m_layers)
+    {
+        Layer& layer = pair.second;
+        m_backend.BeginLayer();
+        GatherVisibleSprites(layer);
+
+        //Materials and textures are small handles, so material, texture and the sprite's index all pack into one key.
+        m_drawKeys.clear();
+        for (unsigned int i : m_visibleSprites)
+        {
+            const SpriteInstance& sprite = layer.m_sprites[i];
+            uint64_t stateKey = m_isBatchingEnabled ? (((uint64_t)(sprite.m_material & 0xFFFF) << 16) | (sprite.m_texture & 0xFFFF)) : 0;
+            m_drawKeys.push_back((stateKey << 32) | i);
+        }
+        if (m_isBatchingEnabled)
+        {
+            std::sort(m_drawKeys.begin(), m_drawKeys.end());
+        }
+
+        m_vertices.resize(m_drawKeys.size() * 4);
+        for (unsigned int i = 0; i < m_drawKeys.size(); ++i)
+        {
+            BuildQuad(layer.m_sprites[(uint32_t)m_drawKeys[i]], &m_vertices[i * 4]);
+        }
+        unsigned int runStart = 0;
+        while (runStart < m_drawKeys.size())
+        {
+            const SpriteInstance& first = layer.m_sprites[(uint32_t)m_drawKeys[runStart]];
+            unsigned int runEnd = runStart + 1;
+            while (m_isBatchingEnabled && runEnd < m_drawKeys.size() && (m_drawKeys[runEnd] >> 32) == (m_drawKeys[runStart] >> 32))
+            {
+                ++runEnd;
+            }
+            m_backend.DrawQuads(first.m_material, first.m_texture, &m_vertices[runStart * 4], runEnd - runStart);
+            runStart = runEnd;
+        }
+        m_backend.EndLayer(layer.m_effects.data(), (unsigned int)layer.m_effects.size(), timeSeconds);
+    }
+    m_backend.EndFrame();
+}
+
+//-----------------------------------------------------------------------------------
+//Fills m_visibleSprites with the layer's enabled sprites, minus whatever the grid says is off camera. Layers nobody has
+//touched since the last frame (backgrounds, corpses, decal tiles) skip the rebuild.
+void SpriteLayerRenderer::GatherVisibleSprites(Layer& layer)
+{
+    if (!m_isCullingEnabled)
+    {
+        m_visibleSprites.clear();
+        for (unsigned int i = 0; i < layer.m_sprites.size(); ++i)
+        {
+            if (layer.m_sprites[i].m_isEnabled)
+            {
+                m_visibleSprites.push_back(i);
+            }
+        }
+        return;
+    }
+
+    if (layer.m_isGridDirty)
+    {
+        layer.m_grid.Rebuild(layer.m_sprites);
+        layer.m_isGridDirty = false;
+    }
+    float halfWidth = m_virtualWidth * 0.5f;
+    float halfHeight = m_virtualHeight * 0.5f;
+    const float cameraMins[2] = { m_cameraPosition[0] - halfWidth, m_cameraPosition[1] - halfHeight };
+    const float cameraMaxs[2] = { m_cameraPosition[0] + halfWidth, m_cameraPosition[1] + halfHeight };
+    layer.m_grid.Query(cameraMins, cameraMaxs, m_visibleSprites);
+    m_numCulledSprites += layer.m_grid.GetNumSprites() - (unsigned int)m_visibleSprites.size();
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteLayerRenderer::Clear()
+{
+    m_layers.clear();
+}
+
+//-----------------------------------------------------------------------------------
+//Corners go bottom-left, bottom-right, top-right, top-left in world space, and come out in frame pixels.
+void SpriteLayerRenderer::BuildQuad(const SpriteInstance& sprite, SpriteVertex* outVertices) const
+{
+    float radians = sprite.m_rotationDegrees * DEGREES_TO_RADIANS;
+    float cosine = cosf(radians);
+    float sine = sinf(radians);
+    float left = -sprite.m_pivot[0] * sprite.m_scale[0];
+    float bottom = -sprite.m_pivot[1] * sprite.m_scale[1];
+    float right = left + (sprite.m_virtualSize[0] * sprite.m_scale[0]);
+    float top = bottom + (sprite.m_virtualSize[1] * sprite.m_scale[1]);
+    const float corners[4][2] = { { left, bottom }, { right, bottom }, { right, top }, { left, top } };
+    const float uvs[4][2] = { { sprite.m_uvMins[0], sprite.m_uvMaxs[1] }, { sprite.m_uvMaxs[0], sprite.m_uvMaxs[1] },
+        { sprite.m_uvMaxs[0], sprite.m_uvMins[1] }, { sprite.m_uvMins[0], sprite.m_uvMins[1] } };
+
+    float centerX = (float)m_pixelWidth * 0.5f;
+    float centerY = (float)m_pixelHeight * 0.5f;
+    for (int i = 0; i < 4; ++i)
+    {
+        float worldX = sprite.m_position[0] + (corners[i][0] * cosine) - (corners[i][1] * sine);
+        float worldY = sprite.m_position[1] + (corners[i][0] * sine) + (corners[i][1] * cosine);
+        SpriteVertex& vertex = outVertices[i];
+        vertex.m_x = centerX + ((worldX - m_cameraPosition[0]) * m_pixelsPerUnit);
+        vertex.m_y = centerY - ((worldY - m_cameraPosition[1]) * m_pixelsPerUnit);
+        vertex.m_u = uvs[i][0];
+        vertex.m_v = uvs[i][1];
+        vertex.m_tint[0] = sprite.m_tint[0];
+        vertex.m_tint[1] = sprite.m_tint[1];
+        vertex.m_tint[2] = sprite.m_tint[2];
+        vertex.m_tint[3] = sprite.m_tint[3];
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <map>
+#include <vector>
+#include "Game/Rendering/SpriteRenderBackend.hpp"
+#include "Game/Rendering/SpriteCullGrid.hpp"
+
+//-----------------------------------------------------------------------------------
+//Everything the backend needs to draw one sprite. Positions and sizes are world units, y up.
+struct SpriteInstance
+{
+    SpriteMaterialHandle m_material;
+    SpriteTextureHandle m_texture;
+    float m_uvMins[2]; //Top-left of the sprite's region.
+    float m_uvMaxs[2];
+    float m_virtualSize[2];
+    float m_pivot[2]; //From the sprite's bottom-left corner, before scaling.
+    float m_position[2];
+    float m_scale[2];
+    float m_rotationDegrees;
+    uint8_t m_tint[4];
+    bool m_isEnabled;
+};
+
+//-----------------------------------------------------------------------------------
+//Engine-free mirror of SpriteGameRenderer's layered model (ordered layers, per-layer effects, a camera over a virtual
+//screen) that drives any SpriteRenderBackend. With culling on, each layer keeps a loose grid of its sprites and only
+//the ones touching the camera's view are submitted. With batching on, those are sorted by material and texture and
+//every run of matching sprites goes out as a single draw.
+class SpriteLayerRenderer
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SpriteLayerRenderer(SpriteRenderBackend& backend, float virtualHeight, int pixelWidth, int pixelHeight);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    unsigned int AddSprite(int layer, const SpriteInstance& sprite);
+    //Handing out a writable sprite means it may move, so the layer's grid gets rebuilt before the next render.
+    inline SpriteInstance& GetSprite(int layer, unsigned int index) { Layer& spriteLayer = m_layers[layer]; spriteLayer.m_isGridDirty = true; return spriteLayer.m_sprites[index]; };
+    inline const SpriteInstance& GetSprite(int layer, unsigned int index) const { return m_layers.at(layer).m_sprites[index]; };
+    void AddEffectToLayer(LayerEffectFunction effect, int layer);
+    void RemoveEffectFromLayer(LayerEffectFunction effect, int layer);
+    void SetCameraPosition(float x, float y);
+    void Render(const uint8_t clearColor[4], float timeSeconds);
+    void Clear();
+    inline void SetBatchingEnabled(bool isEnabled) { m_isBatchingEnabled = isEnabled; };
+    inline void SetCullingEnabled(bool isEnabled) { m_isCullingEnabled = isEnabled; };
+    inline unsigned int GetNumCulledSprites() const { return m_numCulledSprites; }; //Enabled sprites skipped last frame.
+    inline float GetVirtualWidth() const { return m_virtualWidth; };
+    inline float GetVirtualHeight() const { return m_virtualHeight; };
+    inline const float* GetCameraPosition() const { return m_cameraPosition; };
+
+private:
+    struct Layer
+    {
+        Layer() : m_isGridDirty(true) {};
+
+        std::vector<SpriteInstance> m_sprites;
+        std::vector<LayerEffectFunction> m_effects;
+        SpriteCullGrid m_grid;
+        bool m_isGridDirty;
+    };
+
+    void GatherVisibleSprites(Layer& layer);
+
+    void BuildQuad(const SpriteInstance& sprite, SpriteVertex* outVertices) const;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    SpriteRenderBackend& m_backend;
+    std::map<int, Layer> m_layers;
+    float m_virtualWidth;
+    float m_virtualHeight;
+    int m_pixelWidth;
+    int m_pixelHeight;
+    float m_pixelsPerUnit;
+    float m_cameraPosition[2];
+    bool m_isBatchingEnabled;
+    bool m_isCullingEnabled;
+    unsigned int m_numCulledSprites;
+    std::vector<unsigned int> m_visibleSprites; //Scratch for one layer, ascending.
+    std::vector<uint64_t> m_drawKeys; //Scratch for one layer: sort key in the high bits, sprite index in the low.
+    std::vector<SpriteVertex> m_vertices;
+};
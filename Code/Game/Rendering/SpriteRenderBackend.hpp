@@ -0,0 +1,59 @@
+#pragma once
+#include <stdint.h>
+
+class Image;
+
+typedef unsigned int SpriteTextureHandle;
+typedef unsigned int SpriteMaterialHandle; //0 is the default alpha-blended sprite material.
+
+//-----------------------------------------------------------------------------------
+struct SpriteVertex
+{
+    float m_x; //Pixels from the top-left corner of the frame.
+    float m_y;
+    float m_u; //Texture space, (0,0) at the top-left texel.
+    float m_v;
+    uint8_t m_tint[4];
+};
+
+//-----------------------------------------------------------------------------------
+//CPU stand-in for a post-process material. Runs over a layer's premultiplied texels once all its sprites are drawn.
+typedef void (*LayerEffectFunction)(Image& layerTexels, float timeSeconds);
+
+//-----------------------------------------------------------------------------------
+struct SpriteFrameStats
+{
+    unsigned int m_numLayers;
+    unsigned int m_numDrawCalls;
+    unsigned int m_numQuads;
+    unsigned int m_numTextureBinds;
+    unsigned int m_numMaterialChanges;
+    unsigned int m_numEffectPasses;
+    uint64_t m_numPixelsShaded; //Sprite texels written, overdraw included.
+    uint64_t m_numPixelsComposited; //Layer texels blended onto the frame.
+    double m_rasterSeconds;
+};
+
+//-----------------------------------------------------------------------------------
+//The calls SpriteGameRenderer makes into its device, in the order it makes them: every layer is drawn offscreen, gets
+//its effects, then is composited over the frame.
+class SpriteRenderBackend
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    virtual ~SpriteRenderBackend() {};
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    virtual SpriteTextureHandle CreateTexture(const Image& image) = 0;
+    virtual void UpdateTexture(SpriteTextureHandle texture, const Image& image) = 0; //Same size as when it was created.
+    virtual void BeginFrame(int width, int height, const uint8_t clearColor[4]) = 0;
+    virtual void BeginLayer() = 0;
+    virtual void DrawQuads(SpriteMaterialHandle material, SpriteTextureHandle texture, const SpriteVertex* vertices, unsigned int numQuads) = 0;
+    virtual void EndLayer(const LayerEffectFunction* effects, unsigned int numEffects, float timeSeconds) = 0;
+    virtual void EndFrame() = 0;
+    inline const SpriteFrameStats& GetFrameStats() const { return m_frameStats; };
+
+protected:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    SpriteFrameStats m_frameStats;
+};
@@ -0,0 +1,545 @@
+#include "Game/RollbackSession.hpp"
+#include "Game/HostSimulation.hpp"
+#include "Game/TheGame.hpp"
+#include "Game/MessageFragmenter.hpp"
+#include "Game/Entities/Link.hpp"
+#include "Engine/Net/UDPIP/NetMessage.hpp"
+#include "Engine/Net/UDPIP/NetConnection.hpp"
+#include "Engine/Net/UDPIP/NetSession.hpp"
+#include "Engine/Renderer/2D/SpriteGameRenderer.hpp"
+#include "Engine/Renderer/2D/ResourceDatabase.hpp"
+#include "Engine/Renderer/2D/ParticleSystemDefinition.hpp"
+#include "Game/Rendering/OneShotParticlePool.hpp"
+#include "Engine/Audio/Audio.hpp"
+#include "Engine/Math/MathUtilities.hpp"
+#include <string.h>
+
+//Hashed at compile time, so playing an effect is a binary search over IDs instead of a string lookup.
+static constexpr NameID DEAD_LINK_PARTICLE_IDS[2] = { NameID("DeadLink1"), NameID("DeadLink2") };
+static constexpr NameID SWORD_ATTACK_PARTICLE_ID("SwordAttack");
+static constexpr NameID BLOOD_POOL_PARTICLE_ID("BloodPool");
+
+//-----------------------------------------------------------------------------------
+RollbackSession::RollbackSession(uint8_t localPlayerIndex)
+    : m_simulation(new HostSimulation(HostSimulation::ROLLBACK_MODE))
+    , m_localPlayerIndex(localPlayerIndex)
+    , m_targetTick(0)
+    , m_oldestSavedTick(0)
+    , m_firstMispredictedTick(0)
+    , m_hasMisprediction(false)
+{
+    ASSERT_OR_DIE(localPlayerIndex < SimulationState::MAX_PLAYERS, "Rollback sessions need a valid local player index.");
+    InputMap& gameplayMapping = TheGame::instance->m_gameplayMapping;
+    m_localMovementAxes.Resolve(gameplayMapping);
+    m_localAttackValue = gameplayMapping.FindInputValue("Attack");
+    m_localRespawnValue = gameplayMapping.FindInputValue("Respawn");
+    ASSERT_OR_DIE(m_localAttackValue && m_localRespawnValue, "Input mapping is missing its Attack/Respawn values.");
+    for (unsigned int i = 0; i < SimulationState::MAX_PLAYERS; ++i)
+    {
+        StartInputHistory((uint8_t)i, 0);
+        m_presentationLinks[i] = nullptr;
+    }
+    m_simulation->SaveState(m_savedStates[GetSlot(0)]);
+}
+
+//-----------------------------------------------------------------------------------
+RollbackSession::~RollbackSession()
+{
+    for (unsigned int i = 0; i < SimulationState::MAX_PLAYERS; ++i)
+    {
+        delete m_presentationLinks[i];
+    }
+    delete m_simulation;
+}
+
+//-----------------------------------------------------------------------------------
+void RollbackSession::Update(float deltaSeconds)
+{
+    //Anyone whose confirmed inputs are already past us means we've fallen behind the match, so run to catch up.
+    m_targetTick += m_frameClock.Advance(deltaSeconds);
+    for (unsigned int i = 0; i < SimulationState::MAX_PLAYERS; ++i)
+    {
+        const InputHistory& history = m_inputHistories[i];
+        if (i != m_localPlayerIndex && m_simulation->m_isInMatch[i] && (int32_t)(history.m_confirmedEnd - INPUT_DELAY_TICKS - m_targetTick) > 0)
+        {
+            m_targetTick = history.m_confirmedEnd - INPUT_DELAY_TICKS;
+        }
+    }
+    SimulationTick currentTick = m_simulation->m_clock.GetCurrentTick();
+    if ((int32_t)(m_targetTick - currentTick) > (int32_t)MAX_PREDICTION_TICKS)
+    {
+        m_targetTick = currentTick + MAX_PREDICTION_TICKS;
+    }
+
+    RollBack();
+    for (unsigned int i = 0; i < MAX_SIMULATION_TICKS_PER_FRAME; ++i)
+    {
+        if (!m_simulation->m_clock.HasReached(m_targetTick) && CanAdvance())
+        {
+            SimulateTick();
+        }
+    }
+    SendInputs();
+    UpdatePresentation();
+}
+
+//-----------------------------------------------------------------------------------
+void RollbackSession::SimulateTick()
+{
+    SimulationTick tick = m_simulation->m_clock.GetCurrentTick();
+
+    //Our own input is sampled once, the first time we reach a tick, and scheduled a few ticks out so it can reach everyone in time.
+    InputHistory& localHistory = m_inputHistories[m_localPlayerIndex];
+    if (m_simulation->m_isInMatch[m_localPlayerIndex] && (int32_t)(localHistory.m_confirmedEnd - (tick + INPUT_DELAY_TICKS)) <= 0)
+    {
+        PlayerInput localInput = PlayerInput::Sample(m_localMovementAxes, m_localAttackValue, m_localRespawnValue);
+        while ((int32_t)(localHistory.m_confirmedEnd - (tick + INPUT_DELAY_TICKS)) <= 0)
+        {
+            ConfirmInput(m_localPlayerIndex, localHistory.m_confirmedEnd, localInput);
+        }
+    }
+
+    m_simulation->SaveState(m_savedStates[GetSlot(tick)]);
+    for (unsigned int i = 0; i < SimulationState::MAX_PLAYERS; ++i)
+    {
+        PlayerInput input = GetInput((uint8_t)i, tick);
+        m_inputHistories[i].m_simulatedInputs[GetSlot(tick)] = input;
+        if (m_simulation->m_isInMatch[i])
+        {
+            m_simulation->ApplyPlayerInput((uint8_t)i, input, GetInput((uint8_t)i, tick - 1));
+        }
+    }
+    m_simulation->Step();
+}
+
+//-----------------------------------------------------------------------------------
+//Restores the state from the first tick we guessed wrong on and re-simulates back up to where we were.
+void RollbackSession::RollBack()
+{
+    if (!m_hasMisprediction)
+    {
+        return;
+    }
+    m_hasMisprediction = false;
+    SimulationTick resumeTick = m_simulation->m_clock.GetCurrentTick();
+    SimulationTick rollbackTick = (int32_t)(m_firstMispredictedTick - m_oldestSavedTick) < 0 ? m_oldestSavedTick : m_firstMispredictedTick;
+    m_simulation->LoadState(m_savedStates[GetSlot(rollbackTick)]);
+    while (!m_simulation->m_clock.HasReached(resumeTick))
+    {
+        SimulateTick();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Don't run further ahead of anyone than we can afford to roll back.
+bool RollbackSession::CanAdvance() const
+{
+    SimulationTick currentTick = m_simulation->m_clock.GetCurrentTick();
+    for (unsigned int i = 0; i < SimulationState::MAX_PLAYERS; ++i)
+    {
+        if (i != m_localPlayerIndex && m_simulation->m_isInMatch[i] && (int32_t)(currentTick - m_inputHistories[i].m_confirmedEnd) >= (int32_t)MAX_PREDICTION_TICKS)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+void RollbackSession::ConfirmInput(uint8_t index, SimulationTick tick, const PlayerInput& input)
+{
+    InputHistory& history = m_inputHistories[index];
+    ASSERT_OR_DIE(tick == history.m_confirmedEnd, "Inputs must be confirmed in order.");
+    history.m_inputs[GetSlot(tick)] = input;
+    ++history.m_confirmedEnd;
+
+    //Already simulated this tick with a guess, so if the guess was wrong everything since has to be redone.
+    bool wasSimulated = (int32_t)(tick - m_simulation->m_clock.GetCurrentTick()) < 0 && (int32_t)(tick - m_oldestSavedTick) >= 0;
+    if (wasSimulated && history.m_simulatedInputs[GetSlot(tick)] != input)
+    {
+        if (!m_hasMisprediction || (int32_t)(tick - m_firstMispredictedTick) < 0)
+        {
+            m_firstMispredictedTick = tick;
+        }
+        m_hasMisprediction = true;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RollbackSession::StartInputHistory(uint8_t index, SimulationTick startTick)
+{
+    InputHistory& history = m_inputHistories[index];
+    history = InputHistory();
+    history.m_confirmedEnd = startTick;
+}
+
+//-----------------------------------------------------------------------------------
+//Anything we haven't heard yet is predicted as the last thing we did hear.
+PlayerInput RollbackSession::GetInput(uint8_t index, SimulationTick tick) const
+{
+    const InputHistory& history = m_inputHistories[index];
+    if ((int32_t)(tick - history.m_confirmedEnd) < 0)
+    {
+        return history.m_inputs[GetSlot(tick)];
+    }
+    return history.m_inputs[GetSlot(history.m_confirmedEnd - 1)];
+}
+
+//-----------------------------------------------------------------------------------
+//The newest tick whose saved state no later input can change.
+SimulationTick RollbackSession::GetLastConfirmedTick() const
+{
+    SimulationTick lastConfirmedTick = m_simulation->m_clock.GetCurrentTick();
+    for (unsigned int i = 0; i < SimulationState::MAX_PLAYERS; ++i)
+    {
+        if (m_simulation->m_isInMatch[i] && (int32_t)(m_inputHistories[i].m_confirmedEnd - lastConfirmedTick) < 0)
+        {
+            lastConfirmedTick = m_inputHistories[i].m_confirmedEnd;
+        }
+    }
+    return lastConfirmedTick;
+}
+
+//-----------------------------------------------------------------------------------
+void RollbackSession::AddPlayer(uint8_t index, unsigned int color)
+{
+    ASSERT_OR_DIE(index < SimulationState::MAX_PLAYERS, "Invalid index for a rollback player");
+    if (m_simulation->m_isInMatch[index])
+    {
+        return;
+    }
+    RollBack();
+    m_simulation->SaveState(m_savedStates[GetSlot(m_simulation->m_clock.GetCurrentTick())]);
+    SimulationTick rosterTick = GetLastConfirmedTick();
+    SimulationState state;
+    m_simulation->LoadState(m_savedStates[GetSlot(rosterTick)]);
+    m_simulation->m_isInMatch[index] = true;
+    m_simulation->m_playerColors[index] = color;
+    m_simulation->SpawnLink(index, color);
+    m_simulation->SaveState(state);
+    StartInputHistory(index, rosterTick);
+    ApplyRosterChange(state);
+}
+
+//-----------------------------------------------------------------------------------
+//Joining peers are only in once the host's roster change reaches them.
+bool RollbackSession::IsLocalPlayerInMatch() const
+{
+    return m_simulation->m_isInMatch[m_localPlayerIndex];
+}
+
+//-----------------------------------------------------------------------------------
+void RollbackSession::RemovePlayer(uint8_t index)
+{
+    ASSERT_OR_DIE(index < SimulationState::MAX_PLAYERS, "Invalid index for a rollback player");
+    if (!m_simulation->m_isInMatch[index])
+    {
+        return;
+    }
+    RollBack();
+    m_simulation->SaveState(m_savedStates[GetSlot(m_simulation->m_clock.GetCurrentTick())]);
+    SimulationTick rosterTick = GetLastConfirmedTick();
+    SimulationState state = m_savedStates[GetSlot(rosterTick)];
+    state.m_isInMatch[index] = 0;
+    memset(&state.m_links[index], 0, sizeof(LinkState));
+    ApplyRosterChange(state);
+}
+
+//-----------------------------------------------------------------------------------
+//Only the host changes the roster. The new state becomes everyone's starting point, along with every input known after it.
+void RollbackSession::ApplyRosterChange(const SimulationState& state)
+{
+    //Anyone new gets blank inputs to cover the delay before their first real one.
+    SimulationTick resumeTick = m_simulation->m_clock.GetCurrentTick();
+    for (unsigned int i = 0; i < SimulationState::MAX_PLAYERS; ++i)
+    {
+        if (state.m_isInMatch[i] && m_inputHistories[i].m_confirmedEnd == state.m_tick)
+        {
+            for (unsigned int delayTick = 0; delayTick < INPUT_DELAY_TICKS; ++delayTick)
+            {
+                ConfirmInput((uint8_t)i, state.m_tick + delayTick, PlayerInput());
+            }
+        }
+    }
+
+    //The input before the roster tick goes along too, since presses are edges against it. With a full match and a long
+    //input backlog that can outgrow a packet, so it goes through the fragmenter.
+    MessageBuffer message;
+    WriteState(message, state);
+    for (unsigned int i = 0; i < SimulationState::MAX_PLAYERS; ++i)
+    {
+        SimulationTick confirmedEnd = state.m_isInMatch[i] ? m_inputHistories[i].m_confirmedEnd : state.m_tick;
+        message.Write<uint32_t>(confirmedEnd);
+        WriteInputs(message, (uint8_t)i, confirmedEnd, confirmedEnd - state.m_tick + 1);
+    }
+    for (NetConnection* conn : NetSession::instance->m_allConnections)
+    {
+        if (conn && conn->m_index != m_localPlayerIndex)
+        {
+            MessageFragmenter::instance->SendMessage(conn, GameNetMessages::ROLLBACK_STATE, message);
+        }
+    }
+
+    m_savedStates[GetSlot(state.m_tick)] = state;
+    m_oldestSavedTick = state.m_tick;
+    m_hasMisprediction = false;
+    m_simulation->LoadState(state);
+    while (!m_simulation->m_clock.HasReached(resumeTick))
+    {
+        SimulateTick();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RollbackSession::OnRollbackState(const NetSender&, MessageBuffer& message)
+{
+    SimulationState state;
+    ReadState(message, state);
+    for (unsigned int i = 0; i < SimulationState::MAX_PLAYERS; ++i)
+    {
+        SimulationTick confirmedEnd = 0;
+        uint8_t numInputs = 0;
+        uint32_t startTick = 0;
+        message.Read<uint32_t>(confirmedEnd);
+        message.Read<uint32_t>(startTick);
+        message.Read<uint8_t>(numInputs);
+
+        //Inputs only come from their owner, so whichever of us has heard more has the same inputs plus a few.
+        InputHistory& history = m_inputHistories[i];
+        bool wasInMatch = m_simulation->m_isInMatch[i];
+        bool keepOurHistory = wasInMatch && state.m_isInMatch[i] && (int32_t)(history.m_confirmedEnd - confirmedEnd) >= 0;
+        if (!keepOurHistory)
+        {
+            StartInputHistory((uint8_t)i, startTick);
+        }
+        for (unsigned int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+        {
+            uint8_t buttons = 0;
+            message.Read<uint8_t>(buttons);
+            if (!keepOurHistory)
+            {
+                history.m_inputs[GetSlot(startTick + inputIndex)] = PlayerInput(buttons);
+            }
+        }
+        if (!keepOurHistory)
+        {
+            history.m_confirmedEnd = confirmedEnd;
+        }
+    }
+
+    //Everything we simulated from this tick on is suspect now, so redo it from the host's copy.
+    SimulationTick resumeTick = m_simulation->m_clock.GetCurrentTick();
+    m_savedStates[GetSlot(state.m_tick)] = state;
+    m_oldestSavedTick = state.m_tick;
+    m_hasMisprediction = false;
+    m_simulation->LoadState(state);
+    if ((int32_t)(resumeTick - state.m_tick) < 0)
+    {
+        m_targetTick = state.m_tick;
+        return;
+    }
+    while (!m_simulation->m_clock.HasReached(resumeTick))
+    {
+        SimulateTick();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RollbackSession::OnRollbackInput(const NetSender&, NetMessage& message)
+{
+    uint8_t index = NetSession::INVALID_CONNECTION_INDEX;
+    uint32_t startTick = 0;
+    uint8_t numInputs = 0;
+    message.Read<uint8_t>(index);
+    message.Read<uint32_t>(startTick);
+    message.Read<uint8_t>(numInputs);
+    if (index >= SimulationState::MAX_PLAYERS || index == m_localPlayerIndex || !m_simulation->m_isInMatch[index])
+    {
+        return;
+    }
+
+    //Inputs arrive with a lot of overlap and no ordering, so only take the ones that extend what we have without a gap,
+    //and nothing so far ahead that it would overwrite history we could still need to roll back through.
+    InputHistory& history = m_inputHistories[index];
+    SimulationTick acceptLimit = m_simulation->m_clock.GetCurrentTick() + (HISTORY_SIZE - MAX_PREDICTION_TICKS - 1);
+    for (unsigned int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+    {
+        uint8_t buttons = 0;
+        message.Read<uint8_t>(buttons);
+        SimulationTick tick = startTick + inputIndex;
+        if (tick == history.m_confirmedEnd && (int32_t)(tick - acceptLimit) < 0)
+        {
+            ConfirmInput(index, tick, PlayerInput(buttons));
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Unreliable and never acknowledged, so every send repeats enough recent inputs for anyone to fill their gap from it.
+//Clients send their own inputs to the host, and the host passes along everyone's to everyone else.
+void RollbackSession::SendInputs()
+{
+    NetSession* session = NetSession::instance;
+    if (!session->IsHost())
+    {
+        if (session->m_hostConnection && m_simulation->m_isInMatch[m_localPlayerIndex])
+        {
+            NetMessage message(GameNetMessages::ROLLBACK_INPUT);
+            message.Write<uint8_t>(m_localPlayerIndex);
+            WriteInputs(message, m_localPlayerIndex, m_inputHistories[m_localPlayerIndex].m_confirmedEnd, INPUT_REDUNDANCY);
+            session->m_hostConnection->SendMessage(message);
+        }
+        return;
+    }
+    for (NetConnection* conn : session->m_allConnections)
+    {
+        if (!conn || conn->m_index == m_localPlayerIndex)
+        {
+            continue;
+        }
+        for (unsigned int i = 0; i < SimulationState::MAX_PLAYERS; ++i)
+        {
+            if (i != conn->m_index && m_simulation->m_isInMatch[i])
+            {
+                NetMessage message(GameNetMessages::ROLLBACK_INPUT);
+                message.Write<uint8_t>((uint8_t)i);
+                WriteInputs(message, (uint8_t)i, m_inputHistories[i].m_confirmedEnd, INPUT_REDUNDANCY);
+                conn->SendMessage(message);
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Writes the start tick, count and buttons of up to maxInputs confirmed inputs ending just before endTick. Goes into a
+//NetMessage for input relays and a MessageBuffer for roster changes, so the types are pinned by casts, not template arguments.
+template <typename MessageType>
+void RollbackSession::WriteInputs(MessageType& message, uint8_t index, SimulationTick endTick, unsigned int maxInputs) const
+{
+    const InputHistory& history = m_inputHistories[index];
+    unsigned int numInputs = maxInputs < HISTORY_SIZE ? maxInputs : HISTORY_SIZE;
+    SimulationTick startTick = endTick - numInputs;
+    message.Write((uint32_t)startTick);
+    message.Write((uint8_t)numInputs);
+    for (SimulationTick tick = startTick; tick != endTick; ++tick)
+    {
+        message.Write((uint8_t)history.m_inputs[GetSlot(tick)].m_buttons);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RollbackSession::WriteState(MessageBuffer& message, const SimulationState& state)
+{
+    message.Write<uint32_t>(state.m_tick);
+    for (unsigned int i = 0; i < SimulationState::MAX_PLAYERS; ++i)
+    {
+        const LinkState& linkState = state.m_links[i];
+        message.Write<uint32_t>(state.m_playerColors[i]);
+        message.Write<uint8_t>(state.m_isInMatch[i]);
+        message.Write<uint8_t>(linkState.m_isAlive);
+        if (linkState.m_isAlive)
+        {
+            message.Write<float>(linkState.m_positionX);
+            message.Write<float>(linkState.m_positionY);
+            message.Write<float>(linkState.m_hp);
+            message.Write<float>(linkState.m_age);
+            message.Write<uint32_t>(linkState.m_attackStunEndTick);
+            message.Write<uint32_t>(linkState.m_hurtFlashEndTick);
+            message.Write<uint8_t>(linkState.m_facing);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RollbackSession::ReadState(MessageBuffer& message, SimulationState& outState)
+{
+    memset(&outState, 0, sizeof(SimulationState));
+    message.Read<uint32_t>(outState.m_tick);
+    for (unsigned int i = 0; i < SimulationState::MAX_PLAYERS; ++i)
+    {
+        LinkState& linkState = outState.m_links[i];
+        message.Read<uint32_t>(outState.m_playerColors[i]);
+        message.Read<uint8_t>(outState.m_isInMatch[i]);
+        message.Read<uint8_t>(linkState.m_isAlive);
+        if (linkState.m_isAlive)
+        {
+            message.Read<float>(linkState.m_positionX);
+            message.Read<float>(linkState.m_positionY);
+            message.Read<float>(linkState.m_hp);
+            message.Read<float>(linkState.m_age);
+            message.Read<uint32_t>(linkState.m_attackStunEndTick);
+            message.Read<uint32_t>(linkState.m_hurtFlashEndTick);
+            message.Read<uint8_t>(linkState.m_facing);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//The simulation's own Links stay hidden (their sprites feed the hit tests), so these mirror them for display and play
+//the effects a client would have been sent messages for.
+void RollbackSession::UpdatePresentation()
+{
+    static const SoundID spawnSound = AudioSystem::instance->CreateOrGetSound("Data\\SFX\\Oracle_SwordShimmer.wav");
+    static const SoundID deathSound = AudioSystem::instance->CreateOrGetSound("Data\\SFX\\Oracle_Link_Dying.wav");
+    static const SoundID hurtSound = AudioSystem::instance->CreateOrGetSound("Data\\SFX\\Oracle_Link_Hurt.wav");
+    static const SoundID swordSound = AudioSystem::instance->CreateOrGetSound("Data\\SFX\\Oracle_Sword_Slash1.wav");
+
+    for (unsigned int i = 0; i < SimulationState::MAX_PLAYERS; ++i)
+    {
+        Link* simulatedPlayer = m_simulation->m_players[i];
+        Link* shownPlayer = m_presentationLinks[i];
+        if (simulatedPlayer && !shownPlayer)
+        {
+            shownPlayer = new Link(&m_simulation->m_clock);
+            shownPlayer->m_netOwnerIndex = (uint8_t)i;
+            shownPlayer->SetColor(m_simulation->m_playerColors[i]);
+            shownPlayer->m_attackStunEndTick = simulatedPlayer->m_attackStunEndTick;
+            shownPlayer->m_hp = simulatedPlayer->m_hp;
+            m_presentationLinks[i] = shownPlayer;
+            if (i == m_localPlayerIndex)
+            {
+                SpriteGameRenderer::instance->RemoveEffectFromLayer(TheGame::instance->m_playerDeathEffect, TheGame::FOREGROUND_LAYER);
+            }
+            AudioSystem::instance->PlaySound(spawnSound);
+        }
+        else if (!simulatedPlayer && shownPlayer)
+        {
+            const ParticleSystemDefinition* deadLinkSystem = TheGame::instance->m_particleSystems.Find(DEAD_LINK_PARTICLE_IDS[MathUtils::GetRandomIntFromZeroTo(2)]);
+            TheGame::instance->m_bodyParticles->Play(*deadLinkSystem, shownPlayer->m_position, 0.0f, shownPlayer->m_color);
+            TheGame::instance->m_bloodParticles->Play(*TheGame::instance->m_particleSystems.Find(BLOOD_POOL_PARTICLE_ID), shownPlayer->m_position, GetRandomFloatInRange(0.0f, 360.0f), RGBA::WHITE);
+            if (i == m_localPlayerIndex)
+            {
+                SpriteGameRenderer::instance->AddEffectToLayer(TheGame::instance->m_playerDeathEffect, TheGame::FOREGROUND_LAYER);
+            }
+            delete shownPlayer;
+            m_presentationLinks[i] = nullptr;
+            AudioSystem::instance->PlaySound(deathSound);
+            continue;
+        }
+        if (!shownPlayer)
+        {
+            continue;
+        }
+
+        if (simulatedPlayer->m_attackStunEndTick != shownPlayer->m_attackStunEndTick && simulatedPlayer->IsAttacking())
+        {
+            TheGame::instance->m_weaponParticles->Play(*TheGame::instance->m_particleSystems.Find(SWORD_ATTACK_PARTICLE_ID), simulatedPlayer->CalculateSwordPosition(), simulatedPlayer->CalculateSwordRotationDegrees(), shownPlayer->m_color);
+            AudioSystem::instance->PlaySound(swordSound);
+        }
+        if (simulatedPlayer->m_hp < shownPlayer->m_hp)
+        {
+            shownPlayer->m_hurtFlashEndTick = m_simulation->m_clock.GetDeadline(Link::HURT_FLASH_DURATION_TICKS);
+            AudioSystem::instance->PlaySound(hurtSound);
+        }
+        shownPlayer->m_attackStunEndTick = simulatedPlayer->m_attackStunEndTick;
+        shownPlayer->m_position = simulatedPlayer->m_position;
+        shownPlayer->m_facing = simulatedPlayer->m_facing;
+        shownPlayer->m_hp = simulatedPlayer->m_hp;
+        shownPlayer->ApplyClientUpdate();
+    }
+
+    if (m_presentationLinks[m_localPlayerIndex])
+    {
+        SpriteGameRenderer::instance->SetCameraPosition(m_presentationLinks[m_localPlayerIndex]->m_position);
+    }
+}
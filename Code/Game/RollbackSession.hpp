@@ -0,0 +1,85 @@
+#pragma once
+#include <stdint.h>
+#include "Game/SimulationClock.hpp"
+#include "Game/SimulationState.hpp"
+#include "Game/PlayerInput.hpp"
+
+class HostSimulation;
+class Link;
+class NetConnection;
+class NetMessage;
+class MessageBuffer;
+struct NetSender;
+
+//-----------------------------------------------------------------------------------
+//Peer-simulated match for small games: every peer runs its own HostSimulation from the exchanged inputs, predicts remote
+//inputs it hasn't heard yet by repeating their last one, and when a real input disagrees with the prediction it restores
+//the state saved at that tick and re-simulates forward. Inputs are relayed through the host, which also owns the roster:
+//joins and leaves are applied to the last fully confirmed state and sent to every peer as a fresh starting point.
+class RollbackSession
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    RollbackSession(uint8_t localPlayerIndex);
+    ~RollbackSession();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Update(float deltaSeconds);
+    void AddPlayer(uint8_t index, unsigned int color);
+    void RemovePlayer(uint8_t index);
+    void OnRollbackInput(const NetSender& from, NetMessage& message);
+    void OnRollbackState(const NetSender& from, MessageBuffer& message);
+    bool IsLocalPlayerInMatch() const;
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int HISTORY_SIZE = 32; //Power of two, ring buffers are indexed by tick.
+    static const SimulationTick INPUT_DELAY_TICKS = 2;
+    static const SimulationTick MAX_PREDICTION_TICKS = 12;
+    static const unsigned int MAX_SIMULATION_TICKS_PER_FRAME = 8;
+    static const unsigned int INPUT_REDUNDANCY = (2 * MAX_PREDICTION_TICKS) + (2 * INPUT_DELAY_TICKS) + 2; //Widest gap peers can open up between them.
+
+private:
+    struct InputHistory
+    {
+        PlayerInput m_inputs[HISTORY_SIZE];
+        PlayerInput m_simulatedInputs[HISTORY_SIZE]; //What we actually stepped with, confirmed or predicted.
+        SimulationTick m_confirmedEnd; //Every tick before this has a confirmed input.
+    };
+
+    RollbackSession(const RollbackSession&) = delete;
+    RollbackSession& operator= (const RollbackSession&) = delete;
+
+    void SimulateTick();
+    void RollBack();
+    bool CanAdvance() const;
+    void ConfirmInput(uint8_t index, SimulationTick tick, const PlayerInput& input);
+    void StartInputHistory(uint8_t index, SimulationTick startTick);
+    PlayerInput GetInput(uint8_t index, SimulationTick tick) const;
+    SimulationTick GetLastConfirmedTick() const;
+    void ApplyRosterChange(const SimulationState& state);
+    void SendInputs();
+    template <typename MessageType>
+    void WriteInputs(MessageType& message, uint8_t index, SimulationTick endTick, unsigned int maxInputs) const;
+    void UpdatePresentation();
+    static void WriteState(MessageBuffer& message, const SimulationState& state);
+    static void ReadState(MessageBuffer& message, SimulationState& outState);
+    static inline unsigned int GetSlot(SimulationTick tick) { return tick & (HISTORY_SIZE - 1); };
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    HostSimulation* m_simulation;
+    SimulationClock m_frameClock;
+    uint8_t m_localPlayerIndex;
+    SimulationTick m_targetTick;
+    SimulationTick m_oldestSavedTick;
+    SimulationTick m_firstMispredictedTick;
+    bool m_hasMisprediction;
+    InputHistory m_inputHistories[SimulationState::MAX_PLAYERS];
+    SimulationState m_savedStates[HISTORY_SIZE]; //The state at the start of each tick.
+    Link* m_presentationLinks[SimulationState::MAX_PLAYERS];
+    MovementAxes m_localMovementAxes; //Resolved from the gameplay mapping once, since the local input is sampled every tick.
+    InputValue* m_localAttackValue;
+    InputValue* m_localRespawnValue;
+};
+
+static_assert((RollbackSession::HISTORY_SIZE & (RollbackSession::HISTORY_SIZE - 1)) == 0, "Rollback history is indexed by masking the tick.");
+static_assert(RollbackSession::INPUT_REDUNDANCY < RollbackSession::HISTORY_SIZE, "Can't resend more inputs than we keep.");
@@ -0,0 +1,26 @@
+#include "Game/SimulationClock.hpp"
+
+const float SimulationClock::SECONDS_PER_TICK = 1.0f / (float)SimulationClock::TICKS_PER_SECOND;
+
+//-----------------------------------------------------------------------------------
+SimulationClock::SimulationClock()
+    : m_currentTick(0)
+    , m_accumulatedSeconds(0.0f)
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+//Banks the frame's time and returns how many ticks are due. The caller runs that many, calling Tick() after each one.
+unsigned int SimulationClock::Advance(float deltaSeconds)
+{
+    m_accumulatedSeconds += deltaSeconds;
+    unsigned int numTicks = (unsigned int)(m_accumulatedSeconds / SECONDS_PER_TICK);
+    m_accumulatedSeconds -= numTicks * SECONDS_PER_TICK;
+    if (numTicks > MAX_TICKS_PER_ADVANCE)
+    {
+        //After a long hitch, drop the backlog instead of trying to catch up and falling further behind.
+        numTicks = MAX_TICKS_PER_ADVANCE;
+    }
+    return numTicks;
+}
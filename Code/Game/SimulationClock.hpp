@@ -0,0 +1,33 @@
+#pragma once
+#include <stdint.h>
+
+typedef uint32_t SimulationTick;
+
+//-----------------------------------------------------------------------------------
+//Fixed-rate simulation time. Gameplay asks the clock for the current tick instead of reading the wall clock,
+//and stores every timed window (stuns, flashes, cooldowns) as the tick it ends on.
+class SimulationClock
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SimulationClock();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    unsigned int Advance(float deltaSeconds);
+    inline void Tick() { ++m_currentTick; };
+    inline void SetCurrentTick(SimulationTick tick) { m_currentTick = tick; };
+    inline SimulationTick GetCurrentTick() const { return m_currentTick; };
+    inline double GetCurrentTimeSeconds() const { return (double)m_currentTick * SECONDS_PER_TICK; };
+    inline SimulationTick GetDeadline(SimulationTick durationTicks) const { return m_currentTick + durationTicks; };
+    inline bool HasReached(SimulationTick deadlineTick) const { return (int32_t)(m_currentTick - deadlineTick) >= 0; };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const SimulationTick TICKS_PER_SECOND = 60;
+    static const float SECONDS_PER_TICK;
+    static const unsigned int MAX_TICKS_PER_ADVANCE = 4;
+
+private:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    SimulationTick m_currentTick;
+    float m_accumulatedSeconds;
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <stdint.h>
+#include <type_traits>
+#include "Game/SimulationClock.hpp"
+
+//-----------------------------------------------------------------------------------
+//Plain copy of one Link's gameplay state. No pointers, so a whole SimulationState can be saved and restored with a copy.
+struct LinkState
+{
+    float m_positionX;
+    float m_positionY;
+    float m_hp;
+    float m_age;
+    SimulationTick m_attackStunEndTick;
+    SimulationTick m_hurtFlashEndTick;
+    uint8_t m_facing;
+    uint8_t m_isAlive;
+};
+
+//-----------------------------------------------------------------------------------
+struct SimulationState
+{
+    static const unsigned int MAX_PLAYERS = 8;
+
+    SimulationTick m_tick;
+    uint32_t m_playerColors[MAX_PLAYERS];
+    uint8_t m_isInMatch[MAX_PLAYERS];
+    LinkState m_links[MAX_PLAYERS];
+};
+
+static_assert(std::is_trivially_copyable<SimulationState>::value, "SimulationState must stay memcpy-able for rollback.");
@@ -34,6 +34,10 @@ const char* GetStateString(GameState state)
         return "Startup";
     case MAIN_MENU:
         return  "Main Menu";
+    case CONNECTING:
+        return "Connecting";
+    case LOADING:
+        return "Loading";
     case PLAYING:
         return "Playing";
     case PAUSED:
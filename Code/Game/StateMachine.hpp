@@ -5,6 +5,8 @@ enum GameState
 {
     STARTUP = 0,
     MAIN_MENU,
+    CONNECTING, //Waiting on the session to come up, never blocking the frame.
+    LOADING, //Connected, waiting for the match to hand us our player.
     PLAYING,
     PAUSED,
     GAME_OVER,
@@ -11,6 +11,7 @@
 #include "Engine/Renderer/Framebuffer.hpp"
 #include "Engine/Renderer/2D/SpriteGameRenderer.hpp"
 #include "Engine/Renderer/2D/ResourceDatabase.hpp"
+#include "Engine/Renderer/2D/SpriteResource.hpp"
 #include "Engine/Input/XInputController.hpp"
 #include "Engine/TextRendering/TextBox.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
@@ -24,10 +25,20 @@
 #include "Engine/Input/InputDevices.hpp"
 #include "Engine/Net/NetSystem.hpp"
 #include "Engine/Time/Time.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Game/HostSimulation.hpp"
+#include "Game/MatchManager.hpp"
 #include "Game/ClientSimulation.hpp"
+#include "Game/RollbackSession.hpp"
+#include "Game/MessageFragmenter.hpp"
+#include "Game/Physics/CollisionKernels.hpp"
+#include "Game/Rendering/AtlasManifest.hpp"
+#include "Game/Rendering/OneShotParticlePool.hpp"
+#include <chrono>
 
 TheGame* TheGame::instance = nullptr;
+const float TheGame::CONNECT_TIMEOUT_SECONDS = 10.0f;
+const float TheGame::LOADING_TIMEOUT_SECONDS = 10.0f;
 
 Sprite* testBackground = nullptr;
 Sprite* titleText = nullptr;
@@ -39,9 +50,10 @@ const float TIME_PER_SPAWN = 1.0f;
 void OnClientToHostUpdateReceiveHelper(const NetSender& from, NetMessage& message)
 {
 #pragma todo("Remove this helper and use events for the messages")
-    if (TheGame::instance->m_host)
+    HostSimulation* host = TheGame::instance->FindHost(from);
+    if (host)
     {
-        TheGame::instance->m_host->OnUpdateFromClientReceived(from, message);
+        host->OnUpdateFromClientReceived(from, message);
     }
 }
 
@@ -57,9 +69,10 @@ void OnHostToClientUpdateReceiveHelper(const NetSender& from, NetMessage& messag
 //-----------------------------------------------------------------------------------
 void OnPlayerCreate(const NetSender& from, NetMessage& message)
 {
-    if (TheGame::instance->m_host)
+    HostSimulation* host = TheGame::instance->FindHost(from);
+    if (host)
     {
-        TheGame::instance->m_host->OnPlayerCreate(from, message);
+        host->OnPlayerCreate(from, message);
     }
     if (TheGame::instance->m_client)
     {
@@ -68,24 +81,21 @@ void OnPlayerCreate(const NetSender& from, NetMessage& message)
 }
 
 //-----------------------------------------------------------------------------------
-void OnPlayerDestroy(const NetSender& from, NetMessage& message)
+void OnEntityDespawnBatch(const NetSender& from, NetMessage& message)
 {
-    if (TheGame::instance->m_host)
-    {
-        TheGame::instance->m_host->OnPlayerDestroy(from, message);
-    }
     if (TheGame::instance->m_client)
     {
-        TheGame::instance->m_client->OnPlayerDestroy(from, message);
+        TheGame::instance->m_client->OnEntityDespawnBatch(from, message);
     }
 }
 
 //-----------------------------------------------------------------------------------
 void OnPlayerAttack(const NetSender& from, NetMessage& message)
 {
-    if (TheGame::instance->m_host)
+    HostSimulation* host = TheGame::instance->FindHost(from);
+    if (host)
     {
-        TheGame::instance->m_host->OnPlayerAttack(from, message);
+        host->OnPlayerAttack(from, message);
     }
     if (TheGame::instance->m_client)
     {
@@ -96,9 +106,10 @@ void OnPlayerAttack(const NetSender& from, NetMessage& message)
 //-----------------------------------------------------------------------------------
 void OnPlayerFireBow(const NetSender& from, NetMessage& message)
 {
-    if (TheGame::instance->m_host)
+    HostSimulation* host = TheGame::instance->FindHost(from);
+    if (host)
     {
-        TheGame::instance->m_host->OnPlayerFireBow(from, message);
+        host->OnPlayerFireBow(from, message);
     }
     if (TheGame::instance->m_client)
     {
@@ -116,29 +127,64 @@ void OnPlayerDamaged(const NetSender& from, NetMessage& message)
 }
 
 //-----------------------------------------------------------------------------------
-TheGame::TheGame()
+void OnRollbackInput(const NetSender& from, NetMessage& message)
+{
+    if (TheGame::instance->m_rollback)
+    {
+        TheGame::instance->m_rollback->OnRollbackInput(from, message);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void OnRollbackState(const NetSender& from, MessageBuffer& message)
+{
+    if (TheGame::instance->m_rollback && !NetSession::instance->IsHost())
+    {
+        TheGame::instance->m_rollback->OnRollbackState(from, message);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void OnMessageFragment(const NetSender& from, NetMessage& message)
+{
+    MessageFragmenter::instance->OnMessageFragment(from, message);
+}
+
+//-----------------------------------------------------------------------------------
+TheGame::TheGame(bool isHeadless)
     : m_debuggingControllerIndex(0)
     , m_host(nullptr)
     , m_client(nullptr)
+    , m_rollback(nullptr)
+    , m_matches(nullptr)
     , m_playerDeathEffect(nullptr)
+    , m_bloodParticles(nullptr)
+    , m_bodyParticles(nullptr)
+    , m_weaponParticles(nullptr)
+    , m_pendingSession(AUTHORITATIVE_HOST)
+    , m_secondsInState(0.0f)
+    , m_isHeadless(isHeadless)
 {
     //Get a random timestamp seed.
-    LARGE_INTEGER currentCount;
-    QueryPerformanceCounter(&currentCount);
-    srand((unsigned int)currentCount.QuadPart);
-
-    m_playerDeathEffect = new Material(
-            new ShaderProgram("Data\\Shaders\\fixedVertexFormat.vert", "Data\\Shaders\\Post\\deathEffect.frag"),
-            RenderState(RenderState::DepthTestingMode::OFF, RenderState::FaceCullingMode::RENDER_BACK_FACES, RenderState::BlendMode::ALPHA_BLEND)
-        );
+    srand((unsigned int)std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    CollisionKernels::Initialize();
 
-    //Initialize resources and keybindings.
+    //Sprites are still registered headless, the host's hitboxes come from their bounds.
     ResourceDatabase::instance = new ResourceDatabase();
     RegisterSprites();
-    RegisterParticleSystems();
-    InitializeKeyMappings();
-    SetGameState(GameState::MAIN_MENU);
-    InitializeMainMenuState();
+    Link::ResolveSpriteResources();
+    if (!m_isHeadless)
+    {
+        m_playerDeathEffect = new Material(
+                new ShaderProgram("Data\\Shaders\\fixedVertexFormat.vert", "Data\\Shaders\\Post\\deathEffect.frag"),
+                RenderState(RenderState::DepthTestingMode::OFF, RenderState::FaceCullingMode::RENDER_BACK_FACES, RenderState::BlendMode::ALPHA_BLEND)
+            );
+        RegisterParticleSystems();
+        CreateParticlePools();
+        InitializeKeyMappings();
+        SetGameState(GameState::MAIN_MENU);
+        InitializeMainMenuState();
+    }
 
     //Initialize networking subsystems.
     RemoteCommandService::instance = new RemoteCommandService();
@@ -146,10 +192,14 @@ TheGame::TheGame()
     NetSession::instance->RegisterMessage((uint8_t)CLIENT_TO_HOST_UPDATE, "Client to Host Update", &OnClientToHostUpdateReceiveHelper, (uint32_t)NetMessage::Option::NONE, (uint32_t)NetMessage::Control::NONE);
     NetSession::instance->RegisterMessage((uint8_t)HOST_TO_CLIENT_UPDATE, "Host to Client Update", &OnHostToClientUpdateReceiveHelper, (uint32_t)NetMessage::Option::NONE, (uint32_t)NetMessage::Control::NONE);
     NetSession::instance->RegisterMessage((uint8_t)PLAYER_CREATE, "Player Create", &OnPlayerCreate, (uint32_t)NetMessage::Option::RELIABLE | (uint32_t)NetMessage::Option::INORDER, (uint32_t)NetMessage::Control::NONE);
-    NetSession::instance->RegisterMessage((uint8_t)PLAYER_DESTROY, "Player Destroy", &OnPlayerDestroy, (uint32_t)NetMessage::Option::RELIABLE | (uint32_t)NetMessage::Option::INORDER, (uint32_t)NetMessage::Control::NONE);
+    NetSession::instance->RegisterMessage((uint8_t)ENTITY_DESPAWN_BATCH, "Entity Despawn Batch", &OnEntityDespawnBatch, (uint32_t)NetMessage::Option::RELIABLE | (uint32_t)NetMessage::Option::INORDER, (uint32_t)NetMessage::Control::NONE);
     NetSession::instance->RegisterMessage((uint8_t)PLAYER_ATTACK, "Player Attack", &OnPlayerAttack, (uint32_t)NetMessage::Option::RELIABLE, (uint32_t)NetMessage::Control::NONE);
     NetSession::instance->RegisterMessage((uint8_t)PLAYER_FIRE_BOW, "Player Fire Bow", &OnPlayerFireBow, (uint32_t)NetMessage::Option::RELIABLE, (uint32_t)NetMessage::Control::NONE);
     NetSession::instance->RegisterMessage((uint8_t)PLAYER_DAMAGED, "Player Damaged", &OnPlayerDamaged, (uint32_t)NetMessage::Option::RELIABLE, (uint32_t)NetMessage::Control::NONE);
+    NetSession::instance->RegisterMessage((uint8_t)ROLLBACK_INPUT, "Rollback Input", &OnRollbackInput, (uint32_t)NetMessage::Option::NONE, (uint32_t)NetMessage::Control::NONE);
+    NetSession::instance->RegisterMessage((uint8_t)MESSAGE_FRAGMENT, "Message Fragment", &OnMessageFragment, (uint32_t)NetMessage::Option::RELIABLE, (uint32_t)NetMessage::Control::NONE);
+    MessageFragmenter::instance = new MessageFragmenter();
+    MessageFragmenter::instance->RegisterMessage((uint8_t)ROLLBACK_STATE, &OnRollbackState);
     NetSession::instance->m_OnConnectionJoin.RegisterMethod(this, &TheGame::OnConnectionJoined);
     NetSession::instance->m_OnConnectionLeave.RegisterMethod(this, &TheGame::OnConnectionLeave);
     NetSession::instance->m_OnNetTick.RegisterMethod(this, &TheGame::OnNetTick);
@@ -161,10 +211,16 @@ TheGame::~TheGame()
 {
     SetGameState(GameState::SHUTDOWN);
 
+    delete m_bloodParticles;
+    delete m_bodyParticles;
+    delete m_weaponParticles;
     delete ResourceDatabase::instance;
     ResourceDatabase::instance = nullptr;
-    delete m_playerDeathEffect->m_shaderProgram;
-    delete m_playerDeathEffect;
+    if (m_playerDeathEffect)
+    {
+        delete m_playerDeathEffect->m_shaderProgram;
+        delete m_playerDeathEffect;
+    }
 
     if (m_host)
     {
@@ -174,8 +230,14 @@ TheGame::~TheGame()
     {
         delete m_client;
     }
+    if (m_rollback)
+    {
+        delete m_rollback;
+    }
 
     //Cleanup networking subsystems
+    delete MessageFragmenter::instance;
+    MessageFragmenter::instance = nullptr;
     delete RemoteCommandService::instance;
     RemoteCommandService::instance = nullptr;
 }
@@ -183,27 +245,48 @@ TheGame::~TheGame()
 //-----------------------------------------------------------------------------------
 void TheGame::OnConnectionJoined(NetConnection* cp)
 {
+    //A dedicated server's own connection is just the session's, it never plays.
+    if (m_matches && cp->m_index != NetSession::instance->GetMyConnectionIndex() && !m_matches->AssignConnection(cp))
+    {
+        Console::instance->PrintLine(Stringf("Every match is full, connection %i wasn't placed in one", (int)cp->m_index), RGBA::RED);
+    }
     if (m_host)
     {
+        m_host->AddConnection(cp->m_index);
         m_host->OnConnectionJoined(cp);
     }
+    if (m_rollback && NetSession::instance->IsHost())
+    {
+        m_rollback->AddPlayer(cp->m_index, RGBA::GetRandom().ToUnsignedInt());
+    }
 }
 
 //-----------------------------------------------------------------------------------
 void TheGame::OnConnectionLeave(NetConnection* cp)
 {
+    MessageFragmenter::instance->OnConnectionLeave(cp);
+    if (m_matches)
+    {
+        m_matches->RemoveConnection(cp);
+    }
     if (m_host)
     {
         m_host->OnConnectionLeave(cp);
+        m_host->RemoveConnection(cp->m_index);
+    }
+    if (m_rollback && NetSession::instance->IsHost())
+    {
+        m_rollback->RemovePlayer(cp->m_index);
     }
 }
 
 //-----------------------------------------------------------------------------------
 void TheGame::OnNetTick(NetConnection* cp)
 {
-    if (m_host)
+    HostSimulation* host = m_matches ? m_matches->FindMatch(cp->m_index) : m_host;
+    if (host)
     {
-        m_host->SendNetHostUpdate(cp);
+        host->SendNetHostUpdate(cp);
     }
     if (m_client)
     {
@@ -211,10 +294,52 @@ void TheGame::OnNetTick(NetConnection* cp)
     }
 }
 
+//-----------------------------------------------------------------------------------
+void TheGame::OnInputEvent(double timeSeconds)
+{
+    if (m_client)
+    {
+        m_client->OnInputEvent(timeSeconds);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Called between the input system's update and the net session's, so movement changes make it out the same frame.
+void TheGame::SubmitInput()
+{
+    if (m_client)
+    {
+        m_client->SubmitInput(GetCurrentTimeSeconds());
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//On a dedicated server every connection has its own match, otherwise there's at most the one host.
+HostSimulation* TheGame::FindHost(const NetSender& from) const
+{
+    if (!m_matches)
+    {
+        return m_host;
+    }
+    return from.connection ? m_matches->FindMatch(from.connection->m_index) : nullptr;
+}
+
 //-----------------------------------------------------------------------------------
 void TheGame::Update(float deltaSeconds)
 {
+    if (m_isHeadless)
+    {
+        RemoteCommandService::instance->Update();
+        if (GetGameState() == PLAYING)
+        {
+            UpdatePlaying(deltaSeconds);
+        }
+        return;
+    }
     SpriteGameRenderer::instance->Update(deltaSeconds);
+    m_bloodParticles->Update(deltaSeconds);
+    m_bodyParticles->Update(deltaSeconds);
+    m_weaponParticles->Update(deltaSeconds);
     RemoteCommandService::instance->Update();
     if (InputSystem::instance->WasKeyJustPressed(InputSystem::ExtraKeys::TILDE))
     {
@@ -230,6 +355,12 @@ void TheGame::Update(float deltaSeconds)
     case MAIN_MENU:
         UpdateMainMenu(deltaSeconds);
         break;
+    case CONNECTING:
+        UpdateConnecting(deltaSeconds);
+        break;
+    case LOADING:
+        UpdateLoading(deltaSeconds);
+        break;
     case PLAYING:
         UpdatePlaying(deltaSeconds);
         break;
@@ -253,6 +384,8 @@ void TheGame::Render() const
     switch (GetGameState())
     {
     case MAIN_MENU:
+    case CONNECTING:
+    case LOADING:
         RenderMainMenu();
         break;
     case STARTUP:
@@ -294,46 +427,163 @@ void TheGame::CleanupMainMenuState(unsigned int)
     delete titleText;
 }
 
+//-----------------------------------------------------------------------------------
+//Only built once a join is picked, since finding the local address is a socket lookup.
+static std::string GetLocalJoinCommand()
+{
+    std::string localHostAddress = NetSystem::SockAddrToString(NetSystem::GetLocalHostAddressUDP("4334"));
+    return Stringf("netjoin client%i %s", rand(), localHostAddress.c_str());
+}
+
 //-----------------------------------------------------------------------------------
 void TheGame::UpdateMainMenu(float deltaSeconds)
 {
     UNUSED(deltaSeconds);
 
     if (m_gameplayMapping.WasJustPressed("Host"))
+    {
+        BeginSession(AUTHORITATIVE_HOST, "nethost Host");
+    }
+    else if (m_gameplayMapping.WasJustPressed("HostRollback"))
+    {
+        BeginSession(ROLLBACK_HOST, "nethost Host");
+    }
+    else if (m_gameplayMapping.WasJustPressed("JoinRollback"))
+    {
+        BeginSession(ROLLBACK_JOIN, GetLocalJoinCommand());
+    }
+    else if (m_gameplayMapping.WasJustPressed("Join"))
+    {
+        BeginSession(AUTHORITATIVE_JOIN, GetLocalJoinCommand());
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void TheGame::RenderMainMenu() const
+{
+    SpriteGameRenderer::instance->SetClearColor(RGBA::CERULEAN);
+    SpriteGameRenderer::instance->Render();
+}
+
+//-----------------------------------------------------------------------------------
+//CONNECTING AND LOADING/////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------
+//Kicks off the session and returns straight away. The frame keeps running while we wait, and the session is checked
+//every frame, so startup takes as long as the round trips do. Authoritative simulations exist before the net command
+//runs, so they can't miss the first connection events.
+void TheGame::BeginSession(SessionType type, const std::string& netCommand)
+{
+    m_pendingSession = type;
+    if (type == AUTHORITATIVE_HOST)
     {
         m_host = new HostSimulation();
+    }
+    if (type == AUTHORITATIVE_HOST || type == AUTHORITATIVE_JOIN)
+    {
         m_client = new ClientSimulation();
-        Console::instance->RunCommand("nethost Host");
-        while (!NetSession::instance->AmIConnected())
-        {
-            Sleep(100);
-        }
+    }
+    SetGameState(CONNECTING);
+    m_secondsInState = 0.0f;
+    m_OnSessionConnected.RegisterMethod(this, &TheGame::OnSessionConnected);
+    Console::instance->RunCommand(netCommand);
+}
+
+//-----------------------------------------------------------------------------------
+void TheGame::UpdateConnecting(float deltaSeconds)
+{
+    m_secondsInState += deltaSeconds;
+    bool isConnected = NetSession::instance->AmIConnected();
+    if (isConnected || m_secondsInState >= CONNECT_TIMEOUT_SECONDS)
+    {
+        m_OnSessionConnected.Trigger(isConnected);
+        m_OnSessionConnected.UnregisterAllSubscriptions();
+    }
+}
 
-        //Force creation of the host's player and potentially local client player.
+//-----------------------------------------------------------------------------------
+void TheGame::OnSessionConnected(bool isConnected)
+{
+    if (!isConnected)
+    {
+        AbandonSession("Timed out connecting");
+        return;
+    }
+    if (m_pendingSession == AUTHORITATIVE_HOST)
+    {
+        //Request creation of the host's player, the host spawns it and broadcasts it back to our local client.
         NetMessage message(GameNetMessages::PLAYER_CREATE);
-        message.Write<bool>(false);
+        message.Write<bool>(true);
         message.Write<uint8_t>(NetSession::instance->m_hostConnection->m_index);
         message.Write<unsigned int>(RGBA::GetRandom().ToUnsignedInt());
         NetSession::instance->m_hostConnection->SendMessage(message);
-        
-        SetGameState(PLAYING);
-        InitializePlayingState();
     }
-    if (m_gameplayMapping.WasJustPressed("Join"))
+    else if (m_pendingSession == ROLLBACK_HOST)
     {
-        m_client = new ClientSimulation();
-        Console::instance->RunCommand(Stringf("netjoin client%i %s", rand(), NetSystem::SockAddrToString(NetSystem::GetLocalHostAddressUDP("4334"))));
-        
-        SetGameState(PLAYING);
-        InitializePlayingState();
+        //Everyone simulates the match themselves, the host just decides who's in it.
+        uint8_t hostIndex = NetSession::instance->m_hostConnection->m_index;
+        m_rollback = new RollbackSession(hostIndex);
+        m_rollback->AddPlayer(hostIndex, RGBA::GetRandom().ToUnsignedInt());
+    }
+    else if (m_pendingSession == ROLLBACK_JOIN)
+    {
+        m_rollback = new RollbackSession(NetSession::instance->GetMyConnectionIndex());
     }
+    SetGameState(LOADING);
+    m_secondsInState = 0.0f;
+    m_OnSessionLoaded.RegisterMethod(this, &TheGame::OnSessionLoaded);
 }
 
 //-----------------------------------------------------------------------------------
-void TheGame::RenderMainMenu() const
+//The simulations run as usual while loading, they just aren't shown until our own player exists.
+void TheGame::UpdateLoading(float deltaSeconds)
 {
-    SpriteGameRenderer::instance->SetClearColor(RGBA::CERULEAN);
-    SpriteGameRenderer::instance->Render();
+    UpdatePlaying(deltaSeconds);
+    m_secondsInState += deltaSeconds;
+    bool isLoaded = IsSessionLoaded();
+    if (isLoaded || m_secondsInState >= LOADING_TIMEOUT_SECONDS)
+    {
+        m_OnSessionLoaded.Trigger(isLoaded);
+        m_OnSessionLoaded.UnregisterAllSubscriptions();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void TheGame::OnSessionLoaded(bool isLoaded)
+{
+    if (!isLoaded)
+    {
+        AbandonSession("Timed out waiting for the match");
+        return;
+    }
+    SetGameState(PLAYING);
+    InitializePlayingState();
+}
+
+//-----------------------------------------------------------------------------------
+bool TheGame::IsSessionLoaded() const
+{
+    if (m_client)
+    {
+        return m_client->m_localPlayer != nullptr;
+    }
+    return m_rollback && m_rollback->IsLocalPlayerInMatch();
+}
+
+//-----------------------------------------------------------------------------------
+//The session itself is left as it is, the next attempt's nethost or netjoin takes over from it.
+void TheGame::AbandonSession(const char* reason)
+{
+    Console::instance->PrintLine(Stringf("%s, back to the menu", reason), RGBA::RED);
+    delete m_host;
+    m_host = nullptr;
+    delete m_client;
+    m_client = nullptr;
+    delete m_rollback;
+    m_rollback = nullptr;
+    SetGameState(MAIN_MENU);
+    InitializeMainMenuState();
 }
 
 //-----------------------------------------------------------------------------------
@@ -349,6 +599,24 @@ void TheGame::InitializePlayingState()
     OnStateLeave.RegisterMethod(this, &TheGame::CleanupPlayingState);
 }
 
+//-----------------------------------------------------------------------------------
+//Skips the menu and the local client: the server only hosts, and every player in a match joins over the network.
+void TheGame::StartDedicatedHost(const std::string& hostName, unsigned int numMatches, unsigned int playersPerMatch)
+{
+    ASSERT_OR_DIE(m_isHeadless, "Only a headless game can run as a dedicated host.");
+    m_matches = new MatchManager(numMatches, playersPerMatch);
+    Console::instance->RunCommand(Stringf("nethost %s", hostName.c_str()));
+    SetGameState(PLAYING);
+    OnStateLeave.RegisterMethod(this, &TheGame::CleanupDedicatedHostState);
+}
+
+//-----------------------------------------------------------------------------------
+void TheGame::CleanupDedicatedHostState(unsigned int)
+{
+    delete m_matches;
+    m_matches = nullptr;
+}
+
 //-----------------------------------------------------------------------------------
 void TheGame::CleanupPlayingState(unsigned int)
 {
@@ -359,7 +627,11 @@ void TheGame::CleanupPlayingState(unsigned int)
 //-----------------------------------------------------------------------------------
 void TheGame::UpdatePlaying(float deltaSeconds)
 {
-    if (NetSession::instance->IsHost())
+    if (m_matches)
+    {
+        m_matches->Update(deltaSeconds);
+    }
+    if (m_host)
     {
         m_host->Update(deltaSeconds);
     }
@@ -367,6 +639,10 @@ void TheGame::UpdatePlaying(float deltaSeconds)
     {
         m_client->Update(deltaSeconds);
     }
+    if (m_rollback)
+    {
+        m_rollback->Update(deltaSeconds);
+    }
 }
 
 //-----------------------------------------------------------------------------------
@@ -419,35 +695,67 @@ void TheGame::InitializeKeyMappings()
     m_gameplayMapping.AddInputValue("Respawn", keyboard->FindValue('R'));
     m_gameplayMapping.AddInputValue("Host", keyboard->FindValue('H'));
     m_gameplayMapping.AddInputValue("Join", keyboard->FindValue('J'));
+    m_gameplayMapping.AddInputValue("HostRollback", keyboard->FindValue('G'));
+    m_gameplayMapping.AddInputValue("JoinRollback", keyboard->FindValue('K'));
     m_gameplayMapping.AddInputValue("Twah", keyboard->FindValue('T'));
 }
 
 //-----------------------------------------------------------------------------------
 void TheGame::RegisterSprites()
 {
-    ResourceDatabase::instance->RegisterSprite("Map", "Data\\Images\\SymmetryCityMap.png");
-    ResourceDatabase::instance->RegisterSprite("pDown", "Data\\Images\\standingDown.png");
-    ResourceDatabase::instance->RegisterSprite("pUp", "Data\\Images\\standingUp.png");
-    ResourceDatabase::instance->RegisterSprite("pRight", "Data\\Images\\standingRight.png");
-    ResourceDatabase::instance->RegisterSprite("pLeft", "Data\\Images\\standingLeft.png");
-    ResourceDatabase::instance->RegisterSprite("dead1", "Data\\Images\\dead1.png");
-    ResourceDatabase::instance->RegisterSprite("dead2", "Data\\Images\\dead2.png");
-    ResourceDatabase::instance->RegisterSprite("bloodPool", "Data\\Images\\bloodPool.png");
-    ResourceDatabase::instance->RegisterSprite("swordSwing", "Data\\Images\\swordSwing.png");
-    ResourceDatabase::instance->RegisterSprite("Arrow", "Data\\Images\\arrow.png");
-
-    ResourceDatabase::instance->RegisterSprite("fullHeart", "Data\\Images\\fullHeart.png");
-    ResourceDatabase::instance->RegisterSprite("halfHeart", "Data\\Images\\halfHeart.png");
-    ResourceDatabase::instance->RegisterSprite("emptyHeart", "Data\\Images\\emptyHeart.png");
+    //Baked by Tools/Main_AtlasBaker.cpp. Without a manifest, or for anything it missed, sprites load from their own files.
+    AtlasManifest atlas;
+    atlas.LoadFromFile("Data\\Images\\Atlas\\atlas.manifest");
+
+    RegisterSprite(atlas, "Map", "Data\\Images\\SymmetryCityMap.png");
+    RegisterSprite(atlas, "pDown", "Data\\Images\\standingDown.png");
+    RegisterSprite(atlas, "pUp", "Data\\Images\\standingUp.png");
+    RegisterSprite(atlas, "pRight", "Data\\Images\\standingRight.png");
+    RegisterSprite(atlas, "pLeft", "Data\\Images\\standingLeft.png");
+    RegisterSprite(atlas, "dead1", "Data\\Images\\dead1.png");
+    RegisterSprite(atlas, "dead2", "Data\\Images\\dead2.png");
+    RegisterSprite(atlas, "bloodPool", "Data\\Images\\bloodPool.png");
+    RegisterSprite(atlas, "swordSwing", "Data\\Images\\swordSwing.png");
+    RegisterSprite(atlas, "Arrow", "Data\\Images\\arrow.png");
+
+    RegisterSprite(atlas, "fullHeart", "Data\\Images\\fullHeart.png");
+    RegisterSprite(atlas, "halfHeart", "Data\\Images\\halfHeart.png");
+    RegisterSprite(atlas, "emptyHeart", "Data\\Images\\emptyHeart.png");
+
+    RegisterSprite(atlas, "TitleText", "Data\\Images\\Title.png");
+    RegisterSprite(atlas, "GameOverText", "Data\\Images\\GameOver.png");
+}
 
-    ResourceDatabase::instance->RegisterSprite("TitleText", "Data\\Images\\Title.png");
-    ResourceDatabase::instance->RegisterSprite("GameOverText", "Data\\Images\\GameOver.png");
+//-----------------------------------------------------------------------------------
+//Atlased sprites all share their page's texture, so the renderer stops rebinding between them. The resource is
+//registered against the whole page, then narrowed down to its region.
+void TheGame::RegisterSprite(const AtlasManifest& atlas, const std::string& name, const std::string& imagePath)
+{
+    const AtlasRegion* region = atlas.FindRegion(imagePath);
+    if (!region)
+    {
+        ResourceDatabase::instance->RegisterSprite(name, imagePath);
+        m_spriteResources.Register(name.c_str(), ResourceDatabase::instance->GetSpriteResource(name));
+        return;
+    }
+    const AtlasPage& page = atlas.GetPage(region->m_page);
+    ResourceDatabase::instance->RegisterSprite(name, page.m_imagePath);
+    SpriteResource* resource = ResourceDatabase::instance->EditSpriteResource(name);
+    Vector2 pageSize((float)page.m_width, (float)page.m_height);
+    Vector2 regionScale((float)region->m_width / pageSize.x, (float)region->m_height / pageSize.y);
+    resource->m_uvBounds[0] = Vector2((float)region->m_x / pageSize.x, (float)region->m_y / pageSize.y);
+    resource->m_uvBounds[1] = Vector2((float)(region->m_x + region->m_width) / pageSize.x, (float)(region->m_y + region->m_height) / pageSize.y);
+    resource->m_pixelSize = Vector2Int(region->m_width, region->m_height);
+    resource->m_virtualSize = Vector2(resource->m_virtualSize.x * regionScale.x, resource->m_virtualSize.y * regionScale.y);
+    resource->m_pivotPoint = Vector2(resource->m_pivotPoint.x * regionScale.x, resource->m_pivotPoint.y * regionScale.y);
+    m_spriteResources.Register(name.c_str(), resource);
 }
 
 //-----------------------------------------------------------------------------------
 void TheGame::RegisterParticleSystems()
 {
     ParticleSystemDefinition* swordAttackSystem = ResourceDatabase::instance->RegisterParticleSystem("SwordAttack", ONE_SHOT);
+    m_particleSystems.Register("SwordAttack", swordAttackSystem);
     ParticleEmitterDefinition* swordAttackEmitter = new ParticleEmitterDefinition(ResourceDatabase::instance->GetSpriteResource("swordSwing"));
     swordAttackEmitter->m_initialNumParticlesSpawn = 1;
     swordAttackEmitter->m_lifetimePerParticle = 0.1f;
@@ -457,6 +765,7 @@ void TheGame::RegisterParticleSystems()
     swordAttackSystem->AddEmitter(swordAttackEmitter);
 
     ParticleSystemDefinition* deadLinkSystem = ResourceDatabase::instance->RegisterParticleSystem("DeadLink1", ONE_SHOT);
+    m_particleSystems.Register("DeadLink1", deadLinkSystem);
     ParticleEmitterDefinition* deadLinkEmitter = new ParticleEmitterDefinition(ResourceDatabase::instance->GetSpriteResource("dead1"));
     deadLinkEmitter->m_initialNumParticlesSpawn = 1;
     deadLinkEmitter->m_lifetimePerParticle = 10.0f;
@@ -466,6 +775,7 @@ void TheGame::RegisterParticleSystems()
     deadLinkSystem->AddEmitter(deadLinkEmitter);
 
     ParticleSystemDefinition* deadLinkSystem2 = ResourceDatabase::instance->RegisterParticleSystem("DeadLink2", ONE_SHOT);
+    m_particleSystems.Register("DeadLink2", deadLinkSystem2);
     ParticleEmitterDefinition* deadLinkEmitter2 = new ParticleEmitterDefinition(ResourceDatabase::instance->GetSpriteResource("dead2"));
     deadLinkEmitter2->m_initialNumParticlesSpawn = 1;
     deadLinkEmitter2->m_lifetimePerParticle = 10.0f;
@@ -475,6 +785,7 @@ void TheGame::RegisterParticleSystems()
     deadLinkSystem2->AddEmitter(deadLinkEmitter2);
 
     ParticleSystemDefinition* bloodPoolSystem = ResourceDatabase::instance->RegisterParticleSystem("BloodPool", ONE_SHOT);
+    m_particleSystems.Register("BloodPool", bloodPoolSystem);
     ParticleEmitterDefinition* bloodPoolEmitter = new ParticleEmitterDefinition(ResourceDatabase::instance->GetSpriteResource("bloodPool"));
     bloodPoolEmitter->m_initialNumParticlesSpawn = 1;
     bloodPoolEmitter->m_lifetimePerParticle = 60.0f;
@@ -485,17 +796,28 @@ void TheGame::RegisterParticleSystems()
 
 }
 
+//-----------------------------------------------------------------------------------
+//Sized for a full lobby dying and swinging at once. Blood pools stay up for a minute, so that pool gets the most room.
+void TheGame::CreateParticlePools()
+{
+    m_bloodParticles = new OneShotParticlePool(BLOOD_LAYER, MAX_PLAYERS * 8, "bloodPool");
+    m_bodyParticles = new OneShotParticlePool(BODY_LAYER, MAX_PLAYERS * 4, "dead1");
+    m_weaponParticles = new OneShotParticlePool(WEAPON_LAYER, MAX_PLAYERS * 2, "swordSwing");
+}
+
 //-----------------------------------------------------------------------------------
 CONSOLE_COMMAND(joingame)
 {
     if (!args.HasArgs(1))
     {
         Console::instance->PrintLine("joingame <ip>", RGBA::RED);
+        return;
+    }
+    if (GetGameState() != MAIN_MENU)
+    {
+        Console::instance->PrintLine("joingame only works from the main menu", RGBA::RED);
+        return;
     }
     std::string ipAddress = args.GetStringArgument(0);
-    TheGame::instance->m_client = new ClientSimulation();
-    Console::instance->RunCommand(Stringf("netjoin client%i %s", rand(), ipAddress.c_str()));
-    
-    SetGameState(PLAYING);
-    TheGame::instance->InitializePlayingState();
+    TheGame::instance->BeginSession(TheGame::AUTHORITATIVE_JOIN, Stringf("netjoin client%i %s", rand(), ipAddress.c_str()));
 }
\ No newline at end of file
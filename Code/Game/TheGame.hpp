@@ -4,6 +4,8 @@
 #include "Engine/Net/UDPIP/NetMessage.hpp"
 #include "Engine/Input/InputMap.hpp"
 #include "Engine/Renderer/Material.hpp"
+#include "Engine/Core/Event.hpp"
+#include "Game/NameTable.hpp"
 
 class Entity;
 class Link;
@@ -12,6 +14,12 @@ class NetConnection;
 struct NetSender;
 class HostSimulation;
 class ClientSimulation;
+class RollbackSession;
+class MatchManager;
+class AtlasManifest;
+class SpriteResource;
+class ParticleSystemDefinition;
+class OneShotParticlePool;
 
 //-----------------------------------------------------------------------------------
 enum GameNetMessages
@@ -19,29 +27,64 @@ enum GameNetMessages
     CLIENT_TO_HOST_UPDATE = NetMessage::CoreMessageTypes::NUM_MESSAGES,
     HOST_TO_CLIENT_UPDATE,
     PLAYER_CREATE,
-    PLAYER_DESTROY,
+    ENTITY_DESPAWN_BATCH,
     PLAYER_ATTACK,
     PLAYER_FIRE_BOW,
     PLAYER_DAMAGED,
+    ROLLBACK_INPUT,
+    ROLLBACK_STATE,
+    MESSAGE_FRAGMENT,
+};
+
+//-----------------------------------------------------------------------------------
+//First byte of every HOST_TO_CLIENT_UPDATE. Damage updates always go plain; ticks are coded unless "snapcoding 0".
+enum SnapshotFormat
+{
+    PLAIN_SNAPSHOT,
+    CODED_SNAPSHOT
+};
+
+//-----------------------------------------------------------------------------------
+//Share a CLIENT_TO_HOST_UPDATE's button byte with PlayerInput::MOVEMENT_BUTTONS, each saying what follows it.
+enum ClientUpdateFlags
+{
+    ANALOG_INPUT_FLAG = 1 << 6, //Two signed bytes of axis deflection.
+    SNAPSHOT_ACK_FLAG = 1 << 7 //The newest complete snapshot's sequence.
 };
 
 //-----------------------------------------------------------------------------------
 class TheGame
 {
 public:
-    TheGame();
+    enum SessionType
+    {
+        AUTHORITATIVE_HOST,
+        AUTHORITATIVE_JOIN,
+        ROLLBACK_HOST,
+        ROLLBACK_JOIN
+    };
+
+    explicit TheGame(bool isHeadless = false);
     ~TheGame();
     void OnConnectionJoined(NetConnection* cp);
     void OnConnectionLeave(NetConnection* cp);
     void OnNetTick(NetConnection* cp);
+    void OnInputEvent(double timeSeconds);
+    void SubmitInput();
     void Update(float deltaTime);
     void Render() const;
     void InitializePlayingState();
+    void BeginSession(SessionType type, const std::string& netCommand);
+    void StartDedicatedHost(const std::string& hostName, unsigned int numMatches, unsigned int playersPerMatch);
+    HostSimulation* FindHost(const NetSender& from) const;
+    inline bool IsHeadless() const { return m_isHeadless; };
 
     static TheGame* instance;
 
     //CONSTANTS/////////////////////////////////////////////////////////////////////
     static const uint8_t MAX_PLAYERS = 8;
+    static const float CONNECT_TIMEOUT_SECONDS;
+    static const float LOADING_TIMEOUT_SECONDS;
 
     static unsigned int const BACKGROUND_LAYER = 0;
     static unsigned int const BLOOD_LAYER = 8;
@@ -57,23 +100,46 @@ public:
     InputMap m_gameplayMapping;
     HostSimulation* m_host;
     ClientSimulation* m_client;
+    RollbackSession* m_rollback;
+    MatchManager* m_matches; //Only on a dedicated server, in place of m_host.
     Material* m_playerDeathEffect;
+    NameTable<const SpriteResource> m_spriteResources; //Filled at load, so call sites can resolve their handles once.
+    NameTable<ParticleSystemDefinition> m_particleSystems;
+    OneShotParticlePool* m_bloodParticles; //One pool per layer the one-shot effects draw on.
+    OneShotParticlePool* m_bodyParticles;
+    OneShotParticlePool* m_weaponParticles;
+    Event<bool> m_OnSessionConnected; //ONE SHOT, like OnStateLeave. Fired with false if the attempt timed out.
+    Event<bool> m_OnSessionLoaded;
 
 private:
+    SessionType m_pendingSession;
+    float m_secondsInState; //Only kept while connecting and loading, for the timeouts.
+    bool m_isHeadless; //Dedicated servers run the host without a renderer, input or audio, so none of that gets set up.
+
     TheGame& operator= (const TheGame& other) = delete;
     void CleanupGameOverState(unsigned int);
     void UpdateGameOver(float deltaSeconds);
     void RenderGameOver() const;
     void RegisterSprites();
+    void RegisterSprite(const AtlasManifest& atlas, const std::string& name, const std::string& imagePath);
     void RegisterParticleSystems();
+    void CreateParticlePools();
     void UpdatePlaying(float deltaSeconds);
     void RenderPlaying() const;
     void InitializeGameOverState();
     void CleanupPlayingState(unsigned int);
+    void CleanupDedicatedHostState(unsigned int);
 
     void InitializeMainMenuState();
     void InitializeKeyMappings();
     void CleanupMainMenuState(unsigned int);
     void UpdateMainMenu(float deltaSeconds);
     void RenderMainMenu() const;
+
+    void UpdateConnecting(float deltaSeconds);
+    void UpdateLoading(float deltaSeconds);
+    void OnSessionConnected(bool isConnected);
+    void OnSessionLoaded(bool isLoaded);
+    bool IsSessionLoaded() const;
+    void AbandonSession(const char* reason);
 };
@@ -0,0 +1,120 @@
+//-----------------------------------------------------------------------------------
+//Offline atlas baker: packs the sprite images into a few shared pages and writes the manifest TheGame::RegisterSprites
+//looks for. Engine-free on purpose, so it builds with any compiler and runs on a build machine. From Run_Win32:
+//
+//  g++ -std=c++14 -O2 -I../Code ../Code/Game/Tools/Main_AtlasBaker.cpp ../Code/Game/Rendering/Image.cpp
+//      ../Code/Game/Rendering/AtlasPacker.cpp ../Code/Game/Rendering/AtlasManifest.cpp -o AtlasBaker
+//  ./AtlasBaker Data/Images/Atlas Data/Images/*.png
+//
+//Images that don't decode (Twah.png is really a TIFF) are skipped with a warning and keep loading on their own.
+#define _CRT_SECURE_NO_WARNINGS
+#include "Game/Rendering/Image.hpp"
+#include "Game/Rendering/AtlasPacker.hpp"
+#include "Game/Rendering/AtlasManifest.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const int DEFAULT_PAGE_SIZE = 1024;
+static const int DEFAULT_PADDING = 2;
+
+//-----------------------------------------------------------------------------------
+static void PrintUsage()
+{
+    printf("AtlasBaker [-size <pagePixels>] [-padding <pixels>] <outputDirectory> <image.png>...\n");
+}
+
+//-----------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    int pageSize = DEFAULT_PAGE_SIZE;
+    int padding = DEFAULT_PADDING;
+    int argIndex = 1;
+    for (; argIndex + 1 < argc && argv[argIndex][0] == '-'; argIndex += 2)
+    {
+        if (strcmp(argv[argIndex], "-size") == 0)
+        {
+            pageSize = atoi(argv[argIndex + 1]);
+        }
+        else if (strcmp(argv[argIndex], "-padding") == 0)
+        {
+            padding = atoi(argv[argIndex + 1]);
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (argc - argIndex < 2 || pageSize <= 0 || padding < 0)
+    {
+        PrintUsage();
+        return 1;
+    }
+    std::string outputDirectory(argv[argIndex++]);
+    while (!outputDirectory.empty() && (outputDirectory.back() == '/' || outputDirectory.back() == '\\'))
+    {
+        outputDirectory.pop_back();
+    }
+
+    std::vector<std::string> sourcePaths;
+    std::vector<Image> images;
+    std::vector<AtlasPlacement> sizes;
+    for (; argIndex < argc; ++argIndex)
+    {
+        Image image;
+        std::string error;
+        if (!image.LoadPNG(argv[argIndex], error))
+        {
+            printf("Skipping %s: %s\n", argv[argIndex], error.c_str());
+            continue;
+        }
+        AtlasPlacement size = {};
+        size.m_width = image.m_width;
+        size.m_height = image.m_height;
+        sizes.push_back(size);
+        sourcePaths.push_back(argv[argIndex]);
+        images.push_back(image);
+    }
+
+    AtlasPacker packer(pageSize, pageSize, padding);
+    std::vector<AtlasPlacement> placements;
+    if (!packer.Pack(sizes, placements))
+    {
+        printf("An image doesn't fit on a %ix%i page with %i pixels of padding\n", pageSize, pageSize, padding);
+        return 1;
+    }
+
+    //Copy each image in and smear its border into the padding.
+    std::vector<Image> pages(packer.GetNumPages(), Image(pageSize, pageSize));
+    AtlasManifest manifest;
+    for (unsigned int i = 0; i < images.size(); ++i)
+    {
+        const AtlasPlacement& placement = placements[i];
+        Image& page = pages[placement.m_page];
+        page.Blit(images[i], placement.m_x, placement.m_y);
+        page.ExtrudeEdges(placement.m_x, placement.m_y, placement.m_width, placement.m_height, padding);
+        AtlasRegion region = { placement.m_page, placement.m_x, placement.m_y, placement.m_width, placement.m_height };
+        manifest.AddRegion(sourcePaths[i], region);
+    }
+    for (unsigned int i = 0; i < pages.size(); ++i)
+    {
+        char pageName[32];
+        sprintf(pageName, "/atlas%u.png", i);
+        std::string pagePath = outputDirectory + pageName;
+        if (!pages[i].SavePNG(pagePath))
+        {
+            printf("Couldn't write %s\n", pagePath.c_str());
+            return 1;
+        }
+        manifest.AddPage(pagePath, pageSize, pageSize);
+    }
+    std::string manifestPath = outputDirectory + "/atlas.manifest";
+    if (!manifest.SaveToFile(manifestPath))
+    {
+        printf("Couldn't write %s\n", manifestPath.c_str());
+        return 1;
+    }
+    printf("Packed %u images onto %u pages (%.1f%% used), wrote %s\n", (unsigned int)images.size(), packer.GetNumPages(), packer.CalculateOccupancy(placements) * 100.0f, manifestPath.c_str());
+    return 0;
+}
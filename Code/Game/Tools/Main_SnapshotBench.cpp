@@ -0,0 +1,239 @@
+//-----------------------------------------------------------------------------------
+//Snapshot compression benchmark: runs a synthetic match, codes every snapshot against a lagging baseline the way the
+//host does against a client's ack, and reports sizes and encode/decode time. Engine-free. From Run_Win32:
+//
+//  g++ -std=c++14 -O2 -I../Code ../Code/Game/Tools/Main_SnapshotBench.cpp ../Code/Game/Net/SnapshotCodec.cpp
+//      ../Code/Game/Net/RangeCoder.cpp ../Code/Game/Net/SnapshotModelData.cpp -o SnapshotBench
+//  ./SnapshotBench -links 8 -snapshots 20000 -lag 4
+//
+//-record writes the synthetic match out for SnapshotTrainer, to bootstrap a model before there are real recordings.
+#include "Game/Net/SnapshotCodec.hpp"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+struct SnapshotBenchConfig
+{
+    unsigned int m_numLinks = 8;
+    unsigned int m_numSnapshots = 20000;
+    unsigned int m_baselineLag = 4; //Snapshots between the one sent and the newest the client has acked.
+    unsigned int m_ticksPerSnapshot = 3;
+    const char* m_recordingPath = nullptr;
+};
+
+//-----------------------------------------------------------------------------------
+//Links wander the level in bursts, stand around, take the odd hit and respawn as new links when they die. Tuned to
+//look like the game's own: 60Hz ticks, 1/20 units a tick walking, 10 hp.
+struct SyntheticLink
+{
+    uint16_t m_networkId;
+    float m_x;
+    float m_y;
+    float m_directionX;
+    float m_directionY;
+    uint8_t m_facing;
+    float m_hp;
+};
+
+//-----------------------------------------------------------------------------------
+static float RandomZeroToOne()
+{
+    return (float)rand() / (float)RAND_MAX;
+}
+
+//-----------------------------------------------------------------------------------
+static void StepLink(SyntheticLink& link, uint16_t& nextNetworkId)
+{
+    static const float SPEED = 1.0f / 20.0f;
+    if (RandomZeroToOne() < 0.02f)
+    {
+        //About half the time a change of mind means stopping.
+        int direction = rand() % 16;
+        bool isWalking = direction < 8;
+        float angle = (float)direction * 0.785398f;
+        link.m_directionX = isWalking ? cosf(angle) : 0.0f;
+        link.m_directionY = isWalking ? sinf(angle) : 0.0f;
+        if (isWalking)
+        {
+            bool isHorizontal = fabsf(link.m_directionX) >= fabsf(link.m_directionY);
+            link.m_facing = isHorizontal ? (link.m_directionX < 0.0f ? 0 : 2) : (link.m_directionY > 0.0f ? 1 : 3);
+        }
+    }
+    link.m_x += link.m_directionX * SPEED;
+    link.m_y += link.m_directionY * SPEED;
+    if (fabsf(link.m_x) > 15.0f || fabsf(link.m_y) > 8.0f)
+    {
+        link.m_x -= link.m_directionX * SPEED;
+        link.m_y -= link.m_directionY * SPEED;
+        link.m_directionX = link.m_directionY = 0.0f;
+    }
+    if (RandomZeroToOne() < 0.002f)
+    {
+        link.m_hp -= 1.0f;
+        if (link.m_hp <= 0.0f)
+        {
+            link.m_networkId = nextNetworkId++;
+            link.m_hp = 10.0f;
+            link.m_x = RandomZeroToOne() * 30.0f - 15.0f;
+            link.m_y = RandomZeroToOne() * 16.0f - 8.0f;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+static bool IsSameLink(const SnapshotLink& first, const SnapshotLink& second)
+{
+    const LinkRecord& a = first.m_record;
+    const LinkRecord& b = second.m_record;
+    return first.m_slot == second.m_slot && a.m_networkId == b.m_networkId && a.m_x == b.m_x && a.m_y == b.m_y && a.m_facing == b.m_facing && a.m_hp == b.m_hp;
+}
+
+//-----------------------------------------------------------------------------------
+static void PrintUsage()
+{
+    printf("SnapshotBench [-links n] [-snapshots n] [-lag <snapshots>] [-record file]\n");
+}
+
+//-----------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    SnapshotBenchConfig config;
+    for (int i = 1; i < argc; ++i)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-links") == 0 && hasValue)
+        {
+            config.m_numLinks = (unsigned int)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-snapshots") == 0 && hasValue)
+        {
+            config.m_numSnapshots = (unsigned int)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-lag") == 0 && hasValue)
+        {
+            config.m_baselineLag = (unsigned int)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-record") == 0 && hasValue)
+        {
+            config.m_recordingPath = argv[++i];
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (config.m_numLinks == 0 || config.m_numLinks > SnapshotFrame::MAX_SLOTS || config.m_numSnapshots == 0)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    FILE* recording = nullptr;
+    if (config.m_recordingPath)
+    {
+        recording = fopen(config.m_recordingPath, "wb");
+        if (!recording)
+        {
+            printf("Couldn't open %s\n", config.m_recordingPath);
+            return 1;
+        }
+    }
+
+    //Play the whole match out first, so the timing below is only the codec.
+    srand(1234);
+    uint16_t nextNetworkId = 1;
+    std::vector<SyntheticLink> links(config.m_numLinks);
+    for (SyntheticLink& link : links)
+    {
+        link = { nextNetworkId++, RandomZeroToOne() * 30.0f - 15.0f, RandomZeroToOne() * 16.0f - 8.0f, 0.0f, 0.0f, 3, 10.0f };
+    }
+    std::vector<SnapshotFrame> frames(config.m_numSnapshots);
+    for (unsigned int snapshot = 0; snapshot < config.m_numSnapshots; ++snapshot)
+    {
+        for (unsigned int tick = 0; tick < config.m_ticksPerSnapshot; ++tick)
+        {
+            for (SyntheticLink& link : links)
+            {
+                StepLink(link, nextNetworkId);
+            }
+        }
+        SnapshotFrame& frame = frames[snapshot];
+        frame.m_sequence = (uint16_t)snapshot;
+        for (unsigned int slot = 0; slot < config.m_numLinks; ++slot)
+        {
+            const SyntheticLink& link = links[slot];
+            frame.SetSlot(slot, SnapshotCodec::Quantize(link.m_networkId, link.m_x, link.m_y, link.m_facing, link.m_hp));
+        }
+    }
+
+    const SnapshotCodec& codec = SnapshotCodec::GetTrained();
+    std::vector<uint8_t> coded(config.m_numSnapshots * (config.m_numLinks * SnapshotCodec::MAX_CODED_LINK_BYTES + 8));
+    std::vector<unsigned int> codedSizes(config.m_numSnapshots);
+    std::vector<SnapshotLink> snapshotLinks(config.m_numSnapshots * config.m_numLinks);
+    for (unsigned int snapshot = 0; snapshot < config.m_numSnapshots; ++snapshot)
+    {
+        for (unsigned int slot = 0; slot < config.m_numLinks; ++slot)
+        {
+            snapshotLinks[snapshot * config.m_numLinks + slot] = { (uint8_t)slot, frames[snapshot].m_links[slot] };
+        }
+    }
+
+    unsigned int maxBytesPerSnapshot = config.m_numLinks * SnapshotCodec::MAX_CODED_LINK_BYTES + 8;
+    auto encodeStart = std::chrono::steady_clock::now();
+    for (unsigned int snapshot = 0; snapshot < config.m_numSnapshots; ++snapshot)
+    {
+        const SnapshotFrame& baseline = snapshot >= config.m_baselineLag ? frames[snapshot - config.m_baselineLag] : SnapshotFrame::EMPTY;
+        codec.Encode(baseline, &snapshotLinks[snapshot * config.m_numLinks], config.m_numLinks, &coded[snapshot * maxBytesPerSnapshot], maxBytesPerSnapshot, codedSizes[snapshot]);
+    }
+    double encodeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - encodeStart).count();
+
+    SnapshotLink decoded[SnapshotFrame::MAX_SLOTS];
+    unsigned int numMismatches = 0;
+    double decodeSeconds = 0.0;
+    for (unsigned int snapshot = 0; snapshot < config.m_numSnapshots; ++snapshot)
+    {
+        const SnapshotFrame& baseline = snapshot >= config.m_baselineLag ? frames[snapshot - config.m_baselineLag] : SnapshotFrame::EMPTY;
+        auto decodeStart = std::chrono::steady_clock::now();
+        bool isDecoded = codec.Decode(baseline, &coded[snapshot * maxBytesPerSnapshot], codedSizes[snapshot], config.m_numLinks, decoded);
+        decodeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - decodeStart).count();
+        for (unsigned int i = 0; i < config.m_numLinks; ++i)
+        {
+            isDecoded = isDecoded && IsSameLink(decoded[i], snapshotLinks[snapshot * config.m_numLinks + i]);
+        }
+        numMismatches += isDecoded ? 0 : 1;
+        if (recording)
+        {
+            SnapshotCodec::WriteRecording(recording, baseline, &snapshotLinks[snapshot * config.m_numLinks], config.m_numLinks);
+        }
+    }
+    if (recording)
+    {
+        fclose(recording);
+    }
+
+    unsigned long long totalCodedBytes = 0;
+    for (unsigned int size : codedSizes)
+    {
+        totalCodedBytes += size;
+    }
+    double plainBytes = 1.0 + config.m_numLinks * (sizeof(uint16_t) + 2 * sizeof(float) + sizeof(int) + sizeof(float));
+    double quantizedBytes = 1.0 + config.m_numLinks * sizeof(LinkRecord);
+    double codedBytes = (double)totalCodedBytes / config.m_numSnapshots;
+    printf("%u links, %u snapshots, baseline %u behind\n", config.m_numLinks, config.m_numSnapshots, config.m_baselineLag);
+    printf("plain      %7.1f bytes/snapshot\n", plainBytes);
+    printf("quantized  %7.1f bytes/snapshot\n", quantizedBytes);
+    printf("coded      %7.1f bytes/snapshot  (%.1f%% of plain)\n", codedBytes, 100.0 * codedBytes / plainBytes);
+    printf("encode     %7.3f us/snapshot\n", 1000000.0 * encodeSeconds / config.m_numSnapshots);
+    printf("decode     %7.3f us/snapshot\n", 1000000.0 * decodeSeconds / config.m_numSnapshots);
+    if (numMismatches > 0)
+    {
+        printf("%u snapshots didn't survive the round trip!\n", numMismatches);
+        return 1;
+    }
+    return 0;
+}
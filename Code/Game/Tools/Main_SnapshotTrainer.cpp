@@ -0,0 +1,83 @@
+//-----------------------------------------------------------------------------------
+//Trains the snapshot coder's static model: counts every symbol in the given recordings and writes them out as
+//SnapshotModelData.cpp, to be committed and shipped. Record real matches on a host with "snaprecord <file>".
+//Engine-free. From Run_Win32:
+//
+//  g++ -std=c++14 -O2 -I../Code ../Code/Game/Tools/Main_SnapshotTrainer.cpp ../Code/Game/Net/SnapshotCodec.cpp
+//      ../Code/Game/Net/RangeCoder.cpp ../Code/Game/Net/SnapshotModelData.cpp -o SnapshotTrainer
+//  ./SnapshotTrainer ../Code/Game/Net/SnapshotModelData.cpp match1.snap match2.snap ...
+#include "Game/Net/SnapshotCodec.hpp"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+//-----------------------------------------------------------------------------------
+//What the model would cost per symbol on the data it was trained on, as a sanity check on the recordings.
+static double CalculateBitsPerSymbol(const uint32_t* counts, unsigned int numSymbols)
+{
+    double total = 0.0;
+    for (unsigned int i = 0; i < numSymbols; ++i)
+    {
+        total += counts[i];
+    }
+    double bits = 0.0;
+    for (unsigned int i = 0; total > 0.0 && i < numSymbols; ++i)
+    {
+        bits -= counts[i] > 0 ? (counts[i] / total) * log2(counts[i] / total) : 0.0;
+    }
+    return bits;
+}
+
+//-----------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("SnapshotTrainer <output.cpp> <recording>...\n");
+        return 1;
+    }
+
+    SnapshotModelCounts counts;
+    memset(&counts, 0, sizeof(counts));
+    unsigned int numEntries = 0;
+    for (int i = 2; i < argc; ++i)
+    {
+        FILE* recording = fopen(argv[i], "rb");
+        if (!recording)
+        {
+            printf("Couldn't open %s\n", argv[i]);
+            return 1;
+        }
+        SnapshotFrame baseline;
+        SnapshotLink links[SnapshotFrame::MAX_SLOTS];
+        unsigned int numLinks = 0;
+        while (SnapshotCodec::ReadRecording(recording, baseline, links, numLinks))
+        {
+            SnapshotCodec::CountSymbols(baseline, links, numLinks, counts);
+            ++numEntries;
+        }
+        fclose(recording);
+    }
+    if (numEntries == 0)
+    {
+        printf("No snapshots in the recordings, leaving the model alone.\n");
+        return 1;
+    }
+
+    FILE* output = fopen(argv[1], "w");
+    if (!output)
+    {
+        printf("Couldn't write %s\n", argv[1]);
+        return 1;
+    }
+    SnapshotCodec::WriteModelSource(output, counts);
+    fclose(output);
+
+    printf("Trained on %u snapshots\n", numEntries);
+    printf("slot gaps       %.2f bits\n", CalculateBitsPerSymbol(counts.m_slotGaps, SnapshotFrame::MAX_SLOTS));
+    printf("ids             %.2f bits\n", CalculateBitsPerSymbol(counts.m_ids, SnapshotModelCounts::NUM_ID_SYMBOLS));
+    printf("position deltas %.2f bits\n", CalculateBitsPerSymbol(counts.m_positionDeltas, SnapshotModelCounts::NUM_DELTA_SYMBOLS));
+    printf("facings         %.2f bits\n", CalculateBitsPerSymbol(counts.m_facings, SnapshotModelCounts::NUM_FACING_SYMBOLS));
+    printf("hp deltas       %.2f bits\n", CalculateBitsPerSymbol(counts.m_hpDeltas, SnapshotModelCounts::NUM_DELTA_SYMBOLS));
+    return 0;
+}
@@ -0,0 +1,149 @@
+//-----------------------------------------------------------------------------------
+//Headless sprite render benchmark on the software backend, for machines that can't open a window. From Run_Win32:
+//
+//  g++ -std=c++14 -O2 -I../Code ../Code/Game/Tools/Main_SpriteBench.cpp ../Code/Game/Rendering/Image.cpp
+//      ../Code/Game/Rendering/SoftwareSpriteBackend.cpp ../Code/Game/Rendering/SpriteLayerRenderer.cpp
+//      ../Code/Game/Rendering/RecordingSpriteBackend.cpp ../Code/Game/Rendering/DecalLayer.cpp ../Code/Game/Rendering/SpriteCullGrid.cpp
+//      ../Code/Game/Rendering/SpriteBenchmark.cpp -o SpriteBench
+//  ./SpriteBench -sprites 2000 -layers 4 -frames 120 -effect -out frame.tga Data/Images/standingDown.png ...
+#include "Game/Rendering/SpriteBenchmark.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//-----------------------------------------------------------------------------------
+static void PrintUsage()
+{
+    printf("SpriteBench [-sprites n] [-layers n] [-frames n] [-size <width> <height>] [-world <screens>] [-effect] [-nobatch] [-nocull] [-compare] [-comparecull] [-decals] [-out file.tga] [image.png...]\n");
+}
+
+//-----------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    SpriteBenchmarkConfig config;
+    bool isComparingBatching = false;
+    bool isComparingCulling = false;
+    bool isComparingDecals = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-sprites") == 0 && hasValue)
+        {
+            config.m_numSprites = (unsigned int)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-layers") == 0 && hasValue)
+        {
+            config.m_numLayers = (unsigned int)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-frames") == 0 && hasValue)
+        {
+            config.m_numFrames = (unsigned int)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-size") == 0 && i + 2 < argc)
+        {
+            config.m_pixelWidth = atoi(argv[++i]);
+            config.m_pixelHeight = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-world") == 0 && hasValue)
+        {
+            config.m_worldScale = (float)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-effect") == 0)
+        {
+            config.m_useLayerEffect = true;
+        }
+        else if (strcmp(argv[i], "-nobatch") == 0)
+        {
+            config.m_isBatchingEnabled = false;
+        }
+        else if (strcmp(argv[i], "-nocull") == 0)
+        {
+            config.m_isCullingEnabled = false;
+        }
+        else if (strcmp(argv[i], "-comparecull") == 0)
+        {
+            isComparingCulling = true;
+        }
+        else if (strcmp(argv[i], "-compare") == 0)
+        {
+            isComparingBatching = true;
+        }
+        else if (strcmp(argv[i], "-decals") == 0)
+        {
+            isComparingDecals = true;
+        }
+        else if (strcmp(argv[i], "-out") == 0 && hasValue)
+        {
+            config.m_outputPath = argv[++i];
+        }
+        else if (argv[i][0] == '-')
+        {
+            PrintUsage();
+            return 1;
+        }
+        else
+        {
+            config.m_imagePaths.push_back(argv[i]);
+        }
+    }
+    if (config.m_numLayers == 0 || config.m_pixelWidth <= 0 || config.m_pixelHeight <= 0 || config.m_worldScale <= 0.0f)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    //-compare exits non-zero if batching changed the frame or didn't cut draws, so CI can gate on it.
+    if (isComparingBatching)
+    {
+        SpriteBenchmarkResult unbatched;
+        SpriteBenchmarkResult batched;
+        bool isMatching = SpriteBenchmark::CompareBatching(config, unbatched, batched);
+        printf("Unbatched: %u draws, %u texture binds, %u material changes\n", unbatched.m_lastFrameStats.m_numDrawCalls, unbatched.m_lastFrameStats.m_numTextureBinds,
+            unbatched.m_lastFrameStats.m_numMaterialChanges);
+        printf("Batched:   %u draws, %u texture binds, %u material changes\n", batched.m_lastFrameStats.m_numDrawCalls, batched.m_lastFrameStats.m_numTextureBinds,
+            batched.m_lastFrameStats.m_numMaterialChanges);
+        printf(isMatching ? "Batched frame matches\n" : "Batched frame doesn't match\n");
+        return isMatching ? 0 : 1;
+    }
+
+    //-comparecull exits non-zero if culling changed a single pixel.
+    if (isComparingCulling)
+    {
+        SpriteBenchmarkResult unculled;
+        SpriteBenchmarkResult culled;
+        bool isMatching = SpriteBenchmark::CompareCulling(config, unculled, culled);
+        printf("Unculled: %u quads, %.3f ms/frame\n", unculled.m_lastFrameStats.m_numQuads, unculled.m_secondsPerFrame * 1000.0);
+        printf("Culled:   %u quads, %.3f ms/frame, %u sprites culled\n", culled.m_lastFrameStats.m_numQuads, culled.m_secondsPerFrame * 1000.0, culled.m_numCulledSprites);
+        printf(isMatching ? "Culled frame matches\n" : "Culled frame doesn't match\n");
+        return isMatching ? 0 : 1;
+    }
+
+    //-decals treats -sprites as the number of static ground decals, and exits non-zero if baking changed the frame.
+    if (isComparingDecals)
+    {
+        SpriteBenchmarkResult live;
+        SpriteBenchmarkResult baked;
+        bool isMatching = SpriteBenchmark::CompareDecals(config, live, baked);
+        printf("As sprites: %u quads, %llu pixels shaded, %.3f ms/frame\n", live.m_lastFrameStats.m_numQuads, (unsigned long long)live.m_lastFrameStats.m_numPixelsShaded,
+            live.m_secondsPerFrame * 1000.0);
+        printf("Baked:      %u quads, %llu pixels shaded, %.3f ms/frame\n", baked.m_lastFrameStats.m_numQuads, (unsigned long long)baked.m_lastFrameStats.m_numPixelsShaded,
+            baked.m_secondsPerFrame * 1000.0);
+        printf(isMatching ? "Baked frame matches\n" : "Baked frame doesn't match\n");
+        return isMatching ? 0 : 1;
+    }
+
+    SpriteBenchmarkResult result;
+    SpriteBenchmark::Run(config, result);
+    const SpriteFrameStats& stats = result.m_lastFrameStats;
+    printf("%u sprites on %u layers, %ix%i: %.3f ms/frame, %.1f Mpixels/s\n", config.m_numSprites, config.m_numLayers, config.m_pixelWidth, config.m_pixelHeight,
+        result.m_secondsPerFrame * 1000.0, result.m_pixelsPerSecond / 1.0e6);
+    printf("Per frame: %u draws, %u binds, %u quads, %u culled, %u layers, %u effect passes, %llu pixels shaded, %llu composited\n", stats.m_numDrawCalls,
+        stats.m_numTextureBinds, stats.m_numQuads, result.m_numCulledSprites, stats.m_numLayers, stats.m_numEffectPasses, (unsigned long long)stats.m_numPixelsShaded,
+        (unsigned long long)stats.m_numPixelsComposited);
+    if (!config.m_outputPath.empty())
+    {
+        printf(result.m_hasWrittenFrame ? "Wrote %s\n" : "Couldn't write %s\n", config.m_outputPath.c_str());
+        return result.m_hasWrittenFrame ? 0 : 1;
+    }
+    return 0;
+}
@@ -0,0 +1,173 @@
+//-----------------------------------------------------------------------------------
+//Loopback packet-rate benchmark for BatchedUDPSocket, comparing one syscall per packet against recvmmsg/sendmmsg (and
+//UDP GSO where the kernel has it). Linux only. From Run_Win32:
+//
+//  g++ -std=c++14 -O2 -I../Code ../Code/Game/Tools/Main_UDPBench.cpp ../Code/Game/Net/BatchedUDPSocket.cpp
+//      ../Code/Game/Net/PacketRing.cpp -o UDPBench
+//  ./UDPBench -clients 8 -packets 16 -size 200 -ticks 2000
+//
+//Each tick the host sends every client a burst of snapshot-sized packets and flushes once, each client drains and echoes
+//them, and the host drains the echoes: the traffic shape of a host tick with many clients.
+#include "Game/Net/BatchedUDPSocket.hpp"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <memory>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+struct UDPBenchConfig
+{
+    unsigned int m_numClients = 8;
+    unsigned int m_packetsPerClient = 16;
+    unsigned int m_packetSize = 200;
+    unsigned int m_numTicks = 2000;
+};
+
+//-----------------------------------------------------------------------------------
+struct UDPBenchResult
+{
+    unsigned int m_numDelivered = 0;
+    unsigned int m_numSyscalls = 0;
+    double m_seconds = 0.0;
+    bool m_isSegmenting = false;
+};
+
+//-----------------------------------------------------------------------------------
+static void PrintUsage()
+{
+    printf("UDPBench [-clients n] [-packets <perClientPerTick>] [-size <bytes>] [-ticks n]\n");
+}
+
+//-----------------------------------------------------------------------------------
+//Drains a socket, echoing everything back to where it came from if an echo is wanted. Returns packets read.
+static unsigned int DrainSocket(BatchedUDPSocket& socket, bool isEchoing)
+{
+    unsigned int numRead = socket.Receive();
+    PacketRing& received = socket.GetReceived();
+    for (unsigned int i = 0; i < received.GetCount(); ++i)
+    {
+        Packet& packet = received.GetPacket(i);
+        if (isEchoing)
+        {
+            socket.QueueSend(packet.m_address, packet.m_data, packet.m_size);
+        }
+    }
+    received.Pop(received.GetCount());
+    if (isEchoing)
+    {
+        socket.Flush();
+    }
+    return numRead;
+}
+
+//-----------------------------------------------------------------------------------
+static bool RunBench(BatchedUDPSocket::Mode mode, const UDPBenchConfig& config, UDPBenchResult& outResult)
+{
+    BatchedUDPSocket host(mode, 4096);
+    if (!host.Open("127.0.0.1", "0"))
+    {
+        return false;
+    }
+    std::vector<std::unique_ptr<BatchedUDPSocket>> clients;
+    for (unsigned int i = 0; i < config.m_numClients; ++i)
+    {
+        clients.emplace_back(new BatchedUDPSocket(mode, 4096));
+        if (!clients.back()->Open("127.0.0.1", "0"))
+        {
+            return false;
+        }
+    }
+
+    std::vector<uint8_t> payload(config.m_packetSize, 0xAB);
+    unsigned int numClientSyscalls = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int tick = 0; tick < config.m_numTicks; ++tick)
+    {
+        for (auto& client : clients)
+        {
+            for (unsigned int i = 0; i < config.m_packetsPerClient; ++i)
+            {
+                host.QueueSend(client->GetLocalAddress(), payload.data(), (uint16_t)payload.size());
+            }
+        }
+        host.Flush();
+        for (auto& client : clients)
+        {
+            outResult.m_numDelivered += DrainSocket(*client, true);
+        }
+        outResult.m_numDelivered += DrainSocket(host, false);
+    }
+    outResult.m_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (auto& client : clients)
+    {
+        numClientSyscalls += client->GetNumSyscalls();
+    }
+    outResult.m_numSyscalls = host.GetNumSyscalls() + numClientSyscalls;
+    outResult.m_isSegmenting = host.IsSegmenting();
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+static void PrintResult(const char* name, const UDPBenchConfig& config, const UDPBenchResult& result)
+{
+    double packetsPerSecond = result.m_seconds > 0.0 ? result.m_numDelivered / result.m_seconds : 0.0;
+    double syscallsPerTick = (double)result.m_numSyscalls / config.m_numTicks;
+    printf("%-10s %10u packets in %.3fs  %12.0f packets/s  %8.1f syscalls/tick%s\n", name, result.m_numDelivered, result.m_seconds,
+        packetsPerSecond, syscallsPerTick, result.m_isSegmenting ? "  (GSO)" : "");
+}
+
+//-----------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    UDPBenchConfig config;
+    for (int i = 1; i < argc; ++i)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-clients") == 0 && hasValue)
+        {
+            config.m_numClients = (unsigned int)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-packets") == 0 && hasValue)
+        {
+            config.m_packetsPerClient = (unsigned int)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-size") == 0 && hasValue)
+        {
+            config.m_packetSize = (unsigned int)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-ticks") == 0 && hasValue)
+        {
+            config.m_numTicks = (unsigned int)atoi(argv[++i]);
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (config.m_numTicks == 0 || config.m_packetSize == 0 || config.m_packetSize > Packet::MAX_SIZE)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    UDPBenchResult perPacket;
+    UDPBenchResult batched;
+    if (!RunBench(BatchedUDPSocket::PER_PACKET_MODE, config, perPacket) || !RunBench(BatchedUDPSocket::BATCHED_MODE, config, batched))
+    {
+        printf("Couldn't open loopback sockets.\n");
+        return 1;
+    }
+    printf("%u clients x %u packets x %u bytes, %u ticks\n", config.m_numClients, config.m_packetsPerClient, config.m_packetSize, config.m_numTicks);
+    PrintResult("per-packet", config, perPacket);
+    PrintResult("batched", config, batched);
+    if (perPacket.m_seconds > 0.0 && batched.m_seconds > 0.0)
+    {
+        double speedup = (batched.m_numDelivered / batched.m_seconds) / (perPacket.m_numDelivered / perPacket.m_seconds);
+        printf("batched is %.2fx the per-packet rate\n", speedup);
+    }
+    return 0;
+}